@@ -7,6 +7,7 @@
 #include "SIMDHelpers.h"
 #include "OnePoleFilter.h"
 #include "SfzFilter.h"
+#include "FilterBank.h"
 #include "SfzHelpers.h"
 #include "ScopedFTZ.h"
 #include "SfzHelpers.h"
@@ -141,9 +142,44 @@ BENCHMARK_DEFINE_F(FilterFixture, TwoPoleShelf_Faust)(benchmark::State& state) {
     }
 }
 
+// The argument is the number of mono filters which run together in the bank
+static void twoPoleBank(benchmark::State& state, FilterFixture& fixture, bool tabulated)
+{
+    ScopedFTZ ftz;
+    sfz::FilterBank bank;
+    bank.setSampleRate(sampleRate);
+    bank.setSamplesPerBlock(blockSize);
+    bank.setTabulated(tabulated);
+    const auto numFilters = static_cast<size_t>(state.range(0));
+    std::vector<sfz::FilterBankState> filterStates(numFilters);
+    std::vector<std::vector<float>> outputs(numFilters, fixture.input);
+    bool reset = true;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numFilters; ++i) {
+            std::copy(fixture.input.begin(), fixture.input.end(), outputs[i].begin());
+            float* channels[1] { outputs[i].data() };
+            bank.add(filterStates[i], sfz::FilterType::kFilterLpf2p, channels, 1,
+                fixture.cutoff.data(), fixture.q.data(), blockSize, reset);
+        }
+        bank.process();
+        reset = false;
+    }
+}
+
+BENCHMARK_DEFINE_F(FilterFixture, TwoPole_Bank)(benchmark::State& state) {
+    twoPoleBank(state, *this, false);
+}
+
+BENCHMARK_DEFINE_F(FilterFixture, TwoPole_BankTabulated)(benchmark::State& state) {
+    twoPoleBank(state, *this, true);
+}
+
 BENCHMARK_REGISTER_F(FilterFixture, OnePole_VA)->RangeMultiplier(2)->Range(1, 1 << 8);
 BENCHMARK_REGISTER_F(FilterFixture, OnePole_Faust)->RangeMultiplier(2)->Range(1, 1 << 8);
 BENCHMARK_REGISTER_F(FilterFixture, TwoPole_Faust)->RangeMultiplier(2)->Range(1, 1 << 8);
 BENCHMARK_REGISTER_F(FilterFixture, TwoPoleShelf_Faust)->RangeMultiplier(2)->Range(1, 1 << 8);
+BENCHMARK_REGISTER_F(FilterFixture, TwoPole_Bank)->Arg(1)->Arg(sfz::FilterBank::maxLanes);
+BENCHMARK_REGISTER_F(FilterFixture, TwoPole_BankTabulated)->Arg(1)->Arg(sfz::FilterBank::maxLanes);
 BENCHMARK_MAIN();
 
@@ -6,9 +6,13 @@
 
 #include "Config.h"
 #include "Interpolators.h"
+#include "SincResampler.h"
+#include "SIMDHelpers.h"
 #include "ScopedFTZ.h"
 #include "absl/types/span.h"
 #include <benchmark/benchmark.h>
+#include <simde/x86/sse.h>
+#include <algorithm>
 #include <random>
 
 class Interpolators : public benchmark::Fixture {
@@ -84,3 +88,159 @@ ADD_INTERPOLATOR_BENCHMARK(Sinc36)
 ADD_INTERPOLATOR_BENCHMARK(Sinc48)
 ADD_INTERPOLATOR_BENCHMARK(Sinc60)
 ADD_INTERPOLATOR_BENCHMARK(Sinc72)
+
+//------------------------------------------------------------------------------
+// Stereo sources: the planar layout of the file buffers, against an
+// interleaved (LRLR) layout. Each voice streams through its own source, so
+// that the data does not stay in cache with many voices.
+
+class StereoInterpolators : public benchmark::Fixture {
+public:
+    StereoInterpolators()
+    {
+        sfz::initializeInterpolators();
+    }
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        std::random_device rd { };
+        std::mt19937 gen { rd() };
+        std::uniform_real_distribution<float> dist { -1.0f, 1.0f };
+
+        const size_t numVoices = state.range(0);
+        const size_t paddedFrames = sourceFrames + 2 * sfz::config::excessFileFrames;
+        left.resize(numVoices);
+        right.resize(numVoices);
+        interleaved.resize(numVoices);
+        for (size_t v = 0; v < numVoices; ++v) {
+            left[v].resize(paddedFrames);
+            right[v].resize(paddedFrames);
+            interleaved[v].resize(2 * paddedFrames);
+            std::generate(left[v].begin(), left[v].end(), [&]() { return dist(gen); });
+            std::generate(right[v].begin(), right[v].end(), [&]() { return dist(gen); });
+            sfz::writeInterleaved(left[v], right[v], absl::MakeSpan(interleaved[v]));
+        }
+
+        indices.resize(blockFrames);
+        coeffs.resize(blockFrames);
+        outputLeft.resize(blockFrames);
+        outputRight.resize(blockFrames);
+        position = 0.0;
+    }
+
+    void TearDown(const ::benchmark::State& /* state */)
+    {
+    }
+
+    // the positions of the next block, relative to the start of the sources
+    void nextBlock()
+    {
+        constexpr double ratio = 1.234;
+        if (position + ratio * blockFrames >= sourceFrames)
+            position = 0.0;
+        for (size_t i = 0; i < blockFrames; ++i) {
+            double pos = position + ratio * i;
+            indices[i] = sfz::config::excessFileFrames + static_cast<int>(pos);
+            coeffs[i] = static_cast<float>(pos - static_cast<int>(pos));
+        }
+        position += ratio * blockFrames;
+    }
+
+    static constexpr size_t sourceFrames = 1 << 18;
+    static constexpr size_t blockFrames = 1024;
+
+    std::vector<std::vector<float>> left;
+    std::vector<std::vector<float>> right;
+    std::vector<std::vector<float>> interleaved;
+    std::vector<int> indices;
+    std::vector<float> coeffs;
+    std::vector<float> outputLeft;
+    std::vector<float> outputRight;
+    double position = 0.0;
+};
+
+constexpr size_t StereoInterpolators::sourceFrames;
+constexpr size_t StereoInterpolators::blockFrames;
+
+template <sfz::InterpolatorModel M>
+static void doPerChannelInterpolation(
+    const float* left, const float* right, const std::vector<int>& indices,
+    const std::vector<float>& coeffs, std::vector<float>& outputLeft, std::vector<float>& outputRight)
+{
+    for (size_t i = 0; i < indices.size(); ++i) {
+        outputLeft[i] = sfz::interpolate<M>(&left[indices[i]], coeffs[i]);
+        outputRight[i] = sfz::interpolate<M>(&right[indices[i]], coeffs[i]);
+    }
+}
+
+// The taps of the polyphase bank are duplicated to match the frames
+static void doInterleavedSincResampling(
+    const sfz::SincBank& bank, const float* frames, const std::vector<int>& indices,
+    const std::vector<float>& coeffs, std::vector<float>& outputLeft, std::vector<float>& outputRight)
+{
+    const unsigned points = bank.points;
+    const int j0 = 1 - int(points) / 2;
+
+    for (size_t n = 0; n < indices.size(); ++n) {
+        const float pos = coeffs[n] * bank.numPhases;
+        const int p = std::min(static_cast<int>(pos), int(bank.numPhases) - 1);
+        const simde__m128 mu = simde_mm_set1_ps(pos - p);
+        const float* h = bank.coeffs + p * points;
+        const float* x = frames + 2 * (indices[n] + j0);
+
+        simde__m128 y = simde_mm_setzero_ps();
+        for (unsigned i = 0; i < points; i += 4) {
+            simde__m128 a = simde_mm_loadu_ps(h + i);
+            simde__m128 c = simde_mm_add_ps(a, simde_mm_mul_ps(mu, simde_mm_sub_ps(simde_mm_loadu_ps(h + points + i), a)));
+            y = simde_mm_add_ps(y, simde_mm_mul_ps(simde_mm_unpacklo_ps(c, c), simde_mm_loadu_ps(x + 2 * i)));
+            y = simde_mm_add_ps(y, simde_mm_mul_ps(simde_mm_unpackhi_ps(c, c), simde_mm_loadu_ps(x + 2 * i + 4)));
+        }
+
+        // y = { l, r, l, r }
+        y = simde_mm_add_ps(y, simde_mm_movehl_ps(y, y));
+        outputLeft[n] = simde_mm_cvtss_f32(y);
+        outputRight[n] = simde_mm_cvtss_f32(simde_mm_shuffle_ps(y, y, SIMDE_MM_SHUFFLE(1, 1, 1, 1)));
+    }
+}
+
+#define ADD_STEREO_SINC_BENCHMARK(Type, Points)                                     \
+    BENCHMARK_DEFINE_F(StereoInterpolators, Type##_PerChannel)(benchmark::State& state) \
+    {                                                                               \
+        ScopedFTZ ftz;                                                              \
+        for (auto _ : state) {                                                      \
+            nextBlock();                                                            \
+            for (size_t v = 0; v < left.size(); ++v)                                \
+                doPerChannelInterpolation<sfz::kInterpolator##Type>(                \
+                    left[v].data(), right[v].data(), indices, coeffs, outputLeft, outputRight); \
+        }                                                                           \
+    }                                                                               \
+    BENCHMARK_DEFINE_F(StereoInterpolators, Type##_Planar)(benchmark::State& state) \
+    {                                                                               \
+        ScopedFTZ ftz;                                                              \
+        for (auto _ : state) {                                                      \
+            nextBlock();                                                            \
+            for (size_t v = 0; v < left.size(); ++v)                                \
+                sfz::sincResample(                                                  \
+                    Points, left[v].data(), right[v].data(), indices.data(),        \
+                    coeffs.data(), nullptr, outputLeft.data(), outputRight.data(),  \
+                    blockFrames);                                                   \
+        }                                                                           \
+    }                                                                               \
+    BENCHMARK_DEFINE_F(StereoInterpolators, Type##_Interleaved)(benchmark::State& state) \
+    {                                                                               \
+        ScopedFTZ ftz;                                                              \
+        const sfz::SincBank& bank = sfz::getSincBank(Points);                       \
+        for (auto _ : state) {                                                      \
+            nextBlock();                                                            \
+            for (size_t v = 0; v < left.size(); ++v)                                \
+                doInterleavedSincResampling(                                        \
+                    bank, interleaved[v].data(), indices, coeffs, outputLeft, outputRight); \
+        }                                                                           \
+    }                                                                               \
+    BENCHMARK_REGISTER_F(StereoInterpolators, Type##_PerChannel)->RangeMultiplier(4)->Range(1, 64); \
+    BENCHMARK_REGISTER_F(StereoInterpolators, Type##_Planar)->RangeMultiplier(4)->Range(1, 64); \
+    BENCHMARK_REGISTER_F(StereoInterpolators, Type##_Interleaved)->RangeMultiplier(4)->Range(1, 64);
+
+ADD_STEREO_SINC_BENCHMARK(Sinc8, 8)
+ADD_STEREO_SINC_BENCHMARK(Sinc24, 24)
+ADD_STEREO_SINC_BENCHMARK(Sinc72, 72)
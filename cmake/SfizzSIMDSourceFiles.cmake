@@ -5,7 +5,8 @@ macro(sfizz_add_simd_sources SOURCES_VAR PREFIX)
         ${PREFIX}/sfizz/SIMDHelpers.cpp
         ${PREFIX}/sfizz/simd/HelpersNEON.cpp
         ${PREFIX}/sfizz/simd/HelpersSSE.cpp
-        ${PREFIX}/sfizz/simd/HelpersAVX.cpp)
+        ${PREFIX}/sfizz/simd/HelpersAVX.cpp
+        ${PREFIX}/sfizz/simd/SincResamplerAVX2.cpp)
 
     # For CPU-dispatched X86 sources
     # Always build them for all X86 targets.
@@ -18,6 +19,9 @@ macro(sfizz_add_simd_sources SOURCES_VAR PREFIX)
                 ${PREFIX}/sfizz/effects/impl/ResonantArrayAVX.cpp
                 ${PREFIX}/sfizz/simd/HelpersAVX.cpp
                 PROPERTIES COMPILE_FLAGS "-mavx")
+            set_source_files_properties(
+                ${PREFIX}/sfizz/simd/SincResamplerAVX2.cpp
+                PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
         endif()
     endif()
 endmacro()
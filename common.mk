@@ -86,6 +86,7 @@ SFIZZ_SOURCES = \
 	src/sfizz/FileId.cpp \
 	src/sfizz/FileMetadata.cpp \
 	src/sfizz/FilePool.cpp \
+	src/sfizz/FilterBank.cpp \
 	src/sfizz/FilterPool.cpp \
 	src/sfizz/FlexEGDescription.cpp \
 	src/sfizz/FlexEnvelope.cpp \
@@ -94,6 +95,7 @@ SFIZZ_SOURCES = \
 	src/sfizz/Logger.cpp \
 	src/sfizz/LFO.cpp \
 	src/sfizz/LFODescription.cpp \
+	src/sfizz/MappedFile.cpp \
 	src/sfizz/Messaging.cpp \
 	src/sfizz/Metronome.cpp \
 	src/sfizz/MidiState.cpp \
@@ -105,9 +107,11 @@ SFIZZ_SOURCES = \
 	src/sfizz/parser/ParserPrivate.cpp \
 	src/sfizz/PolyphonyGroup.cpp \
 	src/sfizz/PowerFollower.cpp \
+	src/sfizz/PreloadCache.cpp \
 	src/sfizz/Region.cpp \
 	src/sfizz/RegionSet.cpp \
 	src/sfizz/RegionStateful.cpp \
+	src/sfizz/RenderPool.cpp \
 	src/sfizz/Resources.cpp \
 	src/sfizz/RTSemaphore.cpp \
 	src/sfizz/ScopedFTZ.cpp \
@@ -117,6 +121,8 @@ SFIZZ_SOURCES = \
 	src/sfizz/SIMDHelpers.cpp \
 	src/sfizz/simd/HelpersSSE.cpp \
 	src/sfizz/simd/HelpersAVX.cpp \
+	src/sfizz/simd/SincResamplerAVX2.cpp \
+	src/sfizz/SincResampler.cpp \
 	src/sfizz/Smoothers.cpp \
 	src/sfizz/Synth.cpp \
 	src/sfizz/SynthMessaging.cpp \
@@ -73,6 +73,11 @@ $(SFIZZ_BUILD_DIR)/%AVX.cpp.o: $(SFIZZ_DIR)/%AVX.cpp
 	@echo "Compiling $<"
 	$(SILENT)$(CXX) $(BUILD_CXX_FLAGS) $(SFIZZ_CXX_FLAGS) -mavx -c -o $@ $<
 
+$(SFIZZ_BUILD_DIR)/%AVX2.cpp.o: $(SFIZZ_DIR)/%AVX2.cpp
+	-@mkdir -p $(dir $@)
+	@echo "Compiling $<"
+	$(SILENT)$(CXX) $(BUILD_CXX_FLAGS) $(SFIZZ_CXX_FLAGS) -mavx2 -mfma -c -o $@ $<
+
 endif
 
 ###
@@ -56,6 +56,10 @@ $(SFIZZ_BUILD_DIR)/%AVX.cpp.o: $(SFIZZ_DIR)/%AVX.cpp
 	-@mkdir -p $(dir $@)
 	$(CXX) $(BUILD_CXX_FLAGS) $(SFIZZ_CXX_FLAGS) -mavx -c -o $@ $<
 
+$(SFIZZ_BUILD_DIR)/%AVX2.cpp.o: $(SFIZZ_DIR)/%AVX2.cpp
+	-@mkdir -p $(dir $@)
+	$(CXX) $(BUILD_CXX_FLAGS) $(SFIZZ_CXX_FLAGS) -mavx2 -mfma -c -o $@ $<
+
 endif
 
 ###
@@ -70,6 +70,10 @@ $(SFIZZ_BUILD_DIR)/%AVX.cpp.o: $(SFIZZ_DIR)/%AVX.cpp
 	-@mkdir -p $(dir $@)
 	$(CXX) $(CXXFLAGS) $(CXXFLAGS) -mavx -c -o $@ $<
 
+$(SFIZZ_BUILD_DIR)/%AVX2.cpp.o: $(SFIZZ_DIR)/%AVX2.cpp
+	-@mkdir -p $(dir $@)
+	$(CXX) $(CXXFLAGS) $(CXXFLAGS) -mavx2 -mfma -c -o $@ $<
+
 endif
 
 ###
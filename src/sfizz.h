@@ -81,6 +81,35 @@ typedef enum {
     SFIZZ_PROCESS_FREEWHEELING,
 } sfizz_process_mode_t;
 
+/**
+ * @brief Type of an event sent in a batch with sfizz_send_events()
+ * @since 1.2.0
+ */
+typedef enum {
+    SFIZZ_EVENT_NOTE_ON,
+    SFIZZ_EVENT_NOTE_OFF,
+    SFIZZ_EVENT_CC,
+    SFIZZ_EVENT_PITCH_WHEEL,
+    SFIZZ_EVENT_CHANNEL_AFTERTOUCH,
+    SFIZZ_EVENT_POLY_AFTERTOUCH,
+} sfizz_event_type_t;
+
+/**
+ * @brief A high-precision event sent in a batch with sfizz_send_events()
+ * @since 1.2.0
+ */
+typedef struct {
+    /** The delay of the event in the block, in samples. */
+    int delay;
+    /** The type of the event, a sfizz_event_type_t. */
+    int type;
+    /** The note or CC number, unused by the pitch wheel and channel aftertouch. */
+    int number;
+    /** The normalized velocity, CC value or aftertouch in domain 0 to 1,
+        or the normalized pitch in domain -1 to 1. */
+    float value;
+} sfizz_event_t;
+
 /**
  * @brief Creates a sfizz synth.
  *
@@ -594,6 +623,29 @@ SFIZZ_EXPORTED_API void sfizz_send_poly_aftertouch(sfizz_synth_t* synth, int del
  */
 SFIZZ_EXPORTED_API void sfizz_send_hd_poly_aftertouch(sfizz_synth_t* synth, int delay, int note_number, float aftertouch);
 
+/**
+ * @brief Send a batch of high-precision midi-type events to the synth.
+ * @since 1.2.0
+ *
+ * The events are dispatched in a single pass, which saves the cost of
+ * one call per event. A CC, pitch wheel or aftertouch event followed at the
+ * same delay by another of the same type and number, with no note event in
+ * between, is superseded by it and skipped, unless regions trigger on
+ * its controller or the controller is a sustain or sostenuto pedal.
+ *
+ * The events should be delay-ordered, and delay-ordered with all other
+ * midi-type events, otherwise the behavior of the synth is undefined.
+ *
+ * @param synth       The synth.
+ * @param events      The events; their delays should be lower than the size
+ *                    of the block in the next call to sfizz_render_block().
+ * @param num_events  The number of events.
+ *
+ * @par Thread-safety constraints
+ * - @b RT: the function must be invoked from the Real-time thread
+ */
+SFIZZ_EXPORTED_API void sfizz_send_events(sfizz_synth_t* synth, const sfizz_event_t* events, int num_events);
+
 /**
  * @brief Send a tempo event.
  *
@@ -737,6 +789,182 @@ SFIZZ_EXPORTED_API unsigned int sfizz_get_preload_size(sfizz_synth_t* synth);
  */
 SFIZZ_EXPORTED_API void sfizz_set_preload_size(sfizz_synth_t* synth, unsigned int preload_size);
 
+/**
+ * @brief Enable or disable disk streaming.
+ *
+ * When enabled, the samples which are not looped are read from the disk
+ * through a fixed-size window for each voice, instead of being loaded
+ * entirely in memory. The memory used for playback is then bounded by the
+ * polyphony. This stops all the playing voices.
+ * @since 1.2.0
+ *
+ * @param      synth           The synth.
+ * @param[in]  disk_streaming  Whether disk streaming is enabled.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_disk_streaming(sfizz_synth_t* synth, bool disk_streaming);
+
+/**
+ * @brief Return whether disk streaming is enabled.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API bool sfizz_get_disk_streaming(sfizz_synth_t* synth);
+
+/**
+ * @brief Enable or disable the compact storage of samples.
+ *
+ * When enabled, the 16-bit sample files are kept in memory in their native
+ * format instead of being converted to float, which halves their memory
+ * footprint. The conversion happens during interpolation. Files in other
+ * formats are not affected. This stops all the playing voices.
+ * @since 1.2.0
+ *
+ * @param      synth            The synth.
+ * @param[in]  compact_storage  Whether compact storage is enabled.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_compact_sample_storage(sfizz_synth_t* synth, bool compact_storage);
+
+/**
+ * @brief Return whether the compact storage of samples is enabled.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API bool sfizz_get_compact_sample_storage(sfizz_synth_t* synth);
+
+/**
+ * @brief Set the directory of the persistent preload cache.
+ *
+ * The file information and the decoded preloaded data of the samples are
+ * stored in this directory, and reused by the next loads, possibly in other
+ * processes, as long as the sample files keep their size and modification
+ * time. The directory is created if needed. An empty path disables the cache,
+ * which is the default. The setting applies from the next file load.
+ * @since 1.2.0
+ *
+ * @param synth      The synth.
+ * @param directory  A null-terminated string representing a path to a directory.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_preload_cache_directory(sfizz_synth_t* synth, const char* directory);
+
+/**
+ * @brief Enable or disable the sharing of sample data between synths.
+ *
+ * When enabled, the preloaded data of the sample files is shared with the
+ * other synths of the process which enable it, so that instruments using the
+ * same sample files keep a single copy of it in memory. Data is shared as long
+ * as the files are unchanged on disk. This is disabled by default. The setting
+ * applies from the next file load.
+ * @since 1.2.0
+ *
+ * @param synth           The synth.
+ * @param sample_sharing  Whether the sample data is shared.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_sample_sharing(sfizz_synth_t* synth, bool sample_sharing);
+
+/**
+ * @brief Return whether the sharing of sample data between synths is enabled.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API bool sfizz_get_sample_sharing(sfizz_synth_t* synth);
+
+/**
+ * @brief Enable or disable the control-rate evaluation of modulations.
+ *
+ * When enabled, the modulation sources which only drive filter and equalizer
+ * parameters are evaluated once every control interval, and hold their values
+ * in between. This is disabled by default.
+ * @since 1.2.0
+ *
+ * @param synth         The synth.
+ * @param control_rate  Whether the modulations are evaluated at control rate.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_control_rate_modulation(sfizz_synth_t* synth, bool control_rate);
+
+/**
+ * @brief Return whether the control-rate evaluation of modulations is enabled.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API bool sfizz_get_control_rate_modulation(sfizz_synth_t* synth);
+
+/**
+ * @brief Set the memory budget of the sample data.
+ *
+ * When the sample data uses more memory than the budget, the files which were
+ * entirely loaded in the background are released, the least recently used
+ * first, as soon as no voice plays them. The preloaded data counts against the
+ * budget but is never released, so the memory usage can stay over the budget.
+ * A budget of 0, which is the default, disables this.
+ * @since 1.2.0
+ *
+ * @param synth      The synth.
+ * @param num_bytes  The budget in bytes, or 0.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ */
+SFIZZ_EXPORTED_API void sfizz_set_sample_memory_budget(sfizz_synth_t* synth, size_t num_bytes);
+
+/**
+ * @brief Return the memory budget of the sample data, in bytes.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_sample_memory_budget(sfizz_synth_t* synth);
+
+/**
+ * @brief Return the memory used by the sample data, in bytes.
+ *
+ * This counts the preloaded data and the files loaded in the background.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_sample_memory_usage(sfizz_synth_t* synth);
+
+/**
+ * @brief Return the number of files released to fit in the memory budget.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_num_sample_evictions(sfizz_synth_t* synth);
+
+/**
+ * @brief Return the amount of sample data released to fit in the memory
+ * budget, in bytes.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_sample_evicted_bytes(sfizz_synth_t* synth);
+
 /**
  * @brief Get the internal oversampling rate.
  *
@@ -883,6 +1111,33 @@ SFIZZ_EXPORTED_API void sfizz_set_num_voices(sfizz_synth_t* synth, int num_voice
  */
 SFIZZ_EXPORTED_API int sfizz_get_num_voices(sfizz_synth_t* synth);
 
+/**
+ * @brief Set the number of threads which render the voices, including the
+ * thread which calls the render functions.
+ *
+ * With a single thread, which is the default, the voices are rendered serially.
+ * Otherwise, the active voices are distributed over a pool of worker threads,
+ * and the result is identical to serial rendering.
+ *
+ * @since 1.2.0
+ *
+ * @param synth        The synth.
+ * @param num_threads  The number of threads.
+ *
+ * @par Thread-safety constraints
+ * - @b CT: the function must be invoked from the Control thread
+ * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+ */
+SFIZZ_EXPORTED_API void sfizz_set_num_render_threads(sfizz_synth_t* synth, int num_threads);
+
+/**
+ * @brief Return the number of threads which render the voices.
+ * @since 1.2.0
+ *
+ * @param synth  The synth.
+ */
+SFIZZ_EXPORTED_API int sfizz_get_num_render_threads(sfizz_synth_t* synth);
+
 /**
  * @brief Return the number of allocated buffers from the synth.
  * @since 0.2.0
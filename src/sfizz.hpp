@@ -103,6 +103,30 @@ public:
         ProcessFreewheeling,
     };
 
+    /**
+     * @brief Type of an event sent in a batch with sendEvents().
+     * @since 1.2.0
+     */
+    enum EventType {
+        EventNoteOn,
+        EventNoteOff,
+        EventCC,
+        EventPitchWheel,
+        EventChannelAftertouch,
+        EventPolyAftertouch,
+    };
+
+    /**
+     * @brief A high-precision event sent in a batch with sendEvents().
+     * @since 1.2.0
+     */
+    struct Event {
+        int delay; // the delay of the event in the block, in samples
+        int type; // the EventType
+        int number; // the note or CC number, unused by the pitch wheel and channel aftertouch
+        float value; // the normalized velocity, CC value, pitch or aftertouch
+    };
+
     /**
      * @brief Empties the current regions and load a new SFZ file into the synth.
      *
@@ -647,6 +671,29 @@ public:
      */
     void hdPolyAftertouch(int delay, int noteNumber, float aftertouch) noexcept;
 
+    /**
+     * @brief Send a batch of high-precision midi-type events to the synth.
+     *
+     * The events are dispatched in a single pass, which saves the cost of
+     * one call per event. A CC, pitch wheel or aftertouch event followed at the
+     * same delay by another of the same type and number, with no note event in
+     * between, is superseded by it and skipped, unless regions trigger on
+     * its controller or the controller is a sustain or sostenuto pedal.
+     *
+     * The events should be delay-ordered, and delay-ordered with all other
+     * midi-type events, otherwise the behavior of the synth is undefined.
+     *
+     * @since 1.2.0
+     *
+     * @param events the events; their delays should be lower than the size
+     *               of the block in the next call to renderBlock().
+     * @param numEvents the number of events.
+     *
+     * @par Thread-safety constraints
+     * - @b RT: the function must be invoked from the Real-time thread
+     */
+    void sendEvents(const Event* events, size_t numEvents) noexcept;
+
     /**
      * @brief Send a tempo event to the synth.
      *
@@ -778,6 +825,30 @@ public:
      */
     void setNumVoices(int numVoices) noexcept;
 
+    /**
+     * @brief Return the number of threads which render the voices.
+     * @since 1.2.0
+     */
+    int getNumRenderThreads() const noexcept;
+
+    /**
+     * @brief Change the number of threads which render the voices, including
+     * the thread which calls the render functions.
+     *
+     * With a single thread, which is the default, the voices are rendered
+     * serially. Otherwise, the active voices are distributed over a pool of
+     * worker threads, and the result is identical to serial rendering.
+     *
+     * @since 1.2.0
+     *
+     * @param numThreads The number of threads.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setNumRenderThreads(int numThreads) noexcept;
+
     /**
      * @brief Set the oversampling factor to a new value.
      *
@@ -824,6 +895,168 @@ public:
      */
     uint32_t getPreloadSize() const noexcept;
 
+    /**
+     * @brief Enable or disable disk streaming.
+     *
+     * When enabled, the samples which are not looped are read from the disk
+     * through a fixed-size window for each voice, instead of being loaded
+     * entirely in memory. The memory used for playback is then bounded by
+     * the polyphony. This stops all the playing voices.
+     *
+     * @since 1.2.0
+     *
+     * @param diskStreaming Whether disk streaming is enabled.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setDiskStreaming(bool diskStreaming) noexcept;
+
+    /**
+     * @brief Return whether disk streaming is enabled.
+     * @since 1.2.0
+     */
+    bool getDiskStreaming() const noexcept;
+
+    /**
+     * @brief Enable or disable the compact storage of samples.
+     *
+     * When enabled, the 16-bit sample files are kept in memory in their
+     * native format instead of being converted to float, which halves their
+     * memory footprint. The conversion happens during interpolation. Files
+     * in other formats are not affected. This stops all the playing voices.
+     *
+     * @since 1.2.0
+     *
+     * @param compactStorage Whether compact storage is enabled.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setCompactSampleStorage(bool compactStorage) noexcept;
+
+    /**
+     * @brief Return whether the compact storage of samples is enabled.
+     * @since 1.2.0
+     */
+    bool getCompactSampleStorage() const noexcept;
+
+    /**
+     * @brief Set the directory of the persistent preload cache.
+     *
+     * The file information and the decoded preloaded data of the samples
+     * are stored in this directory, and reused by the next loads, possibly
+     * in other processes, as long as the sample files keep their size and
+     * modification time. The directory is created if needed. An empty path
+     * disables the cache, which is the default. The setting applies from
+     * the next file load.
+     *
+     * @since 1.2.0
+     *
+     * @param directory The path to a directory.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setPreloadCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief Enable or disable the sharing of sample data between synths.
+     *
+     * When enabled, the preloaded data of the sample files is shared with
+     * the other synths of the process which enable it, so that instruments
+     * using the same sample files keep a single copy of it in memory. Data
+     * is shared as long as the files are unchanged on disk. This is
+     * disabled by default. The setting applies from the next file load.
+     *
+     * @since 1.2.0
+     *
+     * @param sampleSharing Whether the sample data is shared.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setSampleSharing(bool sampleSharing) noexcept;
+
+    /**
+     * @brief Return whether the sharing of sample data between synths is enabled.
+     * @since 1.2.0
+     */
+    bool getSampleSharing() const noexcept;
+
+    /**
+     * @brief Enable or disable the control-rate evaluation of modulations.
+     *
+     * When enabled, the modulation sources which only drive filter and
+     * equalizer parameters are evaluated once every control interval, and
+     * hold their values in between. This is disabled by default.
+     *
+     * @since 1.2.0
+     *
+     * @param controlRate Whether the modulations are evaluated at control rate.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     * - @b OFF: the function cannot be invoked while a thread is calling @b RT functions
+     */
+    void setControlRateModulation(bool controlRate) noexcept;
+
+    /**
+     * @brief Return whether the control-rate evaluation of modulations is enabled.
+     * @since 1.2.0
+     */
+    bool getControlRateModulation() const noexcept;
+
+    /**
+     * @brief Set the memory budget of the sample data.
+     *
+     * When the sample data uses more memory than the budget, the files
+     * which were entirely loaded in the background are released, the least
+     * recently used first, as soon as no voice plays them. The preloaded
+     * data counts against the budget but is never released, so the memory
+     * usage can stay over the budget. A budget of 0, which is the default,
+     * disables this.
+     *
+     * @since 1.2.0
+     *
+     * @param numBytes The budget in bytes, or 0.
+     *
+     * @par Thread-safety constraints
+     * - @b CT: the function must be invoked from the Control thread
+     */
+    void setSampleMemoryBudget(size_t numBytes) noexcept;
+
+    /**
+     * @brief Return the memory budget of the sample data, in bytes.
+     * @since 1.2.0
+     */
+    size_t getSampleMemoryBudget() const noexcept;
+
+    /**
+     * @brief Return the memory used by the sample data, in bytes.
+     *
+     * This counts the preloaded data and the files loaded in the background.
+     * @since 1.2.0
+     */
+    size_t getSampleMemoryUsage() const noexcept;
+
+    /**
+     * @brief Return the number of files released to fit in the memory budget.
+     * @since 1.2.0
+     */
+    size_t getNumSampleEvictions() const noexcept;
+
+    /**
+     * @brief Return the amount of sample data released to fit in the memory
+     * budget, in bytes.
+     * @since 1.2.0
+     */
+    size_t getSampleEvictedBytes() const noexcept;
+
     /**
      * @brief Return the number of allocated buffers.
      * @since 0.2.0
@@ -5,12 +5,17 @@
 // If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
 
 #include "AudioReader.h"
+#include "Config.h"
 #include "FileMetadata.h"
+#include "MappedFile.h"
+#include "utility/Debug.h"
 #include <st_audiofile.hpp>
 #if defined(SFIZZ_USE_SNDFILE)
 #include <sndfile.h>
 #endif
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace sfz {
 
@@ -103,15 +108,16 @@ struct AudioFrame {
 /**
  * @brief Reorder a sequence of frames in reverse
  */
-static void reverse_frames(float* data, size_t frames, unsigned channels)
+template <class T>
+static void reverse_frames(T* data, size_t frames, unsigned channels)
 {
     switch (channels) {
 
 #define SPECIALIZE_FOR(N)                                           \
         case N:                                                     \
             std::reverse(                                           \
-                reinterpret_cast<AudioFrame<N> *>(data),            \
-                reinterpret_cast<AudioFrame<N> *>(data) + frames);  \
+                reinterpret_cast<AudioFrame<N, T> *>(data),         \
+                reinterpret_cast<AudioFrame<N, T> *>(data) + frames); \
             break
 
     SPECIALIZE_FOR(1);
@@ -120,8 +126,8 @@ static void reverse_frames(float* data, size_t frames, unsigned channels)
     default:
         for (size_t i = 0; i < frames / 2; ++i) {
             size_t j = frames - 1 - i;
-            float* frame1 = &data[i * channels];
-            float* frame2 = &data[j * channels];
+            T* frame1 = &data[i * channels];
+            T* frame2 = &data[j * channels];
             for (unsigned c = 0; c < channels; ++c)
                 std::swap(frame1[c], frame2[c]);
         }
@@ -239,6 +245,416 @@ void NoSeekReverseReader::readWholeFile()
 
 //------------------------------------------------------------------------------
 
+/**
+ * @brief Sample encodings of uncompressed audio files
+ */
+enum class PcmEncoding { U8, S8, S16, S24, S32, F32, F64 };
+
+/**
+ * @brief Location and format of the samples in an uncompressed audio file
+ */
+struct PcmLayout {
+    PcmEncoding encoding { PcmEncoding::S16 };
+    bool bigEndian { false };
+    unsigned channels { 0 };
+    unsigned sampleRate { 0 };
+    unsigned frameSize { 0 };
+    size_t dataOffset { 0 };
+    int64_t frames { 0 };
+    int format { st_audio_file_other };
+};
+
+template <bool BigEndian>
+static inline uint32_t loadU16(const uint8_t* p)
+{
+    return BigEndian ? (uint32_t(p[0]) << 8) | p[1] : p[0] | (uint32_t(p[1]) << 8);
+}
+
+template <bool BigEndian>
+static inline uint32_t loadU24(const uint8_t* p)
+{
+    return BigEndian ? (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2]
+                     : p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+}
+
+template <bool BigEndian>
+static inline uint32_t loadU32(const uint8_t* p)
+{
+    return BigEndian ? (loadU16<true>(p) << 16) | loadU16<true>(p + 2)
+                     : loadU16<false>(p) | (loadU16<false>(p + 2) << 16);
+}
+
+template <bool BigEndian>
+static inline uint64_t loadU64(const uint8_t* p)
+{
+    return BigEndian ? (uint64_t(loadU32<true>(p)) << 32) | loadU32<true>(p + 4)
+                     : loadU32<false>(p) | (uint64_t(loadU32<false>(p + 4)) << 32);
+}
+
+/**
+ * @brief Convert samples to float, with the same scaling as the file decoders
+ */
+template <PcmEncoding E, bool BigEndian>
+static void decodePcmSamples(const uint8_t* input, float* output, size_t numSamples)
+{
+    for (size_t i = 0; i < numSamples; ++i) {
+        switch (E) {
+        case PcmEncoding::U8:
+            output[i] = input[i] * 0.00784313725490196078f - 1.0f;
+            break;
+        case PcmEncoding::S8:
+            output[i] = static_cast<int8_t>(input[i]) * (1.0f / 128);
+            break;
+        case PcmEncoding::S16:
+            output[i] = static_cast<int16_t>(loadU16<BigEndian>(&input[2 * i])) * 0.000030517578125f;
+            break;
+        case PcmEncoding::S24:
+            output[i] = static_cast<float>(
+                (static_cast<int32_t>(loadU24<BigEndian>(&input[3 * i]) << 8) >> 8) * 0.00000011920928955078125);
+            break;
+        case PcmEncoding::S32:
+            output[i] = static_cast<float>(static_cast<int32_t>(loadU32<BigEndian>(&input[4 * i])) / 2147483648.0);
+            break;
+        case PcmEncoding::F32:
+            {
+                const uint32_t bits = loadU32<BigEndian>(&input[4 * i]);
+                float value;
+                memcpy(&value, &bits, sizeof(value));
+                output[i] = value;
+            }
+            break;
+        case PcmEncoding::F64:
+            {
+                const uint64_t bits = loadU64<BigEndian>(&input[8 * i]);
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                output[i] = static_cast<float>(value);
+            }
+            break;
+        }
+    }
+}
+
+static void decodePcm(const PcmLayout& layout, const uint8_t* input, float* output, size_t numSamples)
+{
+    switch (layout.encoding) {
+
+#define DECODE_FOR(E)                                                        \
+        case E:                                                              \
+            if (layout.bigEndian)                                            \
+                decodePcmSamples<E, true>(input, output, numSamples);        \
+            else                                                             \
+                decodePcmSamples<E, false>(input, output, numSamples);       \
+            break
+
+    DECODE_FOR(PcmEncoding::U8);
+    DECODE_FOR(PcmEncoding::S8);
+    DECODE_FOR(PcmEncoding::S16);
+    DECODE_FOR(PcmEncoding::S24);
+    DECODE_FOR(PcmEncoding::S32);
+    DECODE_FOR(PcmEncoding::F32);
+    DECODE_FOR(PcmEncoding::F64);
+
+#undef DECODE_FOR
+    }
+}
+
+static void decodePcm(const PcmLayout& layout, const uint8_t* input, int16_t* output, size_t numSamples)
+{
+    ASSERT(layout.encoding == PcmEncoding::S16);
+    for (size_t i = 0; i < numSamples; ++i) {
+        output[i] = static_cast<int16_t>(layout.bigEndian ?
+            loadU16<true>(&input[2 * i]) : loadU16<false>(&input[2 * i]));
+    }
+}
+
+static bool parseWavLayout(const uint8_t* data, size_t size, PcmLayout& layout)
+{
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+        return false;
+
+    bool haveFormat = false;
+    size_t position = 12;
+
+    while (position + 8 <= size) {
+        const uint8_t* chunk = data + position;
+        const uint32_t chunkSize = loadU32<false>(chunk + 4);
+        const size_t available = size - (position + 8);
+
+        if (!memcmp(chunk, "fmt ", 4)) {
+            if (chunkSize < 16 || available < 16)
+                return false;
+
+            const uint8_t* fmt = chunk + 8;
+            uint32_t formatTag = loadU16<false>(fmt);
+            const uint32_t blockAlign = loadU16<false>(fmt + 12);
+            const uint32_t bitsPerSample = loadU16<false>(fmt + 14);
+            layout.channels = loadU16<false>(fmt + 2);
+            layout.sampleRate = loadU32<false>(fmt + 4);
+
+            // WAVE_FORMAT_EXTENSIBLE: the actual format starts the subformat GUID
+            if (formatTag == 0xfffe) {
+                if (chunkSize < 40 || available < 40)
+                    return false;
+                formatTag = loadU16<false>(fmt + 24);
+            }
+
+            if (formatTag == 1 && bitsPerSample == 8)
+                layout.encoding = PcmEncoding::U8;
+            else if (formatTag == 1 && bitsPerSample == 16)
+                layout.encoding = PcmEncoding::S16;
+            else if (formatTag == 1 && bitsPerSample == 24)
+                layout.encoding = PcmEncoding::S24;
+            else if (formatTag == 1 && bitsPerSample == 32)
+                layout.encoding = PcmEncoding::S32;
+            else if (formatTag == 3 && bitsPerSample == 32)
+                layout.encoding = PcmEncoding::F32;
+            else if (formatTag == 3 && bitsPerSample == 64)
+                layout.encoding = PcmEncoding::F64;
+            else
+                return false;
+
+            layout.frameSize = layout.channels * (bitsPerSample / 8);
+            if (layout.channels == 0 || layout.sampleRate == 0 || blockAlign != layout.frameSize)
+                return false;
+
+            haveFormat = true;
+        }
+        else if (!memcmp(chunk, "data", 4)) {
+            if (!haveFormat)
+                return false;
+
+            layout.bigEndian = false;
+            layout.dataOffset = position + 8;
+            layout.frames = std::min<size_t>(chunkSize, available) / layout.frameSize;
+            layout.format = st_audio_file_wav;
+            return true;
+        }
+
+        position += 8 + size_t(chunkSize) + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+static double loadExtendedFloat(const uint8_t* p)
+{
+    const int exponent = static_cast<int>(loadU16<true>(p) & 0x7fff);
+    const uint64_t mantissa = loadU64<true>(p + 2);
+    return std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+}
+
+static bool parseAiffLayout(const uint8_t* data, size_t size, PcmLayout& layout)
+{
+    if (size < 12 || memcmp(data, "FORM", 4) != 0)
+        return false;
+
+    bool isAifc;
+    if (!memcmp(data + 8, "AIFF", 4))
+        isAifc = false;
+    else if (!memcmp(data + 8, "AIFC", 4))
+        isAifc = true;
+    else
+        return false;
+
+    bool haveCommon = false;
+    bool haveSound = false;
+    uint32_t commonFrames = 0;
+    size_t soundSize = 0;
+    size_t position = 12;
+
+    // the common chunk can be placed after the sound data
+    while (position + 8 <= size) {
+        const uint8_t* chunk = data + position;
+        const uint32_t chunkSize = loadU32<true>(chunk + 4);
+        const size_t available = size - (position + 8);
+
+        if (!memcmp(chunk, "COMM", 4)) {
+            const uint32_t minSize = isAifc ? 22 : 18;
+            if (chunkSize < minSize || available < minSize)
+                return false;
+
+            const uint8_t* comm = chunk + 8;
+            layout.channels = loadU16<true>(comm);
+            commonFrames = loadU32<true>(comm + 2);
+            const uint32_t bitsPerSample = loadU16<true>(comm + 6);
+            layout.sampleRate = static_cast<unsigned>(loadExtendedFloat(comm + 8));
+
+            layout.bigEndian = true;
+            bool isFloat = false;
+            if (isAifc) {
+                const uint8_t* compression = comm + 18;
+                if (!memcmp(compression, "sowt", 4))
+                    layout.bigEndian = false;
+                else if (!memcmp(compression, "fl32", 4) || !memcmp(compression, "FL32", 4)
+                    || !memcmp(compression, "fl64", 4) || !memcmp(compression, "FL64", 4))
+                    isFloat = true;
+                else if (memcmp(compression, "NONE", 4) != 0 && memcmp(compression, "twos", 4) != 0)
+                    return false;
+            }
+
+            const uint32_t bytesPerSample = (bitsPerSample + 7) / 8;
+            if (isFloat && bytesPerSample == 4)
+                layout.encoding = PcmEncoding::F32;
+            else if (isFloat && bytesPerSample == 8)
+                layout.encoding = PcmEncoding::F64;
+            else if (!isFloat && bytesPerSample == 1)
+                layout.encoding = PcmEncoding::S8;
+            else if (!isFloat && bytesPerSample == 2)
+                layout.encoding = PcmEncoding::S16;
+            else if (!isFloat && bytesPerSample == 3)
+                layout.encoding = PcmEncoding::S24;
+            else if (!isFloat && bytesPerSample == 4)
+                layout.encoding = PcmEncoding::S32;
+            else
+                return false;
+
+            layout.frameSize = layout.channels * bytesPerSample;
+            if (layout.channels == 0 || layout.sampleRate == 0)
+                return false;
+
+            haveCommon = true;
+        }
+        else if (!memcmp(chunk, "SSND", 4)) {
+            if (chunkSize < 8 || available < 8)
+                return false;
+
+            const uint32_t offset = loadU32<true>(chunk + 8);
+            if (offset > chunkSize - 8)
+                return false;
+
+            layout.dataOffset = position + 16 + offset;
+            soundSize = std::min<size_t>(chunkSize - 8 - offset, size - std::min(size, layout.dataOffset));
+            haveSound = true;
+        }
+
+        position += 8 + size_t(chunkSize) + (chunkSize & 1);
+    }
+
+    if (!haveCommon || !haveSound)
+        return false;
+
+    layout.frames = std::min<int64_t>(commonFrames, soundSize / layout.frameSize);
+    layout.format = st_audio_file_aiff;
+    return true;
+}
+
+/**
+ * @brief Audio file reader for uncompressed files, which decodes the samples
+ * directly from a memory mapping of the file, in either direction.
+ *
+ * This avoids the system calls and the intermediate copies of the file
+ * decoders, and the pages of the file are shared with the system cache.
+ */
+class MappedPcmReader : public AudioReader {
+public:
+    MappedPcmReader(std::unique_ptr<MappedFile> file, const PcmLayout& layout, bool reverse);
+    AudioReaderType type() const override;
+    int format() const override { return layout_.format; }
+    int64_t frames() const override { return layout_.frames; }
+    unsigned channels() const override { return layout_.channels; }
+    unsigned sampleRate() const override { return layout_.sampleRate; }
+    size_t readNextBlock(float* buffer, size_t frames) override;
+    // the instrument chunks are extracted by the metadata reader
+    bool getInstrument(InstrumentInfo*) override { return false; }
+    bool hasS16Samples() const override { return layout_.encoding == PcmEncoding::S16; }
+    size_t readNextBlockS16(int16_t* buffer, size_t frames) override;
+    void prefetch(int64_t frame, int64_t numFrames) override;
+
+private:
+    template <class T>
+    size_t readFrames(T* buffer, size_t frames);
+
+    std::unique_ptr<MappedFile> file_;
+    PcmLayout layout_;
+    bool reverse_ { false };
+    int64_t position_ { 0 };
+};
+
+MappedPcmReader::MappedPcmReader(std::unique_ptr<MappedFile> file, const PcmLayout& layout, bool reverse)
+    : file_(std::move(file)), layout_(layout), reverse_(reverse)
+{
+    position_ = reverse ? layout.frames : 0;
+    if (!reverse)
+        file_->adviseSequential();
+}
+
+AudioReaderType MappedPcmReader::type() const
+{
+    return reverse_ ? AudioReaderType::Reverse : AudioReaderType::Forward;
+}
+
+size_t MappedPcmReader::readNextBlock(float* buffer, size_t frames)
+{
+    return readFrames(buffer, frames);
+}
+
+size_t MappedPcmReader::readNextBlockS16(int16_t* buffer, size_t frames)
+{
+    if (!hasS16Samples())
+        return 0;
+
+    return readFrames(buffer, frames);
+}
+
+template <class T>
+size_t MappedPcmReader::readFrames(T* buffer, size_t frames)
+{
+    int64_t first;
+    int64_t readFrames;
+
+    if (!reverse_) {
+        readFrames = std::min<int64_t>(frames, layout_.frames - position_);
+        first = position_;
+        position_ += readFrames;
+    } else {
+        readFrames = std::min<int64_t>(frames, position_);
+        position_ -= readFrames;
+        first = position_;
+    }
+
+    if (readFrames <= 0)
+        return 0;
+
+    const uint8_t* input = file_->data() + layout_.dataOffset + first * layout_.frameSize;
+    decodePcm(layout_, input, buffer, static_cast<size_t>(readFrames) * layout_.channels);
+
+    if (reverse_)
+        reverse_frames(buffer, static_cast<size_t>(readFrames), layout_.channels);
+
+    return static_cast<size_t>(readFrames);
+}
+
+void MappedPcmReader::prefetch(int64_t frame, int64_t numFrames)
+{
+    int64_t first = reverse_ ? layout_.frames - (frame + numFrames) : frame;
+    int64_t last = first + numFrames;
+    first = std::max<int64_t>(first, 0);
+    last = std::min<int64_t>(last, layout_.frames);
+    if (first >= last)
+        return;
+
+    file_->prefetch(
+        layout_.dataOffset + static_cast<size_t>(first) * layout_.frameSize,
+        static_cast<size_t>(last - first) * layout_.frameSize);
+}
+
+static AudioReaderPtr createMappedAudioReader(const fs::path& path, bool reverse)
+{
+    std::unique_ptr<MappedFile> file { new MappedFile };
+    if (!file->open(path))
+        return {};
+
+    PcmLayout layout;
+    if (!parseWavLayout(file->data(), file->size(), layout) &&
+        !parseAiffLayout(file->data(), file->size(), layout))
+        return {};
+
+    return AudioReaderPtr { new MappedPcmReader(std::move(file), layout, reverse) };
+}
+
+//------------------------------------------------------------------------------
+
 #if defined(SFIZZ_USE_SNDFILE)
 const std::error_category& sndfile_category()
 {
@@ -365,6 +781,14 @@ static AudioReaderPtr createAudioReaderWithHandle(ST_AudioFile handle, bool reve
 
 AudioReaderPtr createAudioReader(const fs::path& path, bool reverse, std::error_code* ec)
 {
+    if (config::memoryMappedFiles) {
+        if (AudioReaderPtr reader = createMappedAudioReader(path, reverse)) {
+            if (ec)
+                ec->clear();
+            return reader;
+        }
+    }
+
     ST_AudioFile handle;
 #if defined(_WIN32)
     handle.open_file_w(path.wstring().c_str());
@@ -40,12 +40,30 @@ public:
     virtual unsigned sampleRate() const = 0;
     virtual size_t readNextBlock(float* buffer, size_t frames) = 0;
     virtual bool getInstrument(InstrumentInfo* instrument) = 0;
+    /**
+     * @brief Whether the file holds 16-bit integer samples, which
+     * `readNextBlockS16` can read without any conversion loss.
+     */
+    virtual bool hasS16Samples() const { return false; }
+    /**
+     * @brief Read the next block of frames as 16-bit integer samples.
+     * This is only supported if `hasS16Samples` is true.
+     */
+    virtual size_t readNextBlockS16(int16_t* buffer, size_t frames) { (void)buffer; (void)frames; return 0; }
+    /**
+     * @brief Hint that a range of frames is going to be read soon. The frames
+     * are counted in reading order. This does nothing, unless the reader
+     * accesses the file through a memory mapping.
+     */
+    virtual void prefetch(int64_t frame, int64_t numFrames) { (void)frame; (void)numFrames; }
 };
 
 typedef std::unique_ptr<AudioReader> AudioReaderPtr;
 
 /**
- * @brief Create a file reader of detected type.
+ * @brief Create a file reader of detected type. Uncompressed WAV and AIFF
+ * files are decoded directly from a memory mapping of the file, if
+ * config::memoryMappedFiles is enabled.
  */
 AudioReaderPtr createAudioReader(const fs::path& path, bool reverse, std::error_code* ec = nullptr);
 
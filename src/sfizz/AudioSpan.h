@@ -175,6 +175,24 @@ public:
         }
     }
 
+    /**
+     * @brief Construct a new read-only Audio Span object from a const AudioBuffer.
+     *
+     * @tparam U the underlying type compatible with the template Type of the AudioSpan
+     * @tparam N the number of channels in the AudioBuffer
+     * @tparam Alignment the alignment block size for the platform
+     * @param audioBuffer the source AudioBuffer.
+     */
+    template <class U, size_t N, unsigned int Alignment, size_t PaddingLeft, size_t PaddingRight, typename = typename std::enable_if<N <= MaxChannels>::type, typename = typename std::enable_if<std::is_same<const U, Type>::value, int>::type>
+    AudioSpan(const AudioBuffer<U, N, Alignment, PaddingLeft, PaddingRight>& audioBuffer)
+        : numFrames(audioBuffer.getNumFrames())
+        , numChannels(audioBuffer.getNumChannels())
+    {
+        for (size_t i = 0; i < numChannels; i++) {
+            this->spans[i] = audioBuffer.channelReader(i);
+        }
+    }
+
     /**
      * @brief Construct a new Audio Span object from an AudioBuffer with a non-const Type.
      *
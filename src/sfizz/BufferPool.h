@@ -7,180 +7,230 @@
 #pragma once
 #include "Config.h"
 #include "Buffer.h"
-#include "AudioBuffer.h"
 #include "AudioSpan.h"
 #include "utility/Debug.h"
-#include <array>
-#include <memory>
-#include <functional>
-#include "absl/algorithm/container.h"
-#ifndef NDEBUG
-#include "MathHelpers.h"
-#endif
+#include <algorithm>
+#include <vector>
 
 namespace sfz {
 
+class BufferPool;
+
+/**
+ * @brief A scratch buffer obtained from a buffer pool. It is given back to
+ * the pool when the holder is destroyed or assigned another buffer.
+ */
 template <class T>
 class SpanHolder {
 public:
     SpanHolder() {}
     SpanHolder(const SpanHolder<T>&) = delete;
     SpanHolder<T>& operator=(const SpanHolder<T>&) = delete;
-    SpanHolder(SpanHolder<T>&& other)
+    SpanHolder(SpanHolder<T>&& other) noexcept
+        : value(other.value)
+        , pool(other.pool)
+        , entry(other.entry)
     {
-        this->value = other.value;
-        this->available = other.available;
-        other.available = nullptr;
+        other.pool = nullptr;
     }
-    SpanHolder<T>& operator=(SpanHolder<T>&& other)
+    SpanHolder<T>& operator=(SpanHolder<T>&& other) noexcept
     {
-        this->value = other.value;
-        this->available = other.available;
-        other.available = nullptr;
+        if (this != &other) {
+            release();
+            this->value = other.value;
+            this->pool = other.pool;
+            this->entry = other.entry;
+            other.pool = nullptr;
+        }
         return *this;
     }
-    SpanHolder(T&& value, int* available)
+    SpanHolder(T&& value, BufferPool* pool, unsigned entry)
         : value(std::forward<T>(value))
-        , available(available)
+        , pool(pool)
+        , entry(entry)
     {
     }
     T& operator*() { return value; }
     T* operator->() { return &value; }
-    explicit operator bool() const { return available != nullptr; }
-    ~SpanHolder()
-    {
-        if (available)
-            *available += 1;
-    }
+    explicit operator bool() const { return pool != nullptr; }
+    ~SpanHolder() { release(); }
 
 private:
+    void release() noexcept;
+
     T value {};
-    int* available { nullptr };
+    BufferPool* pool { nullptr };
+    unsigned entry {};
 };
 
+/**
+ * @brief A stack of scratch buffers, for the processing of a block.
+ *
+ * The buffers are carved out of a single block of memory, whose capacity is
+ * counted in buffers of the block size; a stereo buffer takes two of them.
+ * Getting a buffer pushes it on top of the stack, and the buffers are popped
+ * as their holders go out of scope, so both operations are O(1). A buffer
+ * which is given back while others are still in use above it is popped
+ * along with them.
+ */
 class BufferPool {
 public:
     BufferPool()
     {
-        for (auto& buffer : stereoBuffers) {
-            buffer.addChannels(2);
-        }
-        monoAvailable.resize(config::bufferPoolSize);
-        stereoAvailable.resize(config::stereoBufferPoolSize);
-        indexAvailable.resize(config::indexBufferPoolSize);
-        _setBufferSize(config::defaultSamplesPerBlock);
+        resize(config::defaultSamplesPerBlock, config::bufferPoolCapacity);
     }
 
+    /**
+     * @brief Set the size of the buffers. No buffer may be in use.
+     *
+     * @param bufferSize
+     */
     void setBufferSize(unsigned bufferSize)
     {
-        ASSERT(absl::c_all_of(monoAvailable, [](int value) { return value == 1; }));
-        ASSERT(absl::c_all_of(indexAvailable, [](int value) { return value == 1; }));
-        ASSERT(absl::c_all_of(stereoAvailable, [](int value) { return value == 1; }));
-        _setBufferSize(bufferSize);
+        resize(bufferSize, capacity_);
     }
 
-    SpanHolder<absl::Span<float>> getBuffer(size_t numFrames)
+    /**
+     * @brief Set the capacity of the pool, in buffers of the block size.
+     * No buffer may be in use.
+     *
+     * @param numBuffers
+     */
+    void setCapacity(unsigned numBuffers)
     {
-        const auto availableIt = absl::c_find(monoAvailable, 1);
-        if (availableIt == monoAvailable.end()) {
-            DBG("[sfizz] No free buffers available...");
-            return {};
-        }
-        const auto freeIndex = std::distance(monoAvailable.begin(), availableIt);
+        resize(bufferSize_, std::max(1u, numBuffers));
+    }
 
-        if (monoBuffers[freeIndex].size() < numFrames) {
-            DBG("[sfizz] Someone asked for a buffer of size " << numFrames << "; only " << monoBuffers[freeIndex].size() << " available...");
+    /**
+     * @brief Get the capacity of the pool, in buffers of the block size.
+     */
+    unsigned getCapacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Get the highest number of buffers which were in use at once.
+     */
+    unsigned getMaxBuffersUsed() const noexcept { return maxBuffersUsed_; }
+
+    /**
+     * @brief Get the number of requests which failed because the pool was
+     * exhausted or the requested size was too large.
+     */
+    unsigned getNumFailedRequests() const noexcept { return numFailedRequests_; }
+
+    /**
+     * @brief Reset the statistics of the pool.
+     */
+    void resetStatistics() noexcept
+    {
+        maxBuffersUsed_ = 0;
+        numFailedRequests_ = 0;
+    }
+
+    SpanHolder<absl::Span<float>> getBuffer(size_t numFrames)
+    {
+        unsigned entry;
+        float* data = push(1, numFrames, entry);
+        if (!data)
             return {};
-        }
 
-#ifndef NDEBUG
-        maxBuffersUsed = 1 + absl::c_count_if(monoAvailable, [](int value) { return value == 0; });
-#endif
-        *availableIt -= 1;
-        return { absl::MakeSpan(monoBuffers[freeIndex]).first(numFrames), &*availableIt };
+        return { absl::MakeSpan(data, numFrames), this, entry };
     }
 
     SpanHolder<absl::Span<int>> getIndexBuffer(size_t numFrames)
     {
-        const auto availableIt = absl::c_find(indexAvailable, 1);
-        if (availableIt == indexAvailable.end()) {
-            DBG("[sfizz] No available index buffers in the pool");
-            return {};
-        }
-        const auto freeIndex = std::distance(indexAvailable.begin(), availableIt);
+        static_assert(sizeof(int) == sizeof(float), "Index buffers share the float storage");
 
-        if (indexBuffers[freeIndex].size() < numFrames) {
-            DBG("[sfizz] Someone asked for a index buffer of size " << numFrames << "; only " << indexBuffers[freeIndex].size() << " available...");
+        unsigned entry;
+        float* data = push(1, numFrames, entry);
+        if (!data)
             return {};
-        }
 
-#ifndef NDEBUG
-        maxIndexBuffersUsed = 1 + absl::c_count_if(indexAvailable, [](int value) { return value == 0; });
-#endif
-        *availableIt -= 1;
-        return { absl::MakeSpan(indexBuffers[freeIndex]).first(numFrames), &*availableIt };
+        return { absl::MakeSpan(reinterpret_cast<int*>(data), numFrames), this, entry };
     }
 
     SpanHolder<AudioSpan<float>> getStereoBuffer(size_t numFrames)
     {
-        const auto availableIt = absl::c_find(stereoAvailable, 1);
-        if (availableIt == stereoAvailable.end()) {
-            DBG("[sfizz] No available stereo buffers in the pool");
+        unsigned entry;
+        float* data = push(2, numFrames, entry);
+        if (!data)
             return {};
-        }
-        const auto freeIndex = std::distance(stereoAvailable.begin(), availableIt);
 
-        if (stereoBuffers[freeIndex].getNumFrames() < numFrames) {
-            DBG("[sfizz] Someone asked for a stereo buffer of size " << numFrames << "; only " << stereoBuffers[freeIndex].getNumFrames() << " available...");
-            return {};
-        }
-
-#ifndef NDEBUG
-        maxStereoBuffersUsed = 1 + absl::c_count_if(stereoAvailable, [](int value) { return value == 0; });
-#endif
-        *availableIt -= 1;
-        return { sfz::AudioSpan<float>(stereoBuffers[freeIndex]).first(numFrames), &*availableIt };
+        return { AudioSpan<float>({ data, data + stride_ }, numFrames), this, entry };
     }
 
-#ifndef NDEBUG
-    ~BufferPool()
+private:
+    template <class T> friend class SpanHolder;
+
+    void resize(unsigned bufferSize, unsigned capacity)
     {
-        // DBG("Max buffers used: " << maxBuffersUsed);
-        // DBG("Max index buffers used: " << maxIndexBuffersUsed);
-        // DBG("Max stereo buffers used: " << maxStereoBuffersUsed);
+        ASSERT(depth_ == 0);
+        bufferSize_ = bufferSize;
+        capacity_ = capacity;
+        // keep every buffer aligned on its own cache lines
+        stride_ = (bufferSize + 15) & ~size_t(15);
+        memory_.resize(capacity * stride_);
+        entryStarts_.resize(capacity);
+        entryReleased_.resize(capacity);
+        top_ = 0;
+        depth_ = 0;
     }
-#endif
 
-private:
-    void _setBufferSize(unsigned bufferSize)
+    float* push(unsigned numBuffers, size_t numFrames, unsigned& entry) noexcept
     {
-        for (auto& buffer : monoBuffers) {
-            buffer.resize(bufferSize);
+        if (numFrames > bufferSize_) {
+            DBG("[sfizz] Someone asked for a buffer of size " << numFrames << "; only " << bufferSize_ << " available...");
+            ++numFailedRequests_;
+            return nullptr;
         }
 
-        for (auto& buffer : indexBuffers) {
-            buffer.resize(bufferSize);
+        if (top_ + numBuffers > capacity_) {
+            DBG("[sfizz] No free buffers available...");
+            ++numFailedRequests_;
+            return nullptr;
         }
 
-        for (auto& buffer : stereoBuffers) {
-            buffer.resize(bufferSize);
-        }
+        entry = depth_++;
+        entryStarts_[entry] = top_;
+        entryReleased_[entry] = false;
 
-        absl::c_fill(monoAvailable, 1);
-        absl::c_fill(stereoAvailable, 1);
-        absl::c_fill(indexAvailable, 1);
+        float* data = memory_.data() + top_ * stride_;
+        top_ += numBuffers;
+        maxBuffersUsed_ = std::max(maxBuffersUsed_, top_);
+        return data;
     }
 
-    std::array<sfz::Buffer<float>, config::bufferPoolSize> monoBuffers;
-    std::vector<int> monoAvailable;
-    std::array<sfz::Buffer<int>, config::bufferPoolSize> indexBuffers;
-    std::vector<int> indexAvailable;
-    std::array<sfz::AudioBuffer<float>, config::stereoBufferPoolSize> stereoBuffers;
-    std::vector<int> stereoAvailable;
-#ifndef NDEBUG
-    mutable int maxBuffersUsed { 0 };
-    mutable int maxIndexBuffersUsed { 0 };
-    mutable int maxStereoBuffersUsed { 0 };
-#endif
+    void pop(unsigned entry) noexcept
+    {
+        ASSERT(entry < depth_);
+        entryReleased_[entry] = true;
+        while (depth_ > 0 && entryReleased_[depth_ - 1]) {
+            --depth_;
+            top_ = entryStarts_[depth_];
+        }
+    }
+
+    Buffer<float> memory_;
+    size_t stride_ { 0 };
+    unsigned bufferSize_ { 0 };
+    unsigned capacity_ { 0 };
+
+    // the buffers in use, from the bottom of the stack
+    std::vector<unsigned> entryStarts_;
+    std::vector<char> entryReleased_;
+    unsigned depth_ { 0 };
+    unsigned top_ { 0 };
+
+    unsigned maxBuffersUsed_ { 0 };
+    unsigned numFailedRequests_ { 0 };
 };
+
+template <class T>
+inline void SpanHolder<T>::release() noexcept
+{
+    if (pool) {
+        pool->pop(entry);
+        pool = nullptr;
+    }
 }
+
+} // namespace sfz
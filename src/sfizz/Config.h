@@ -38,9 +38,7 @@ namespace config {
     constexpr float maxSampleRate { 192000 };
     constexpr int defaultSamplesPerBlock { 1024 };
     constexpr int maxBlockSize { 8192 };
-    constexpr int bufferPoolSize { 6 };
-    constexpr int stereoBufferPoolSize { 4 };
-    constexpr int indexBufferPoolSize { 4 };
+    constexpr unsigned bufferPoolCapacity { 32 }; // in buffers of the block size
     constexpr int preloadSize { 8192 };
     constexpr bool loadInRam { false };
     constexpr int loggerQueueSize { 256 };
@@ -49,6 +47,9 @@ namespace config {
     constexpr size_t maxChannels { 32 };
     constexpr int numBackgroundThreads { 4 };
     constexpr unsigned fileClearingPeriod { 5 }; // in seconds
+    constexpr size_t sampleMemoryBudget { 0 }; // in bytes, 0 is unlimited
+    constexpr uint64_t preloadCacheMaxSize { uint64_t(1) << 30 }; // in bytes
+    constexpr unsigned memoryBudgetCheckPeriod { 100 }; // in milliseconds
     constexpr int numVoices { 64 };
     constexpr unsigned maxVoices { 256 };
     constexpr unsigned smoothingSteps { 512 };
@@ -73,10 +74,20 @@ namespace config {
     constexpr uint16_t numCCs { 512 };
     constexpr int maxCurves { 256 };
     constexpr int fileChunkSize { 1024 };
+    constexpr bool diskStreaming { false };
+    constexpr int streamWindowFrames { 32768 }; // must be a power of 2
+    constexpr int streamViewFrames { 2048 };
+    constexpr bool memoryMappedFiles { true };
+    constexpr bool compactSampleStorage { false };
+    constexpr bool sampleSharing { false };
     constexpr int processChunkSize { 16 };
     constexpr unsigned int defaultAlignment { 16 };
     constexpr int filtersInPool { maxVoices * 2 };
+    constexpr unsigned filterBankVoices { 4 }; // voices whose filters run together in serial rendering
+    constexpr unsigned filterCutoffTableSteps { 32 }; // entries per octave of the filter bank cutoff tables
+    constexpr unsigned filterResonanceTableSteps { 4 }; // entries per dB of the filter bank resonance tables
     constexpr int excessFileFrames { 64 };
+    constexpr unsigned sincResamplerPhases { 256 }; // fractional positions in the polyphase banks
     constexpr int maxLFOSubs { 8 };
     constexpr int maxLFOSteps { 128 };
     /**
@@ -99,6 +110,11 @@ namespace config {
        modulated filter. The lower, the more CPU resources are consumed.
     */
     constexpr int filterControlInterval { 16 };
+    /**
+       Whether the modulation sources which only drive control-rate targets
+       are evaluated every `filterControlInterval` frames by default.
+    */
+    constexpr bool controlRateModulation { false };
     /**
        Amplitude below which an exponential releasing envelope is considered as
        finished.
@@ -138,6 +154,13 @@ namespace config {
        Background file loading
      */
     static constexpr int backgroundLoaderPthreadPriority = 50; // expressed in %
+    /**
+       Parallel voice rendering
+     */
+    static constexpr unsigned maxRenderThreads = 16; // including the calling thread
+    static constexpr int renderThreadPthreadPriority = 80; // expressed in %
+    // Under this many active voices, a block gets rendered serially
+    static constexpr unsigned parallelRenderMinVoices = 4;
     /**
        @brief Ratio to target under which smoothing is considered as completed
      */
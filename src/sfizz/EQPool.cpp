@@ -43,7 +43,7 @@ void sfz::EQHolder::setup(const Region& region, unsigned eqId, float velocity)
     prepared = false;
 }
 
-void sfz::EQHolder::process(const float** inputs, float** outputs, unsigned numFrames)
+void sfz::EQHolder::process(const float** inputs, float** outputs, unsigned numFrames, unsigned slot)
 {
     if (description == nullptr) {
         for (unsigned channelIdx = 0; channelIdx < eq->channels(); channelIdx++)
@@ -52,7 +52,7 @@ void sfz::EQHolder::process(const float** inputs, float** outputs, unsigned numF
     }
 
     ModMatrix& mm = resources.getModMatrix();
-    BufferPool& bufferPool = resources.getBufferPool();
+    BufferPool& bufferPool = resources.getBufferPool(slot);
     auto frequencySpan = bufferPool.getBuffer(numFrames);
     auto bandwidthSpan = bufferPool.getBuffer(numFrames);
     auto gainSpan = bufferPool.getBuffer(numFrames);
@@ -61,15 +61,15 @@ void sfz::EQHolder::process(const float** inputs, float** outputs, unsigned numF
         return;
 
     fill<float>(*frequencySpan, baseFrequency);
-    if (float* mod = mm.getModulation(frequencyTarget))
+    if (float* mod = mm.getModulation(frequencyTarget, slot))
         add<float>(absl::Span<float>(mod, numFrames), *frequencySpan);
 
     fill<float>(*bandwidthSpan, baseBandwidth);
-    if (float* mod = mm.getModulation(bandwidthTarget))
+    if (float* mod = mm.getModulation(bandwidthTarget, slot))
         add<float>(absl::Span<float>(mod, numFrames), *bandwidthSpan);
 
     fill<float>(*gainSpan, baseGain);
-    if (float* mod = mm.getModulation(gainTarget))
+    if (float* mod = mm.getModulation(gainTarget, slot))
         add<float>(absl::Span<float>(mod, numFrames), *gainSpan);
 
     if (!prepared) {
@@ -29,8 +29,9 @@ public:
      * @param inputs
      * @param outputs
      * @param numFrames
+     * @param slot          the render slot of the calling thread
      */
-    void process(const float** inputs, float** outputs, unsigned numFrames);
+    void process(const float** inputs, float** outputs, unsigned numFrames, unsigned slot);
     /**
      * @brief Set the sample rate for the EQ
      *
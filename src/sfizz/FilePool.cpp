@@ -33,9 +33,10 @@
 #include "utility/Debug.h"
 #include <ThreadPool.h>
 #include <absl/types/span.h>
-#include <absl/strings/match.h>
+#include <absl/strings/ascii.h>
 #include <absl/memory/memory.h>
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <thread>
 #include <system_error>
@@ -46,9 +47,132 @@
 #endif
 using namespace std::placeholders;
 
+namespace sfz {
+
+/**
+ * @brief Identifies a preloaded head in the shared sample store.
+ */
+struct SharedHeadKey {
+    std::string path;
+    uint64_t fileSize { 0 };
+    int64_t fileTime { 0 };
+    uint32_t requestedFrames { 0 };
+    bool reverse { false };
+    bool compact { false };
+
+    bool operator==(const SharedHeadKey& other) const
+    {
+        return path == other.path && fileSize == other.fileSize && fileTime == other.fileTime
+            && requestedFrames == other.requestedFrames && reverse == other.reverse && compact == other.compact;
+    }
+
+    template <class H>
+    friend H AbslHashValue(H h, const SharedHeadKey& key)
+    {
+        return H::combine(std::move(h), key.path, key.fileSize, key.fileTime, key.requestedFrames, key.reverse, key.compact);
+    }
+};
+
+/**
+ * @brief A process-wide store of preloaded heads, which lets the pools of
+ * several synths use the same data for the same sample files. The store does
+ * not own the heads: an entry lives as long as some file data refers to it.
+ */
+class SharedSampleStore {
+public:
+    FileHeadPtr find(const SharedHeadKey& key)
+    {
+        std::lock_guard<std::mutex> lock { mutex };
+        const auto it = heads.find(key);
+        if (it == heads.end())
+            return {};
+        FileHeadPtr head = it->second.lock();
+        if (!head)
+            heads.erase(it);
+        return head;
+    }
+
+    /**
+     * @brief Insert a head, unless another one was inserted meanwhile for the
+     * same key, in which case that other head is returned.
+     */
+    FileHeadPtr insert(const SharedHeadKey& key, FileHeadPtr head)
+    {
+        std::lock_guard<std::mutex> lock { mutex };
+        std::weak_ptr<const FileHead>& entry = heads[key];
+        if (FileHeadPtr existing = entry.lock())
+            return existing;
+        entry = head;
+
+        // Occasionally forget about the heads which are no longer in use
+        if (++numInsertions % 64 == 0) {
+            for (auto it = heads.begin(), end = heads.end(); it != end; ) {
+                auto copyIt = it++;
+                if (copyIt->second.expired())
+                    heads.erase(copyIt);
+            }
+        }
+
+        return head;
+    }
+
+private:
+    std::mutex mutex;
+    absl::flat_hash_map<SharedHeadKey, std::weak_ptr<const FileHead>> heads;
+    size_t numInsertions { 0 };
+};
+
+} // namespace sfz
+
+static bool makeSharedHeadKey(const fs::path& file, const sfz::FileId& fileId, uint32_t requestedFrames, bool compact, sfz::SharedHeadKey& key)
+{
+    std::error_code ec;
+    const fs::path canonicalFile = fs::canonical(file, ec);
+    if (ec)
+        return false;
+    key.fileSize = static_cast<uint64_t>(fs::file_size(canonicalFile, ec));
+    if (ec)
+        return false;
+    key.fileTime = static_cast<int64_t>(fs::last_write_time(canonicalFile, ec).time_since_epoch().count());
+    if (ec)
+        return false;
+    key.path = canonicalFile.u8string();
+    key.requestedFrames = requestedFrames;
+    key.reverse = fileId.isReverse();
+    key.compact = compact;
+    return true;
+}
+
+static std::weak_ptr<sfz::SharedSampleStore> globalSampleStoreWeakPtr;
+static std::mutex globalSampleStoreMutex;
+
+static std::shared_ptr<sfz::SharedSampleStore> globalSampleStore()
+{
+    std::shared_ptr<sfz::SharedSampleStore> sampleStore;
+
+    sampleStore = globalSampleStoreWeakPtr.lock();
+    if (sampleStore)
+        return sampleStore;
+
+    std::lock_guard<std::mutex> lock(globalSampleStoreMutex);
+    sampleStore = globalSampleStoreWeakPtr.lock();
+    if (sampleStore)
+        return sampleStore;
+
+    sampleStore.reset(new sfz::SharedSampleStore);
+    globalSampleStoreWeakPtr = sampleStore;
+    return sampleStore;
+}
+
 static std::weak_ptr<ThreadPool> globalThreadPoolWeakPtr;
 static std::mutex globalThreadPoolMutex;
 
+static unsigned globalThreadPoolSize()
+{
+    unsigned numThreads = std::thread::hardware_concurrency();
+    return (numThreads > 2) ? (numThreads - 2) : 1;
+}
+
 static std::shared_ptr<ThreadPool> globalThreadPool()
 {
     std::shared_ptr<ThreadPool> threadPool;
@@ -62,14 +186,68 @@ static std::shared_ptr<ThreadPool> globalThreadPool()
     if (threadPool)
         return threadPool;
 
-    unsigned numThreads = std::thread::hardware_concurrency();
-    numThreads = (numThreads > 2) ? (numThreads - 2) : 1;
-    threadPool.reset(new ThreadPool(numThreads));
+    threadPool.reset(new ThreadPool(globalThreadPoolSize()));
     globalThreadPoolWeakPtr = threadPool;
     return threadPool;
 }
 
-void readBaseFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, uint32_t numFrames)
+/**
+ * @brief Run a job for every index in the range [0, count) on the thread pool,
+ * with the help of the calling thread, and wait for all of them to complete.
+ */
+template <class F>
+static void parallelFor(ThreadPool& threadPool, size_t count, const F& job)
+{
+    std::atomic<size_t> nextIndex { 0 };
+    auto worker = [&nextIndex, count, &job]() {
+        for (size_t index; (index = nextIndex.fetch_add(1)) < count; )
+            job(index);
+    };
+
+    const size_t numWorkers = std::min<size_t>(globalThreadPoolSize(), count > 0 ? count - 1 : 0);
+    std::vector<std::future<void>> futures;
+    futures.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        try {
+            futures.push_back(threadPool.enqueue(worker));
+        } catch (std::exception& e) {
+            DBG("[sfizz] Could not enqueue a preloading job: " << e.what());
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto& future : futures)
+        future.wait();
+}
+
+static size_t readNextBlock(sfz::AudioReader& reader, float* buffer, size_t numFrames)
+{
+    return reader.readNextBlock(buffer, numFrames);
+}
+
+static size_t readNextBlock(sfz::AudioReader& reader, int16_t* buffer, size_t numFrames)
+{
+    return reader.readNextBlockS16(buffer, numFrames);
+}
+
+static void deinterleave(absl::Span<const float> input, absl::Span<float> outputLeft, absl::Span<float> outputRight)
+{
+    sfz::readInterleaved(input, outputLeft, outputRight);
+}
+
+static void deinterleave(absl::Span<const int16_t> input, absl::Span<int16_t> outputLeft, absl::Span<int16_t> outputRight)
+{
+    const size_t size = std::min(outputLeft.size(), outputRight.size());
+    for (size_t i = 0; i < size; ++i) {
+        outputLeft[i] = input[2 * i];
+        outputRight[i] = input[2 * i + 1];
+    }
+}
+
+template <class T>
+void readBaseFile(sfz::AudioReader& reader, sfz::FileSampleBuffer<T>& output, uint32_t numFrames)
 {
     output.reset();
     output.resize(numFrames);
@@ -79,25 +257,27 @@ void readBaseFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, uint32
     if (channels == 1) {
         output.addChannel();
         output.clear();
-        reader.readNextBlock(output.channelWriter(0), numFrames);
+        readNextBlock(reader, output.channelWriter(0), numFrames);
     } else if (channels == 2) {
         output.addChannel();
         output.addChannel();
         output.clear();
-        sfz::Buffer<float> tempReadBuffer { 2 * numFrames };
-        reader.readNextBlock(tempReadBuffer.data(), numFrames);
-        sfz::readInterleaved(tempReadBuffer, output.getSpan(0), output.getSpan(1));
+        sfz::Buffer<T> tempReadBuffer { 2 * numFrames };
+        readNextBlock(reader, tempReadBuffer.data(), numFrames);
+        deinterleave(absl::MakeConstSpan(tempReadBuffer), output.getSpan(0), output.getSpan(1));
     }
 }
 
-sfz::FileAudioBuffer readFromFile(sfz::AudioReader& reader, uint32_t numFrames)
+template <class T = float>
+sfz::FileSampleBuffer<T> readFromFile(sfz::AudioReader& reader, uint32_t numFrames)
 {
-    sfz::FileAudioBuffer baseBuffer;
+    sfz::FileSampleBuffer<T> baseBuffer;
     readBaseFile(reader, baseBuffer, numFrames);
     return baseBuffer;
 }
 
-void streamFromFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, std::atomic<size_t>* filledFrames = nullptr)
+template <class T>
+void streamFromFile(sfz::AudioReader& reader, sfz::FileSampleBuffer<T>& output, std::atomic<size_t>* filledFrames = nullptr)
 {
     const auto numFrames = static_cast<size_t>(reader.frames());
     const auto numChannels = reader.channels();
@@ -108,7 +288,7 @@ void streamFromFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, std:
     output.resize(numFrames);
     output.clear();
 
-    sfz::Buffer<float> fileBlock { chunkSize * numChannels };
+    sfz::Buffer<T> fileBlock { chunkSize * numChannels };
     size_t inputFrameCounter { 0 };
     size_t outputFrameCounter { 0 };
     bool inputEof = false;
@@ -117,7 +297,7 @@ void streamFromFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, std:
     {
         auto thisChunkSize = std::min(chunkSize, numFrames - inputFrameCounter);
         const auto numFramesRead = static_cast<size_t>(
-            reader.readNextBlock(fileBlock.data(), thisChunkSize));
+            readNextBlock(reader, fileBlock.data(), thisChunkSize));
         if (numFramesRead == 0)
             break;
 
@@ -140,14 +320,105 @@ void streamFromFile(sfz::AudioReader& reader, sfz::FileAudioBuffer& output, std:
     }
 }
 
+sfz::FileStream::FileStream()
+{
+    ring.addChannels(2);
+    ring.resize(config::streamWindowFrames);
+    ring.clear();
+    view.addChannels(2);
+    view.resize(config::streamViewFrames + 2 * config::excessFileFrames);
+    view.clear();
+}
+
+sfz::FileStream::~FileStream()
+{
+}
+
+static void convertSamples(absl::Span<const float> input, absl::Span<float> output)
+{
+    sfz::copy<float>(input, output);
+}
+
+static void convertSamples(absl::Span<const int16_t> input, absl::Span<float> output)
+{
+    for (size_t i = 0, n = std::min(input.size(), output.size()); i < n; ++i)
+        output[i] = input[i] * (1.0f / 32768);
+}
+
+sfz::AudioSpan<const float> sfz::FileStream::getFrames(AudioSpan<const float> head, int64_t first, size_t count) noexcept
+{
+    return readFrames(head, first, count);
+}
+
+sfz::AudioSpan<const float> sfz::FileStream::getFrames(AudioSpan<const int16_t> head, int64_t first, size_t count) noexcept
+{
+    return readFrames(head, first, count);
+}
+
+template <class T>
+sfz::AudioSpan<const float> sfz::FileStream::readFrames(AudioSpan<const T> head, int64_t first, size_t count) noexcept
+{
+    ASSERT(count <= static_cast<size_t>(config::streamViewFrames));
+    count = min(count, static_cast<size_t>(config::streamViewFrames));
+
+    constexpr int64_t padding = config::excessFileFrames;
+    constexpr int64_t windowSize = config::streamWindowFrames;
+    const int64_t begin = first - padding;
+    const int64_t end = first + static_cast<int64_t>(count) + padding;
+    const int64_t headEnd = static_cast<int64_t>(head.getNumFrames());
+    const int64_t filled = max(headEnd, filledFrames.load(std::memory_order_acquire));
+
+    const float* channels[2] {};
+    for (unsigned c = 0; c < numChannels; ++c) {
+        const absl::Span<float> output = view.getSpan(c);
+        const absl::Span<const T> headData = head.getConstSpan(c);
+        const absl::Span<const float> ringData = ring.getConstSpan(c);
+
+        int64_t frame = begin;
+        while (frame < end) {
+            int64_t numFrames;
+            if (frame < 0) {
+                numFrames = min(end, int64_t(0)) - frame;
+                fill<float>(output.subspan(frame - begin, numFrames), 0.0f);
+            } else if (frame < headEnd) {
+                numFrames = min(end, headEnd) - frame;
+                convertSamples(headData.subspan(frame, numFrames), output.subspan(frame - begin, numFrames));
+            } else if (frame < filled) {
+                const int64_t index = frame & (windowSize - 1);
+                numFrames = min(min(end, filled) - frame, windowSize - index);
+                copy<float>(ringData.subspan(index, numFrames), output.subspan(frame - begin, numFrames));
+            } else {
+                // not streamed in time, or past the end of the file
+                numFrames = end - frame;
+                fill<float>(output.subspan(frame - begin, numFrames), 0.0f);
+            }
+            frame += numFrames;
+        }
+
+        channels[c] = output.data();
+    }
+
+    return { channels, numChannels, static_cast<size_t>(padding), count };
+}
+
+void sfz::FileStream::setReadPosition(int64_t position) noexcept
+{
+    // only the owning voice writes the position, keep it monotonic
+    if (position > readPosition.load(std::memory_order_relaxed))
+        readPosition.store(position, std::memory_order_relaxed);
+}
+
 sfz::FilePool::FilePool(sfz::Logger& logger)
     : logger(logger),
       filesToLoad(alignedNew<FileQueue>()),
       threadPool(globalThreadPool())
 {
+    setSampleSharing(config::sampleSharing);
     loadingJobs.reserve(config::maxVoices);
     lastUsedFiles.reserve(config::maxVoices);
     garbageToCollect.reserve(config::maxVoices);
+    compactGarbageToCollect.reserve(config::maxVoices);
+    evictionCandidates.reserve(config::maxVoices);
 }
 
 sfz::FilePool::~FilePool()
@@ -162,6 +433,10 @@ sfz::FilePool::~FilePool()
     dispatchBarrier.post(ec);
     dispatchThread.join();
 
+    streamFlag = false;
+    streamBarrier.post(ec);
+    streamThread.join();
+
     for (auto& job : loadingJobs)
         job.wait();
 }
@@ -193,31 +468,13 @@ bool sfz::FilePool::checkSample(std::string& filename) const noexcept
             continue;
         }
 
-        auto it = path.empty() ? fs::directory_iterator { dot, ec } : fs::directory_iterator { path, ec };
-        if (ec) {
-            DBG("Error creating a directory iterator for " << filename << " (Error code: " << ec.message() << ")");
-            return false;
-        }
-
-        auto searchPredicate = [&part](const fs::directory_entry &ent) -> bool {
-#if !defined(GHC_USE_WCHAR_T)
-            return absl::EqualsIgnoreCase(
-                ent.path().filename().native(), part.native());
-#else
-            return absl::EqualsIgnoreCase(
-                ent.path().filename().u8string(), part.u8string());
-#endif
-        };
-
-        while (it != fs::directory_iterator {} && !searchPredicate(*it))
-            it.increment(ec);
-
-        if (it == fs::directory_iterator {}) {
+        std::string realName;
+        if (!findInDirectory(path.empty() ? dot : path, part, realName)) {
             DBG("File not found, could not resolve " << filename);
             return false;
         }
 
-        path /= it->path().filename();
+        path /= realName;
     }
 
     const auto newPath = fs::relative(path, rootDirectory, ec);
@@ -231,6 +488,48 @@ bool sfz::FilePool::checkSample(std::string& filename) const noexcept
 #endif
 }
 
+bool sfz::FilePool::findInDirectory(const fs::path& directory, const fs::path& name, std::string& realName) const
+{
+    const std::string key = directory.string();
+    const std::string lowerName = absl::AsciiStrToLower(name.string());
+
+    auto find = [&](const DirectoryListing& listing) -> bool {
+        const auto it = listing.find(lowerName);
+        if (it == listing.end())
+            return false;
+        realName = it->second;
+        return true;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock { directoryCacheMutex };
+        const auto it = directoryCache.find(key);
+        if (it != directoryCache.end())
+            return find(it->second);
+    }
+
+    // List the directory without holding the lock; concurrent callers may
+    // list the same directory, and the first listing stored wins
+    DirectoryListing listing;
+    std::error_code ec;
+    for (fs::directory_iterator it { directory, ec }, end; !ec && it != end; it.increment(ec)) {
+        std::string entryName = it->path().filename().string();
+        listing.emplace(absl::AsciiStrToLower(entryName), std::move(entryName));
+    }
+    if (ec)
+        DBG("Error listing the directory " << directory << " (Error code: " << ec.message() << ")");
+
+    std::lock_guard<std::mutex> lock { directoryCacheMutex };
+    const auto inserted = directoryCache.emplace(key, std::move(listing));
+    return find(inserted.first->second);
+}
+
+void sfz::FilePool::clearDirectoryCache() noexcept
+{
+    std::lock_guard<std::mutex> lock { directoryCacheMutex };
+    directoryCache.clear();
+}
+
 bool sfz::FilePool::checkSampleId(FileId& fileId) const noexcept
 {
     std::string filename = fileId.filename();
@@ -241,6 +540,31 @@ bool sfz::FilePool::checkSampleId(FileId& fileId) const noexcept
 }
 
 absl::optional<sfz::FileInformation> sfz::FilePool::getFileInformation(const FileId& fileId) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock { fileInformationMutex };
+        const auto it = fileInformationCache.find(fileId);
+        if (it != fileInformationCache.end()) {
+            ++fileInformationHits;
+            return it->second;
+        }
+    }
+
+    ++fileInformationMisses;
+    absl::optional<FileInformation> information = readFileInformation(fileId);
+
+    std::lock_guard<std::mutex> lock { fileInformationMutex };
+    fileInformationCache.emplace(fileId, information);
+    return information;
+}
+
+void sfz::FilePool::clearFileInformationCache() noexcept
+{
+    std::lock_guard<std::mutex> lock { fileInformationMutex };
+    fileInformationCache.clear();
+}
+
+absl::optional<sfz::FileInformation> sfz::FilePool::readFileInformation(const FileId& fileId) const noexcept
 {
     const fs::path file { rootDirectory / fileId.filename() };
 
@@ -296,45 +620,147 @@ absl::optional<sfz::FileInformation> sfz::FilePool::getFileInformation(const Fil
     return returnedValue;
 }
 
+std::vector<absl::optional<sfz::FileInformation>> sfz::FilePool::checkAndGetFileInformation(absl::Span<FileId> fileIds) noexcept
+{
+    std::vector<absl::optional<FileInformation>> information(fileIds.size());
+
+    parallelFor(*threadPool, fileIds.size(), [this, fileIds, &information](size_t index) {
+        FileId& fileId = fileIds[index];
+        if (checkSampleId(fileId))
+            information[index] = getFileInformation(fileId);
+    });
+
+    return information;
+}
+
 bool sfz::FilePool::preloadFile(const FileId& fileId, uint32_t maxOffset) noexcept
 {
-    auto fileInformation = getFileInformation(fileId);
-    if (!fileInformation)
+    auto it = preloadedFiles.find(fileId);
+    if (it == preloadedFiles.end())
+        it = preloadedFiles.emplace(fileId, FileData {}).first;
+
+    if (!preloadFileData(it->second, fileId, maxOffset)) {
+        if (it->second.status == FileData::Status::Invalid)
+            preloadedFiles.erase(it);
         return false;
+    }
+
+    return true;
+}
+
+void sfz::FilePool::preloadFiles(absl::Span<const std::pair<FileId, uint32_t>> files) noexcept
+{
+    // Create the missing entries first, so the jobs do not modify the map
+    for (const auto& file : files) {
+        if (preloadedFiles.find(file.first) == preloadedFiles.end())
+            preloadedFiles.emplace(file.first, FileData {});
+    }
+
+    std::vector<FileData*> entries(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+        entries[i] = &preloadedFiles[files[i].first];
 
-    fileInformation->maxOffset = maxOffset;
+    parallelFor(*threadPool, files.size(), [this, files, &entries](size_t index) {
+        preloadFileData(*entries[index], files[index].first, files[index].second);
+    });
+
+    for (const auto& file : files) {
+        auto it = preloadedFiles.find(file.first);
+        if (it != preloadedFiles.end() && it->second.status == FileData::Status::Invalid)
+            preloadedFiles.erase(it);
+    }
+}
+
+bool sfz::FilePool::preloadFileData(FileData& data, const FileId& fileId, uint32_t maxOffset) noexcept
+{
     const fs::path file { rootDirectory / fileId.filename() };
-    AudioReaderPtr reader = createAudioReader(file, fileId.isReverse());
+    const uint32_t requestedFrames = loadInRam ? std::numeric_limits<uint32_t>::max() : maxOffset + preloadSize;
+    const bool isNew = data.status == FileData::Status::Invalid;
 
-    const auto frames = static_cast<uint32_t>(reader->frames());
-    const auto framesToLoad = [&]() {
-        if (loadInRam)
-            return frames;
-        else
-            return min(frames, maxOffset + preloadSize);
-    }();
-
-    const auto existingFile = preloadedFiles.find(fileId);
-    if (existingFile != preloadedFiles.end()) {
-        if (framesToLoad > existingFile->second.preloadedData.getNumFrames()) {
-            preloadedFiles[fileId].information.maxOffset = maxOffset;
-            preloadedFiles[fileId].preloadedData = readFromFile(*reader, framesToLoad);
+    SharedHeadKey sharedKey;
+    const bool shared = sampleStore && makeSharedHeadKey(file, fileId, requestedFrames, compactStorage, sharedKey);
+
+    FileHeadPtr head;
+    if (shared)
+        head = sampleStore->find(sharedKey);
+
+    if (!head)
+        head = preloadCache.load(file, fileId, requestedFrames, compactStorage);
+
+    if (!head) {
+        auto fileInformation = getFileInformation(fileId);
+        if (!fileInformation)
+            return false;
+
+        const auto frames = static_cast<uint32_t>(fileInformation->end + 1);
+        const auto framesToLoad = [&]() {
+            if (loadInRam)
+                return frames;
+            else
+                return min(frames, maxOffset + preloadSize);
+        }();
+
+        if (!isNew && framesToLoad <= data.getNumPreloadedFrames()) {
+            data.preloadCallCount++;
+            return true;
         }
-        existingFile->second.preloadCallCount++;
-    } else {
-        fileInformation->sampleRate = static_cast<double>(reader->sampleRate());
-        auto insertedPair = preloadedFiles.insert_or_assign(fileId, {
-            readFromFile(*reader, framesToLoad),
-            *fileInformation
-        });
 
-        insertedPair.first->second.status = FileData::Status::Preloaded;
-        insertedPair.first->second.preloadCallCount++;
+        AudioReaderPtr reader = createAudioReader(file, fileId.isReverse());
+        head = readHead(*reader, *fileInformation, framesToLoad);
+        preloadCache.store(file, fileId, requestedFrames, compactStorage, *head);
     }
 
+    if (shared)
+        head = sampleStore->insert(sharedKey, std::move(head));
+
+    if (isNew || head->getNumFrames() > data.getNumPreloadedFrames()) {
+        if (isNew)
+            data.information = head->information;
+        data.information.maxOffset = maxOffset;
+        setHead(data, std::move(head));
+        if (isNew)
+            data.status = FileData::Status::Preloaded;
+    }
+    data.preloadCallCount++;
+
     return true;
 }
 
+sfz::FileHeadPtr sfz::FilePool::readHead(AudioReader& reader, const FileInformation& information, uint32_t numFrames) const
+{
+    auto head = std::make_shared<FileHead>();
+    head->information = information;
+    head->compact = compactStorage && reader.hasS16Samples();
+    if (head->compact)
+        head->compactData = readFromFile<int16_t>(reader, numFrames);
+    else
+        head->data = readFromFile<float>(reader, numFrames);
+    return head;
+}
+
+void sfz::FilePool::setHead(FileData& data, FileHeadPtr head)
+{
+    if (head->compact != data.compact) {
+        // The fully loaded data is in the wrong format, drop it
+        data.availableFrames = 0;
+        data.fileData.reset();
+        data.compactFileData.reset();
+        if (data.status == FileData::Status::Done)
+            data.status = FileData::Status::Preloaded;
+        data.compact = head->compact;
+    }
+
+    if (data.head)
+        preloadedBytes -= data.head->getNumBytes();
+    preloadedBytes += head->getNumBytes();
+    data.head = std::move(head);
+}
+
+void sfz::FilePool::readPreloadedData(FileData& data, AudioReader& reader, uint32_t numFrames)
+{
+    setHead(data, readHead(reader, data.information, numFrames));
+}
+
 void sfz::FilePool::resetPreloadCallCounts() noexcept
 {
     for (auto& preloadedFile: preloadedFiles)
@@ -347,6 +773,8 @@ void sfz::FilePool::removeUnusedPreloadedData() noexcept
         auto copyIt = it++;
         if (copyIt->second.preloadCallCount == 0) {
             DBG("[sfizz] Removing unused preloaded data: " << copyIt->first.filename());
+            if (copyIt->second.head)
+                preloadedBytes -= copyIt->second.head->getNumBytes();
             preloadedFiles.erase(copyIt);
         }
     }
@@ -358,21 +786,41 @@ sfz::FileDataHolder sfz::FilePool::loadFile(const FileId& fileId) noexcept
     if (!fileInformation)
         return {};
 
-    const fs::path file { rootDirectory / fileId.filename() };
-    AudioReaderPtr reader = createAudioReader(file, fileId.isReverse());
-
-    const auto frames = static_cast<uint32_t>(reader->frames());
     const auto existingFile = loadedFiles.find(fileId);
     if (existingFile != loadedFiles.end()) {
         return { &existingFile->second };
     } else {
-        fileInformation->sampleRate = static_cast<double>(reader->sampleRate());
-        auto insertedPair = preloadedFiles.insert_or_assign(fileId, {
-            readFromFile(*reader, frames),
-            *fileInformation
-        });
-        insertedPair.first->second.status = FileData::Status::Preloaded;
-        return { &insertedPair.first->second };
+        const fs::path file { rootDirectory / fileId.filename() };
+        const uint32_t requestedFrames = std::numeric_limits<uint32_t>::max();
+
+        SharedHeadKey sharedKey;
+        const bool shared = sampleStore && makeSharedHeadKey(file, fileId, requestedFrames, false, sharedKey);
+
+        FileHeadPtr head;
+        if (shared)
+            head = sampleStore->find(sharedKey);
+
+        if (!head) {
+            auto newHead = std::make_shared<FileHead>();
+            newHead->information = *fileInformation;
+            AudioReaderPtr reader = createAudioReader(file, fileId.isReverse());
+            const auto frames = static_cast<uint32_t>(fileInformation->end + 1);
+            newHead->data = readFromFile(*reader, frames);
+            head = std::move(newHead);
+            if (shared)
+                head = sampleStore->insert(sharedKey, std::move(head));
+        }
+
+        auto it = preloadedFiles.find(fileId);
+        if (it == preloadedFiles.end())
+            it = preloadedFiles.emplace(fileId, FileData {}).first;
+
+        // go through `setHead`, so that the head counts in the memory usage
+        FileData& data = it->second;
+        data.information = *fileInformation;
+        setHead(data, std::move(head));
+        data.status = FileData::Status::Preloaded;
+        return { &data };
     }
 }
 
@@ -396,6 +844,183 @@ sfz::FileDataHolder sfz::FilePool::getFilePromise(const std::shared_ptr<FileId>&
     return { &preloaded->second };
 }
 
+sfz::FileDataHolder sfz::FilePool::getFileStream(const std::shared_ptr<FileId>& fileId, FileStreamHolder& stream) noexcept
+{
+    stream.reset();
+
+    if (!diskStreaming)
+        return {};
+
+    const auto preloaded = preloadedFiles.find(*fileId);
+    if (preloaded == preloadedFiles.end()) {
+        DBG("[sfizz] File not found in the preloaded files: " << fileId->filename());
+        return {};
+    }
+
+    FileData& data = preloaded->second;
+    const auto numFrames = static_cast<int64_t>(data.information.end) + 1;
+    const auto headFrames = static_cast<int64_t>(data.getNumPreloadedFrames());
+    if (headFrames >= numFrames)
+        return {};
+
+    for (auto& candidate : streams) {
+        FileStream::Status status = FileStream::Status::Free;
+        if (!candidate->status.compare_exchange_strong(status, FileStream::Status::Acquired))
+            continue;
+
+        candidate->id = fileId;
+        candidate->startFrame = headFrames;
+        candidate->endFrame = numFrames;
+        candidate->numChannels = static_cast<unsigned>(data.information.numChannels);
+        candidate->readPosition = headFrames;
+        candidate->filledFrames = headFrames;
+        activeStreams.fetch_add(1);
+        candidate->status = FileStream::Status::Requested;
+        stream = FileStreamHolder(candidate.get());
+
+        std::error_code ec;
+        streamBarrier.post(ec);
+        ASSERT(!ec);
+
+        return { &data };
+    }
+
+    DBG("[sfizz] No free stream available for " << fileId->filename());
+    return {};
+}
+
+void sfz::FilePool::setDiskStreaming(bool diskStreaming) noexcept
+{
+    if (diskStreaming == this->diskStreaming)
+        return;
+
+    this->diskStreaming = diskStreaming;
+    setNumStreams(numStreams);
+}
+
+void sfz::FilePool::setNumStreams(size_t numStreams)
+{
+    std::lock_guard<std::mutex> guard { streamsMutex };
+
+    // The voices are expected to have released their streams at this point
+    this->numStreams = numStreams;
+    streams.clear();
+    activeStreams = 0;
+
+    if (!diskStreaming)
+        return;
+
+    streams.reserve(numStreams);
+    for (size_t i = 0; i < numStreams; ++i)
+        streams.emplace_back(new FileStream);
+}
+
+void sfz::FilePool::triggerStreaming() noexcept
+{
+    if (activeStreams.load(std::memory_order_relaxed) == 0)
+        return;
+
+    std::error_code ec;
+    streamBarrier.post(ec);
+    ASSERT(!ec);
+}
+
+void sfz::FilePool::streamingJob() noexcept
+{
+    raiseCurrentThreadPriority();
+
+    sfz::Buffer<float> fileBlock { 2 * static_cast<size_t>(config::fileChunkSize) };
+
+    while (streamBarrier.wait(), streamFlag) {
+        std::lock_guard<std::mutex> guard { streamsMutex };
+        for (auto& stream : streams)
+            fillStream(*stream, absl::MakeSpan(fileBlock.data(), fileBlock.size()));
+    }
+}
+
+void sfz::FilePool::fillStream(FileStream& stream, absl::Span<float> fileBlock) noexcept
+{
+    const auto chunkSize = static_cast<int64_t>(config::fileChunkSize);
+    FileStream::Status status = stream.status.load();
+
+    if (status == FileStream::Status::Released) {
+        stream.reader.reset();
+        stream.id.reset();
+        stream.status = FileStream::Status::Free;
+        activeStreams.fetch_sub(1);
+        return;
+    }
+
+    if (status == FileStream::Status::Requested) {
+        std::shared_ptr<FileId> id = stream.id.lock();
+        if (!id) {
+            // file ID was nulled, it means the region was deleted, ignore
+            stream.status.compare_exchange_strong(status, FileStream::Status::Done);
+            return;
+        }
+
+        const fs::path file { rootDirectory / id->filename() };
+        std::error_code readError;
+        AudioReaderPtr reader = createAudioReader(file, id->isReverse(), &readError);
+        if (readError) {
+            DBG("[sfizz] libsndfile errored for " << *id << " with message " << readError.message());
+            stream.status.compare_exchange_strong(status, FileStream::Status::Done);
+            return;
+        }
+
+        // The readers cannot seek, skip over the preloaded frames
+        int64_t skippedFrames = 0;
+        while (skippedFrames < stream.startFrame) {
+            const auto numFrames = static_cast<size_t>(min(chunkSize, stream.startFrame - skippedFrames));
+            const auto numFramesRead = reader->readNextBlock(fileBlock.data(), numFrames);
+            if (numFramesRead == 0)
+                break;
+            skippedFrames += static_cast<int64_t>(numFramesRead);
+        }
+
+        stream.reader = std::move(reader);
+        if (!stream.status.compare_exchange_strong(status, FileStream::Status::Streaming))
+            return;
+
+        status = FileStream::Status::Streaming;
+    }
+
+    if (status != FileStream::Status::Streaming)
+        return;
+
+    constexpr int64_t windowSize = config::streamWindowFrames;
+    const unsigned numChannels = stream.numChannels;
+    const int64_t target = min(stream.endFrame, stream.readPosition.load(std::memory_order_relaxed) + windowSize);
+    int64_t filled = stream.filledFrames.load(std::memory_order_relaxed);
+    bool inputEof = false;
+
+    while (!inputEof && filled < target) {
+        const int64_t index = filled & (windowSize - 1);
+        const auto numFrames = static_cast<size_t>(min(chunkSize, target - filled, windowSize - index));
+        const auto numFramesRead = stream.reader->readNextBlock(fileBlock.data(), numFrames);
+        if (numFramesRead < numFrames)
+            inputEof = true;
+
+        for (unsigned chanIdx = 0; chanIdx < numChannels; ++chanIdx) {
+            const auto outputChunk = stream.ring.getSpan(chanIdx).subspan(index, numFramesRead);
+            for (size_t i = 0; i < numFramesRead; ++i)
+                outputChunk[i] = fileBlock[i * numChannels + chanIdx];
+        }
+
+        filled += static_cast<int64_t>(numFramesRead);
+        stream.filledFrames.store(filled, std::memory_order_release);
+    }
+
+    // Let the system read ahead what the next refill is going to need
+    if (!inputEof)
+        stream.reader->prefetch(filled, windowSize / 2);
+
+    if (inputEof || filled >= stream.endFrame) {
+        stream.reader.reset();
+        stream.status.compare_exchange_strong(status, FileStream::Status::Done);
+    }
+}
+
 void sfz::FilePool::setPreloadSize(uint32_t preloadSize) noexcept
 {
     this->preloadSize = preloadSize;
@@ -407,7 +1032,7 @@ void sfz::FilePool::setPreloadSize(uint32_t preloadSize) noexcept
         const auto maxOffset = preloadedFile.second.information.maxOffset;
         fs::path file { rootDirectory / preloadedFile.first.filename() };
         AudioReaderPtr reader = createAudioReader(file, preloadedFile.first.isReverse());
-        preloadedFile.second.preloadedData = readFromFile(*reader, preloadSize + maxOffset);
+        readPreloadedData(preloadedFile.second, *reader, preloadSize + maxOffset);
     }
 }
 
@@ -456,13 +1081,17 @@ void sfz::FilePool::loadingJob(const QueuedFileData& data) noexcept
         return;
 
     const auto frames = static_cast<uint32_t>(reader->frames());
-    streamFromFile(*reader, data.data->fileData, &data.data->availableFrames);
+    if (data.data->compact)
+        streamFromFile(*reader, data.data->compactFileData, &data.data->availableFrames);
+    else
+        streamFromFile(*reader, data.data->fileData, &data.data->availableFrames);
     const auto loadDuration = std::chrono::high_resolution_clock::now() - loadStartTime;
     logger.logFileTime(waitDuration, loadDuration, frames, id->filename());
 
     data.data->status = FileData::Status::Done;
 
     std::lock_guard<SpinMutex> guard { garbageAndLastUsedMutex };
+    fullDataBytes += data.data->getNumFullDataBytes();
     if (absl::c_find(lastUsedFiles, *id) == lastUsedFiles.end())
         lastUsedFiles.push_back(*id);
 }
@@ -472,8 +1101,11 @@ void sfz::FilePool::clear()
     std::lock_guard<SpinMutex> guard { garbageAndLastUsedMutex };
     emptyFileLoadingQueues();
     garbageToCollect.clear();
+    compactGarbageToCollect.clear();
     lastUsedFiles.clear();
     preloadedFiles.clear();
+    preloadedBytes = 0;
+    fullDataBytes = 0;
 }
 
 uint32_t sfz::FilePool::getPreloadSize() const noexcept
@@ -514,6 +1146,7 @@ void sfz::FilePool::garbageJob() noexcept
     while (semGarbageBarrier.wait(), garbageFlag) {
         std::lock_guard<SpinMutex> guard { garbageAndLastUsedMutex };
         garbageToCollect.clear();
+        compactGarbageToCollect.clear();
     }
 }
 
@@ -527,6 +1160,36 @@ void sfz::FilePool::waitForBackgroundLoading() noexcept
     loadingJobs.clear();
 }
 
+void sfz::FilePool::waitForStreaming() noexcept
+{
+    auto isFilled = [](const FileStream& stream) {
+        switch (stream.status.load()) {
+        case FileStream::Status::Acquired:
+        case FileStream::Status::Requested:
+            return false;
+        case FileStream::Status::Streaming: {
+            const int64_t windowSize = config::streamWindowFrames;
+            const int64_t target = min(stream.endFrame, stream.readPosition.load() + windowSize);
+            return stream.filledFrames.load() >= target;
+        }
+        default:
+            return true;
+        }
+    };
+
+    while (activeStreams.load() > 0) {
+        {
+            std::lock_guard<std::mutex> guard { streamsMutex };
+            const bool filled = std::all_of(streams.begin(), streams.end(),
+                [&](const std::unique_ptr<FileStream>& stream) { return isFilled(*stream); });
+            if (filled)
+                return;
+        }
+        triggerStreaming();
+        std::this_thread::yield();
+    }
+}
+
 void sfz::FilePool::raiseCurrentThreadPriority() noexcept
 {
 #if defined(_WIN32)
@@ -569,7 +1232,8 @@ void sfz::FilePool::setRamLoading(bool loadInRam) noexcept
         for (auto& preloadedFile : preloadedFiles) {
             fs::path file { rootDirectory / preloadedFile.first.filename() };
             AudioReaderPtr reader = createAudioReader(file, preloadedFile.first.isReverse());
-            preloadedFile.second.preloadedData = readFromFile(
+            readPreloadedData(
+                preloadedFile.second,
                 *reader,
                 preloadedFile.second.information.end
             );
@@ -579,18 +1243,65 @@ void sfz::FilePool::setRamLoading(bool loadInRam) noexcept
     }
 }
 
+void sfz::FilePool::setCompactStorage(bool compactStorage) noexcept
+{
+    if (compactStorage == this->compactStorage)
+        return;
+
+    this->compactStorage = compactStorage;
+
+    // Make sure no loading job writes the data being converted
+    waitForBackgroundLoading();
+
+    for (auto& preloadedFile : preloadedFiles) {
+        FileData& data = preloadedFile.second;
+        fs::path file { rootDirectory / preloadedFile.first.filename() };
+        AudioReaderPtr reader = createAudioReader(file, preloadedFile.first.isReverse());
+        readPreloadedData(data, *reader, static_cast<uint32_t>(data.getNumPreloadedFrames()));
+    }
+}
+
+void sfz::FilePool::setSampleSharing(bool sampleSharing) noexcept
+{
+    if (sampleSharing)
+        sampleStore = globalSampleStore();
+    else
+        sampleStore.reset();
+}
+
 void sfz::FilePool::triggerGarbageCollection() noexcept
 {
     const std::unique_lock<SpinMutex> guard { garbageAndLastUsedMutex, std::try_to_lock };
     if (!guard.owns_lock())
         return;
 
+    auto releaseFullData = [this](FileData& data) {
+        data.availableFrames = 0;
+        data.status = FileData::Status::Preloaded;
+        if (data.compact)
+            compactGarbageToCollect.push_back(std::move(data.compactFileData));
+        else
+            garbageToCollect.push_back(std::move(data.fileData));
+    };
+
+    auto garbageIsFull = [this]() {
+        return garbageToCollect.size() == garbageToCollect.capacity() ||
+            compactGarbageToCollect.size() == compactGarbageToCollect.capacity();
+    };
+
+    // The size of the full data which stays loaded is counted anew
+    size_t loadedBytes = 0;
+    evictionCandidates.clear();
+
     const auto now = std::chrono::high_resolution_clock::now();
     swapAndPopAll(lastUsedFiles, [&](const FileId& id) {
-        if (garbageToCollect.size() == garbageToCollect.capacity())
+        auto it = preloadedFiles.find(id);
+        if (it != preloadedFiles.end() && it->second.status == FileData::Status::Done)
+            loadedBytes += it->second.getNumFullDataBytes();
+
+        if (garbageIsFull())
            return false;
 
-        auto it = preloadedFiles.find(id);
         if (it == preloadedFiles.end()) {
             // Getting here means that the preloadedFiles got changed (probably cleared)
             // while the lastUsedFiles were untouched.
@@ -608,15 +1319,42 @@ void sfz::FilePool::triggerGarbageCollection() noexcept
             return false;
 
         const auto secondsIdle = std::chrono::duration_cast<std::chrono::seconds>(now - data.lastViewerLeftAt).count();
-        if (secondsIdle < config::fileClearingPeriod)
+        if (secondsIdle < config::fileClearingPeriod) {
+            if (evictionCandidates.size() < evictionCandidates.capacity())
+                evictionCandidates.push_back(&data);
             return false;
+        }
 
-        data.availableFrames = 0;
-        data.status = FileData::Status::Preloaded;
-        garbageToCollect.push_back(std::move(data.fileData));
+        loadedBytes -= data.getNumFullDataBytes();
+        releaseFullData(data);
         return true;
     });
 
+    // Release the least recently used files until the data fits in the budget;
+    // the released files leave `lastUsedFiles` on the next collection
+    const size_t budget = memoryBudget;
+    const size_t preloaded = preloadedBytes;
+    const size_t loadedBudget = (budget > preloaded) ? (budget - preloaded) : 0;
+    if (budget != 0 && loadedBytes > loadedBudget) {
+        std::sort(evictionCandidates.begin(), evictionCandidates.end(),
+            [](const FileData* lhs, const FileData* rhs) {
+                return lhs->lastViewerLeftAt < rhs->lastViewerLeftAt;
+            });
+
+        for (FileData* data : evictionCandidates) {
+            if (loadedBytes <= loadedBudget || garbageIsFull())
+                break;
+
+            const size_t numBytes = data->getNumFullDataBytes();
+            loadedBytes -= numBytes;
+            evictedBytes += numBytes;
+            numEvictions += 1;
+            releaseFullData(*data);
+        }
+    }
+
+    fullDataBytes = loadedBytes;
+
     std::error_code ec;
     semGarbageBarrier.post(ec);
     ASSERT(!ec);
@@ -31,6 +31,7 @@
 #include "AudioSpan.h"
 #include "FileId.h"
 #include "FileMetadata.h"
+#include "PreloadCache.h"
 #include "SIMDHelpers.h"
 #include "Logger.h"
 #include "SpinMutex.h"
@@ -39,18 +40,29 @@
 #include <ghc/fs_std.hpp>
 #include <absl/container/flat_hash_map.h>
 #include <absl/types/optional.h>
+#include <absl/types/span.h>
 #include <absl/strings/string_view.h>
 #include <atomic_queue/atomic_queue.h>
 #include <chrono>
 #include <thread>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 class ThreadPool;
 
 namespace sfz {
-using FileAudioBuffer = AudioBuffer<float, 2, config::defaultAlignment,
-                                    sfz::config::excessFileFrames, sfz::config::excessFileFrames>;
+class AudioReader;
+class SharedSampleStore;
+
+template <class T>
+using FileSampleBuffer = AudioBuffer<T, 2, config::defaultAlignment,
+                                     sfz::config::excessFileFrames, sfz::config::excessFileFrames>;
+using FileAudioBuffer = FileSampleBuffer<float>;
 using FileAudioBufferPtr = std::shared_ptr<FileAudioBuffer>;
+// 16-bit integer samples, for the files which are stored in their native format
+using FileCompactBuffer = FileSampleBuffer<int16_t>;
 
 struct FileInformation {
     int64_t end { Default::sampleEnd };
@@ -64,22 +76,89 @@ struct FileInformation {
     absl::optional<WavetableInfo> wavetable;
 };
 
+/**
+ * @brief The preloaded head of a sample file. It is never modified once it
+ * has been read, so that the file data of several pools can share it.
+ */
+struct FileHead
+{
+    FileInformation information;
+    FileAudioBuffer data;
+    // 16-bit samples, used instead of `data` for the files stored in their native format
+    FileCompactBuffer compactData;
+    bool compact { false };
+
+    size_t getNumFrames() const noexcept
+    {
+        return compact ? compactData.getNumFrames() : data.getNumFrames();
+    }
+    size_t getNumChannels() const noexcept
+    {
+        return compact ? compactData.getNumChannels() : data.getNumChannels();
+    }
+    /**
+     * @brief Get the memory used by the sample data, in bytes.
+     */
+    size_t getNumBytes() const noexcept
+    {
+        return getNumFrames() * getNumChannels() * (compact ? sizeof(int16_t) : sizeof(float));
+    }
+
+    LEAK_DETECTOR(FileHead);
+};
+
+using FileHeadPtr = std::shared_ptr<const FileHead>;
+
 // Strict C++11 disallows member initialization if aggregate initialization is to be used...
 struct FileData
 {
     enum class Status { Invalid, Preloaded, Streaming, Done };
     FileData() = default;
-    FileData(FileAudioBuffer preloaded, FileInformation info)
-    : preloadedData(std::move(preloaded)), information(std::move(info))
+    FileData(FileHeadPtr preloaded, FileInformation info)
+    : head(std::move(preloaded)), information(std::move(info)), compact(head->compact)
     {
 
     }
     AudioSpan<const float> getData()
     {
-        if (availableFrames > preloadedData.getNumFrames())
+        ASSERT(!compact);
+        if (availableFrames > getNumPreloadedFrames())
             return AudioSpan<const float>(fileData).first(availableFrames);
+        else if (head)
+            return AudioSpan<const float>(head->data);
         else
-            return AudioSpan<const float>(preloadedData);
+            return {};
+    }
+    /**
+     * @brief Get the data of a file stored as 16-bit samples; only valid if
+     * `compact` is set.
+     */
+    AudioSpan<const int16_t> getCompactData()
+    {
+        ASSERT(compact);
+        if (availableFrames > getNumPreloadedFrames())
+            return AudioSpan<const int16_t>(compactFileData).first(availableFrames);
+        else if (head)
+            return AudioSpan<const int16_t>(head->compactData);
+        else
+            return {};
+    }
+    /**
+     * @brief Get the number of frames of the preloaded data.
+     */
+    size_t getNumPreloadedFrames() const
+    {
+        return head ? head->getNumFrames() : 0;
+    }
+    /**
+     * @brief Get the memory used by the fully loaded data, in bytes.
+     */
+    size_t getNumFullDataBytes() const noexcept
+    {
+        if (compact)
+            return compactFileData.getNumFrames() * compactFileData.getNumChannels() * sizeof(int16_t);
+        else
+            return fileData.getNumFrames() * fileData.getNumChannels() * sizeof(float);
     }
 
     FileData(const FileData& other) = delete;
@@ -88,8 +167,10 @@ struct FileData
     {
         ASSERT(other.readerCount == 0); // Probably should not be moving this...
         information = std::move(other.information);
-        preloadedData = std::move(other.preloadedData);
+        head = std::move(other.head);
         fileData = std::move(other.fileData);
+        compactFileData = std::move(other.compactFileData);
+        compact = other.compact;
         availableFrames = other.availableFrames.load();
         lastViewerLeftAt = other.lastViewerLeftAt;
         status = other.status.load();
@@ -98,17 +179,22 @@ struct FileData
     {
         ASSERT(other.readerCount == 0); // Probably should not be moving this...
         information = std::move(other.information);
-        preloadedData = std::move(other.preloadedData);
+        head = std::move(other.head);
         fileData = std::move(other.fileData);
+        compactFileData = std::move(other.compactFileData);
+        compact = other.compact;
         availableFrames = other.availableFrames.load();
         lastViewerLeftAt = other.lastViewerLeftAt;
         status = other.status.load();
         return *this;
     }
 
-    FileAudioBuffer preloadedData;
+    FileHeadPtr head;
     FileInformation information;
     FileAudioBuffer fileData {};
+    // Either the float buffer or the compact one is in use, like in the head
+    FileCompactBuffer compactFileData {};
+    bool compact { false };
     int preloadCallCount { 0 };
     std::atomic<Status> status { Status::Invalid };
     std::atomic<size_t> availableFrames { 0 };
@@ -164,6 +250,106 @@ private:
     LEAK_DETECTOR(FileDataHolder);
 };
 
+/**
+ * @brief A fixed-size window over a sample file, which the background
+ * streaming thread keeps filled ahead of the reading position of a voice.
+ *
+ * The frames past the preloaded head of the file are stored in a ring,
+ * where the absolute frame N lives at index N modulo the window size. The
+ * memory used by a stream does not depend on the length of the file.
+ *
+ * The voice publishes how far it has read with `setReadPosition`, and the
+ * streaming thread never overwrites frames past this position. The frames
+ * are written before `filledFrames` is published, so anything below it can
+ * be read from the audio thread.
+ */
+struct FileStream
+{
+    enum class Status { Free, Acquired, Requested, Streaming, Done, Released };
+    FileStream();
+    ~FileStream();
+
+    FileStream(const FileStream& other) = delete;
+    FileStream& operator=(const FileStream& other) = delete;
+
+    /**
+     * @brief Get a contiguous view over the frames [first, first + count), with
+     * config::excessFileFrames of valid padding around for the interpolators.
+     * The frames come from the preloaded head if available, or from the ring.
+     * Frames which are out of the file or not yet streamed read as zeros.
+     *
+     * @param head the preloaded data of the file
+     * @param first the first frame
+     * @param count the number of frames, at most config::streamViewFrames
+     * @return AudioSpan<const float>
+     */
+    AudioSpan<const float> getFrames(AudioSpan<const float> head, int64_t first, size_t count) noexcept;
+    AudioSpan<const float> getFrames(AudioSpan<const int16_t> head, int64_t first, size_t count) noexcept;
+    /**
+     * @brief Notify the streaming thread that the frames before this
+     * position will not be read anymore.
+     */
+    void setReadPosition(int64_t position) noexcept;
+    /**
+     * @brief Get the total number of frames of the streamed file.
+     */
+    int64_t getNumFrames() const noexcept { return endFrame; }
+
+    FileAudioBuffer ring;
+    FileAudioBuffer view;
+    std::weak_ptr<FileId> id;
+    int64_t startFrame { 0 };
+    int64_t endFrame { 0 };
+    unsigned numChannels { 0 };
+    std::atomic<int64_t> readPosition { 0 };
+    std::atomic<int64_t> filledFrames { 0 };
+    std::atomic<Status> status { Status::Free };
+    std::unique_ptr<AudioReader> reader;
+
+private:
+    template <class T>
+    AudioSpan<const float> readFrames(AudioSpan<const T> head, int64_t first, size_t count) noexcept;
+    LEAK_DETECTOR(FileStream);
+};
+
+class FileStreamHolder {
+public:
+    FileStreamHolder() = default;
+    FileStreamHolder(const FileStreamHolder&) = delete;
+    FileStreamHolder& operator=(const FileStreamHolder&) = delete;
+    FileStreamHolder(FileStreamHolder&& other)
+    {
+        this->stream = other.stream;
+        other.stream = nullptr;
+    }
+    FileStreamHolder& operator=(FileStreamHolder&& other)
+    {
+        reset();
+        this->stream = other.stream;
+        other.stream = nullptr;
+        return *this;
+    }
+    FileStreamHolder(FileStream* stream) : stream(stream) {}
+    void reset()
+    {
+        if (!stream)
+            return;
+
+        stream->status = FileStream::Status::Released;
+        stream = nullptr;
+    }
+    ~FileStreamHolder()
+    {
+        reset();
+    }
+    FileStream& operator*() { return *stream; }
+    FileStream* operator->() { return stream; }
+    explicit operator bool() const { return stream != nullptr; }
+private:
+    FileStream* stream { nullptr };
+    LEAK_DETECTOR(FileStreamHolder);
+};
+
 /**
  * @brief This is a singleton-designed class that holds all the preloaded data
  * as well as functions to request new file data and collect the file handles to
@@ -216,6 +402,25 @@ public:
      */
     absl::optional<FileInformation> getFileInformation(const FileId& fileId) noexcept;
 
+    /**
+     * @brief Forget the file information gathered so far. The information
+     * of a file is read once and kept until this is called, which happens
+     * at the start of each instrument load.
+     */
+    void clearFileInformationCache() noexcept;
+
+    /**
+     * @brief Get the number of requests for file information which were
+     * answered from the cache.
+     */
+    size_t getFileInformationHits() const noexcept { return fileInformationHits; }
+
+    /**
+     * @brief Get the number of requests for file information which needed
+     * to open the file.
+     */
+    size_t getFileInformationMisses() const noexcept { return fileInformationMisses; }
+
     /**
      * @brief Preload a file with the proper offset bounds
      *
@@ -227,6 +432,15 @@ public:
      */
     bool preloadFile(const FileId& fileId, uint32_t maxOffset) noexcept;
 
+    /**
+     * @brief Preload several files, in parallel on the background threads.
+     * This has the same effect as calling `preloadFile` on each of them, and
+     * the files which fail to preload are skipped.
+     *
+     * @param files pairs of distinct file identifiers and maximum offsets
+     */
+    void preloadFiles(absl::Span<const std::pair<FileId, uint32_t>> files) noexcept;
+
     /**
      * @brief Load a file and return its information. The file pool will store this
      * data for future requests so use this function responsibly.
@@ -254,6 +468,24 @@ public:
      */
     bool checkSampleId(FileId& fileId) const noexcept;
 
+    /**
+     * @brief Forget the directory listings used to resolve the sample paths
+     * in a case insensitive way. A directory is listed at most once until this
+     * is called, which happens at the start of each instrument load.
+     */
+    void clearDirectoryCache() noexcept;
+
+    /**
+     * @brief Check that several samples exist and get their information, in
+     * parallel on the background threads. This has the same effect as calling
+     * `checkSampleId` and then `getFileInformation` on each of them.
+     *
+     * @param fileIds the sample file identifiers; may be updated by the method
+     * @return the information for each file, or nothing if the file was not
+     *         found or could not be read
+     */
+    std::vector<absl::optional<FileInformation>> checkAndGetFileInformation(absl::Span<FileId> fileIds) noexcept;
+
     /**
      * @brief Clear all preloaded files.
      *
@@ -306,6 +538,11 @@ public:
      * in the queue.
      */
     void waitForBackgroundLoading() noexcept;
+    /**
+     * @brief Wait for the streaming thread to fill the window of every active
+     * stream ahead of its read position, or up to the end of the file.
+     */
+    void waitForStreaming() noexcept;
     /**
      * @brief Assign the current thread a priority which is appropriate
      * for background sample file processing.
@@ -318,24 +555,169 @@ public:
      * @param loadInRam
      */
     void setRamLoading(bool loadInRam) noexcept;
+    /**
+     * @brief Change whether the 16-bit sample files are kept in memory in
+     * their native format, which halves their footprint compared to floats.
+     * This will trigger a reloading of the preloaded data.
+     *
+     * @param compactStorage
+     */
+    void setCompactStorage(bool compactStorage) noexcept;
+    /**
+     * @brief Get whether the 16-bit sample files are kept in their native format.
+     */
+    bool getCompactStorage() const noexcept { return compactStorage; }
+
+    /**
+     * @brief Set the directory of the persistent preload cache. The file
+     * information and the preloaded data are then reused across runs for the
+     * samples which are unchanged. An empty path disables the cache.
+     *
+     * @param directory
+     */
+    void setPreloadCacheDirectory(const fs::path& directory) { preloadCache.setDirectory(directory); }
+    /**
+     * @brief Get the directory of the persistent preload cache, empty if it is disabled.
+     */
+    const fs::path& getPreloadCacheDirectory() const noexcept { return preloadCache.getDirectory(); }
+
+    /**
+     * @brief Change whether the preloaded data is shared with the other file
+     * pools of the process which enable sharing. The pools then use the same
+     * buffers for the same sample files, as long as these are unchanged on
+     * disk. This applies to the files preloaded afterwards.
+     *
+     * @param sampleSharing
+     */
+    void setSampleSharing(bool sampleSharing) noexcept;
+    /**
+     * @brief Get whether the preloaded data is shared with the other file pools.
+     */
+    bool getSampleSharing() const noexcept { return sampleStore != nullptr; }
+
+    /**
+     * @brief Set the memory budget of the samples, in bytes, or 0 for no
+     * budget. When the sample data goes over the budget, the garbage
+     * collection releases the fully loaded files which are not being read,
+     * the least recently used first, without waiting for the clearing period.
+     * The preloaded data counts against the budget but is never released.
+     *
+     * @param numBytes
+     */
+    void setMemoryBudget(size_t numBytes) noexcept { memoryBudget = numBytes; }
+    /**
+     * @brief Get the memory budget of the samples, in bytes, 0 if there is none.
+     */
+    size_t getMemoryBudget() const noexcept { return memoryBudget; }
+    /**
+     * @brief Get the memory used by the sample data, in bytes, which is the
+     * size of the preloaded data and the fully loaded files.
+     */
+    size_t getMemoryUsage() const noexcept { return preloadedBytes + fullDataBytes; }
+    /**
+     * @brief Check whether the sample data uses more memory than the budget.
+     */
+    bool isOverMemoryBudget() const noexcept
+    {
+        const size_t budget = memoryBudget;
+        return budget != 0 && getMemoryUsage() > budget;
+    }
+    /**
+     * @brief Get the number of fully loaded files released to fit in the
+     * memory budget.
+     */
+    size_t getNumEvictions() const noexcept { return numEvictions; }
+    /**
+     * @brief Get the memory released to fit in the memory budget, in bytes.
+     */
+    size_t getEvictedBytes() const noexcept { return evictedBytes; }
     /**
      * @brief Prepares unused data to be freed on a background thread.
      * This should be called regularly by the Synth, otherwise memory
-     * risk building up.
+     * risk building up, and more often when over the memory budget.
      */
     void triggerGarbageCollection() noexcept;
+    /**
+     * @brief Change whether the samples which are not looped get streamed
+     * from the disk through a fixed-size window per voice, instead of being
+     * loaded entirely in memory. Don't call this while voices are playing.
+     *
+     * @param diskStreaming
+     */
+    void setDiskStreaming(bool diskStreaming) noexcept;
+    /**
+     * @brief Get whether disk streaming is enabled.
+     */
+    bool getDiskStreaming() const noexcept { return diskStreaming; }
+    /**
+     * @brief Set the number of streams, usually one per voice. The memory
+     * is only allocated when disk streaming is enabled. Don't call this
+     * while voices are playing.
+     *
+     * @param numStreams
+     */
+    void setNumStreams(size_t numStreams);
+    /**
+     * @brief Get a handle on the head of a file, and a stream for the rest
+     * of it. This does not allocate nor block and may be called on the audio thread.
+     *
+     * The stream holder is left empty if streaming is disabled, if there is
+     * no free stream, or if the file is entirely preloaded; the caller should
+     * use `getFilePromise` in this case.
+     *
+     * @param fileId the file to stream
+     * @param stream the stream holder to fill
+     * @return FileDataHolder a handle on the preloaded data
+     */
+    FileDataHolder getFileStream(const std::shared_ptr<FileId>& fileId, FileStreamHolder& stream) noexcept;
+    /**
+     * @brief Wake up the streaming thread so that it refills the active
+     * streams. This should be called regularly by the Synth.
+     */
+    void triggerStreaming() noexcept;
 private:
     Logger& logger;
     fs::path rootDirectory;
 
     bool loadInRam { config::loadInRam };
     uint32_t preloadSize { config::preloadSize };
+    bool diskStreaming { config::diskStreaming };
+    bool compactStorage { config::compactSampleStorage };
+    PreloadCache preloadCache;
+    std::shared_ptr<SharedSampleStore> sampleStore;
+
+    // Memory accounting, in bytes
+    std::atomic<size_t> memoryBudget { config::sampleMemoryBudget };
+    std::atomic<size_t> preloadedBytes { 0 };
+    std::atomic<size_t> fullDataBytes { 0 };
+    std::atomic<size_t> numEvictions { 0 };
+    std::atomic<size_t> evictedBytes { 0 };
+
+    // File information, gathered once per load
+    std::mutex fileInformationMutex;
+    absl::flat_hash_map<FileId, absl::optional<FileInformation>> fileInformationCache;
+    std::atomic<size_t> fileInformationHits { 0 };
+    std::atomic<size_t> fileInformationMisses { 0 };
+
+    // Directory listings for case insensitive lookups, lower-cased name to real name
+    using DirectoryListing = absl::flat_hash_map<std::string, std::string>;
+    mutable std::mutex directoryCacheMutex;
+    mutable absl::flat_hash_map<std::string, DirectoryListing> directoryCache;
+
+    absl::optional<FileInformation> readFileInformation(const FileId& fileId) const noexcept;
+    bool findInDirectory(const fs::path& directory, const fs::path& name, std::string& realName) const;
+    FileHeadPtr readHead(AudioReader& reader, const FileInformation& information, uint32_t numFrames) const;
+    void setHead(FileData& data, FileHeadPtr head);
+    void readPreloadedData(FileData& data, AudioReader& reader, uint32_t numFrames);
+    bool preloadFileData(FileData& data, const FileId& fileId, uint32_t maxOffset) noexcept;
 
     // Signals
     volatile bool dispatchFlag { true };
     volatile bool garbageFlag { true };
+    volatile bool streamFlag { true };
     RTSemaphore dispatchBarrier;
     RTSemaphore semGarbageBarrier;
+    RTSemaphore streamBarrier;
 
     // Structures for the background loaders
     struct QueuedFileData
@@ -360,9 +742,20 @@ private:
     std::thread dispatchThread { &FilePool::dispatchingJob, this };
     std::thread garbageThread { &FilePool::garbageJob, this };
 
+    // Disk streams
+    void streamingJob() noexcept;
+    void fillStream(FileStream& stream, absl::Span<float> fileBlock) noexcept;
+    std::mutex streamsMutex;
+    size_t numStreams { 0 };
+    std::vector<std::unique_ptr<FileStream>> streams;
+    std::atomic<int> activeStreams { 0 };
+    std::thread streamThread { &FilePool::streamingJob, this };
+
     SpinMutex garbageAndLastUsedMutex;
     std::vector<FileId> lastUsedFiles;
     std::vector<FileAudioBuffer> garbageToCollect;
+    std::vector<FileCompactBuffer> compactGarbageToCollect;
+    std::vector<FileData*> evictionCandidates;
 
     std::shared_ptr<ThreadPool> threadPool;
 
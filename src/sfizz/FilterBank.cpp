@@ -0,0 +1,458 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "FilterBank.h"
+#include "MathHelpers.h"
+#include "SIMDHelpers.h"
+#include "utility/Debug.h"
+#include <simde/simde-features.h>
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+#include <simde/x86/sse.h>
+#endif
+#include <algorithm>
+#include <cmath>
+
+namespace sfz {
+
+namespace {
+
+constexpr unsigned numCoeffs = 5;
+constexpr unsigned lanesPerVector = 4;
+
+// the limits of the Faust filters
+constexpr float minCutoff = 1.0f;
+constexpr float maxCutoff = 20000.0f;
+constexpr float minResonance = -60.0f;
+constexpr float maxResonance = 60.0f;
+
+// the cutoff tables go from 1 Hz to 32768 Hz, past the highest cutoff
+constexpr unsigned cutoffTableOctaves = 15;
+constexpr unsigned cutoffTableSize = cutoffTableOctaves * config::filterCutoffTableSteps + 1;
+constexpr unsigned resonanceTableSize = static_cast<unsigned>(maxResonance - minResonance) * config::filterResonanceTableSteps + 1;
+// 1 / 2Q decreases exponentially with the resonance, so that its derivative
+// over a step of the table is proportional to itself, by this factor
+constexpr float resonanceStep = -0.05f * 2.302585093f / config::filterResonanceTableSteps;
+
+/**
+ * Cubic Hermite interpolation of a function within a step of its table, from
+ * its values and derivatives at both ends, the derivatives scaled to the step.
+ */
+struct Hermite {
+    explicit Hermite(float mu)
+        : h00((1.0f + 2.0f * mu) * (1.0f - mu) * (1.0f - mu))
+        , h10(mu * (1.0f - mu) * (1.0f - mu))
+        , h01(mu * mu * (3.0f - 2.0f * mu))
+        , h11(mu * mu * (mu - 1.0f))
+    {
+    }
+
+    float operator()(float y0, float y1, float d0, float d1) const
+    {
+        return h00 * y0 + h10 * d0 + h01 * y1 + h11 * d1;
+    }
+
+    float h00;
+    float h10;
+    float h01;
+    float h11;
+};
+
+double computeOmega(double cutoff, double sampleRate)
+{
+    return (twoPi<double>() / sampleRate) * cutoff;
+}
+
+double computeHalfInverseQ(double resonance)
+{
+    return 0.5 / std::max(0.001, std::pow(10.0, 0.05 * resonance));
+}
+
+/**
+ * Compute the coefficients b0, b1, b2, a1, a2 of a filter, normalized by a0,
+ * with the same formulas as the Faust filters, from sin(w0), 1 - cos(w0) and
+ * 1 / 2Q.
+ */
+void computeBiquadCoefficients(FilterType type, double sinw0, double versw0, double halfInvQ, double* coeffs)
+{
+    const double cosw0 = 1.0 - versw0;
+    const double alpha = sinw0 * halfInvQ;
+    const double invA0 = 1.0 / (1.0 + alpha);
+
+    switch (type) {
+    case kFilterLpf2p:
+        coeffs[0] = 0.5 * versw0 * invA0;
+        coeffs[1] = versw0 * invA0;
+        coeffs[2] = coeffs[0];
+        break;
+    case kFilterHpf2p:
+        coeffs[0] = 0.5 * (1.0 + cosw0) * invA0;
+        coeffs[1] = (-1.0 - cosw0) * invA0;
+        coeffs[2] = coeffs[0];
+        break;
+    case kFilterBpf2p:
+        coeffs[0] = alpha * invA0;
+        coeffs[1] = 0.0;
+        coeffs[2] = -coeffs[0];
+        break;
+    case kFilterBrf2p:
+        coeffs[0] = invA0;
+        coeffs[1] = -2.0 * cosw0 * invA0;
+        coeffs[2] = coeffs[0];
+        break;
+    default:
+        ASSERTFALSE;
+        coeffs[0] = 1.0;
+        coeffs[1] = 0.0;
+        coeffs[2] = 0.0;
+        break;
+    }
+
+    coeffs[3] = -2.0 * cosw0 * invA0;
+    coeffs[4] = (1.0 - alpha) * invA0;
+}
+
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+/**
+ * The biquads of 4 lanes, in the transposed form of the Faust filters, with
+ * each coefficient smoothed by a one-pole lowpass.
+ */
+struct BiquadX4 {
+    simde__m128 coeffs[numCoeffs];
+    simde__m128 u; // b1.x[n-1]
+    simde__m128 w; // b2.x[n-1]
+    simde__m128 s; // b2.x[n-2] - a2.y[n-2]
+    simde__m128 y; // y[n-1]
+
+    inline simde__m128 tick(simde__m128 x, simde__m128 pole, const simde__m128* targets)
+    {
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            coeffs[c] = simde_mm_add_ps(simde_mm_mul_ps(pole, coeffs[c]), targets[c]);
+
+        const simde__m128 out = simde_mm_sub_ps(
+            simde_mm_add_ps(u, simde_mm_add_ps(simde_mm_mul_ps(coeffs[0], x), s)),
+            simde_mm_mul_ps(coeffs[3], y));
+        s = simde_mm_sub_ps(w, simde_mm_mul_ps(coeffs[4], y));
+        u = simde_mm_mul_ps(coeffs[1], x);
+        w = simde_mm_mul_ps(coeffs[2], x);
+        y = out;
+        return out;
+    }
+};
+#else
+/**
+ * The biquad of a lane, in the transposed form of the Faust filters, with
+ * each coefficient smoothed by a one-pole lowpass.
+ */
+struct Biquad {
+    float coeffs[numCoeffs];
+    float u; // b1.x[n-1]
+    float w; // b2.x[n-1]
+    float s; // b2.x[n-2] - a2.y[n-2]
+    float y; // y[n-1]
+
+    inline float tick(float x, float pole, const float* targets, unsigned targetStride)
+    {
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            coeffs[c] = pole * coeffs[c] + targets[c * targetStride];
+
+        const float out = (u + (coeffs[0] * x + s)) - coeffs[3] * y;
+        s = w - coeffs[4] * y;
+        u = coeffs[1] * x;
+        w = coeffs[2] * x;
+        y = out;
+        return out;
+    }
+};
+#endif
+
+} // namespace
+
+FilterBank::FilterBank()
+{
+    setSampleRate(config::defaultSampleRate);
+    setSamplesPerBlock(config::defaultSamplesPerBlock);
+}
+
+bool FilterBank::supports(FilterType type) noexcept
+{
+    switch (type) {
+    case kFilterLpf2p:
+    case kFilterHpf2p:
+    case kFilterBpf2p:
+    case kFilterBrf2p:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void FilterBank::setSampleRate(float sampleRate)
+{
+    // like the Faust filters, which are initialized with an integral rate
+    sampleRate_ = static_cast<double>(static_cast<int>(sampleRate));
+    pole_ = static_cast<float>(std::exp(-1000.0 / sampleRate_));
+
+    const unsigned steps = config::filterCutoffTableSteps;
+    omegaStep_ = static_cast<float>(computeOmega(1.0 / steps, sampleRate_));
+    cutoffTable_.resize(2 * cutoffTableSize);
+    for (unsigned i = 0; i < cutoffTableSize; ++i) {
+        const double cutoff = std::ldexp(1.0 + double(i % steps) / steps, int(i / steps));
+        const double w0 = computeOmega(cutoff, sampleRate_);
+        cutoffTable_[2 * i] = static_cast<float>(std::sin(w0));
+        cutoffTable_[2 * i + 1] = static_cast<float>(1.0 - std::cos(w0));
+    }
+
+    resonanceTable_.resize(resonanceTableSize);
+    for (unsigned i = 0; i < resonanceTableSize; ++i) {
+        const double resonance = minResonance + double(i) / config::filterResonanceTableSteps;
+        resonanceTable_[i] = static_cast<float>(computeHalfInverseQ(resonance));
+    }
+}
+
+void FilterBank::computeCoefficients(FilterType type, float cutoff, float resonance, double* coeffs) const noexcept
+{
+    cutoff = clamp(cutoff, minCutoff, maxCutoff);
+    resonance = clamp(resonance, minResonance, maxResonance);
+
+    if (!tabulated_) {
+        const double w0 = computeOmega(cutoff, sampleRate_);
+        computeBiquadCoefficients(
+            type, std::sin(w0), 1.0 - std::cos(w0), computeHalfInverseQ(resonance), coeffs);
+        return;
+    }
+
+    // The octave and the position within it come from the exponent and the
+    // mantissa, which spares computing a logarithm.
+    const int octave = fp_exponent(cutoff);
+    const float cutoffPosition = (octave + static_cast<float>(fp_mantissa(cutoff))) * config::filterCutoffTableSteps;
+    const unsigned cutoffIndex = static_cast<unsigned>(cutoffPosition);
+    ASSERT(cutoffIndex + 1 < cutoffTableSize);
+    const float* sinw0 = cutoffTable_.data() + 2 * cutoffIndex;
+    const float* versw0 = sinw0 + 1;
+    // the increase of w0 over the step, which scales the derivatives
+    const float omegaStep = omegaStep_ * fp_from_parts<float>(false, octave, 0);
+    const Hermite cutoffCurve { cutoffPosition - cutoffIndex };
+
+    const float resonancePosition = (resonance - minResonance) * config::filterResonanceTableSteps;
+    const unsigned resonanceIndex = std::min(static_cast<unsigned>(resonancePosition), resonanceTableSize - 2);
+    const float* halfInvQ = resonanceTable_.data() + resonanceIndex;
+    const Hermite resonanceCurve { resonancePosition - resonanceIndex };
+
+    computeBiquadCoefficients(type,
+        cutoffCurve(sinw0[0], sinw0[2], omegaStep * (1.0f - versw0[0]), omegaStep * (1.0f - versw0[2])),
+        cutoffCurve(versw0[0], versw0[2], omegaStep * sinw0[0], omegaStep * sinw0[2]),
+        resonanceCurve(halfInvQ[0], halfInvQ[1], resonanceStep * halfInvQ[0], resonanceStep * halfInvQ[1]),
+        coeffs);
+}
+
+void FilterBank::setSamplesPerBlock(int samplesPerBlock)
+{
+    ASSERT(numLanes_ == 0);
+    const unsigned interval = config::filterControlInterval;
+    const unsigned numIntervals = (static_cast<unsigned>(samplesPerBlock) + interval - 1) / interval;
+    targets_.resize(numIntervals * numCoeffs * maxLanes);
+    fill<float>(absl::MakeSpan(targets_), 0.0f);
+    silence_.resize(static_cast<size_t>(samplesPerBlock));
+    fill<float>(absl::MakeSpan(silence_), 0.0f);
+}
+
+bool FilterBank::add(
+    FilterBankState& state, FilterType type, float* const channels[], unsigned numChannels,
+    const float* cutoff, const float* resonance, unsigned numFrames, bool reset) noexcept
+{
+    ASSERT(supports(type));
+    ASSERT(numChannels == 1 || numChannels == 2);
+    ASSERT(numFrames <= silence_.size());
+    ASSERT(numLanes_ == 0 || numFrames == numFrames_);
+
+    if (numLanes_ + numChannels > maxLanes)
+        return false;
+
+    const unsigned interval = config::filterControlInterval;
+    const double gain = 1.0 - static_cast<double>(pole_);
+
+    for (unsigned frame = 0, k = 0; frame < numFrames; frame += interval, ++k) {
+        double coeffs[numCoeffs];
+        computeCoefficients(type, cutoff[frame], resonance[frame], coeffs);
+
+        if (reset && frame == 0) {
+            state = FilterBankState();
+            for (unsigned c = 0; c < numCoeffs; ++c)
+                state.coeffs[c] = static_cast<float>(coeffs[c]);
+        }
+
+        float* targets = &targets_[k * numCoeffs * maxLanes];
+        for (unsigned c = 0; c < numCoeffs; ++c) {
+            for (unsigned ch = 0; ch < numChannels; ++ch)
+                targets[c * maxLanes + numLanes_ + ch] = static_cast<float>(gain * coeffs[c]);
+        }
+    }
+
+    for (unsigned ch = 0; ch < numChannels; ++ch) {
+        Lane& lane = lanes_[numLanes_++];
+        lane.data = channels[ch];
+        lane.state = &state;
+        lane.channel = ch;
+        std::copy(state.coeffs, state.coeffs + numCoeffs, lane.coeffs);
+    }
+
+    numFrames_ = numFrames;
+    return true;
+}
+
+void FilterBank::clear() noexcept
+{
+    numLanes_ = 0;
+    numFrames_ = 0;
+}
+
+void FilterBank::process() noexcept
+{
+    const unsigned numLanes = numLanes_;
+    const unsigned numFrames = numFrames_;
+    const unsigned interval = config::filterControlInterval;
+
+    if (numLanes == 0 || numFrames == 0) {
+        clear();
+        return;
+    }
+
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+    // The lanes which complete the last vector filter the silent channel
+    // from a zero state, which keeps it silent whatever their coefficients.
+    constexpr unsigned maxVectors = maxLanes / lanesPerVector;
+    const unsigned numVectorLanes = (numLanes + lanesPerVector - 1) / lanesPerVector * lanesPerVector;
+    const unsigned numVectors = numVectorLanes / lanesPerVector;
+
+    // gather the state of the lanes
+    alignas(16) float coeffs[numCoeffs][maxLanes] {};
+    alignas(16) float memory[4][maxLanes] {};
+    float* data[maxLanes];
+
+    for (unsigned l = 0; l < numVectorLanes; ++l) {
+        if (l < numLanes) {
+            const Lane& lane = lanes_[l];
+            data[l] = lane.data;
+            for (unsigned c = 0; c < numCoeffs; ++c)
+                coeffs[c][l] = lane.coeffs[c];
+            for (unsigned m = 0; m < 4; ++m)
+                memory[m][l] = lane.state->memory[lane.channel][m];
+        }
+        else
+            data[l] = silence_.data();
+    }
+
+    BiquadX4 filters[maxVectors];
+    for (unsigned v = 0; v < numVectors; ++v) {
+        const unsigned first = v * lanesPerVector;
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            filters[v].coeffs[c] = simde_mm_load_ps(&coeffs[c][first]);
+        filters[v].u = simde_mm_load_ps(&memory[0][first]);
+        filters[v].w = simde_mm_load_ps(&memory[1][first]);
+        filters[v].s = simde_mm_load_ps(&memory[2][first]);
+        filters[v].y = simde_mm_load_ps(&memory[3][first]);
+    }
+
+    const simde__m128 pole = simde_mm_set1_ps(pole_);
+    alignas(16) float y[lanesPerVector];
+
+    for (unsigned frame = 0, k = 0; frame < numFrames; ++k) {
+        const unsigned end = std::min(frame + interval, numFrames);
+
+        simde__m128 targets[maxVectors][numCoeffs];
+        for (unsigned v = 0; v < numVectors; ++v) {
+            for (unsigned c = 0; c < numCoeffs; ++c)
+                targets[v][c] = simde_mm_loadu_ps(&targets_[(k * numCoeffs + c) * maxLanes + v * lanesPerVector]);
+        }
+
+        // the vectors are advanced together, so their recursions overlap
+        unsigned i = frame;
+        for (; i + 4 <= end; i += 4) {
+            for (unsigned v = 0; v < numVectors; ++v) {
+                BiquadX4& f = filters[v];
+                float* const* d = &data[v * lanesPerVector];
+                // transpose 4 frames of the lanes, to get a vector per frame
+                simde__m128 x0 = simde_mm_loadu_ps(d[0] + i);
+                simde__m128 x1 = simde_mm_loadu_ps(d[1] + i);
+                simde__m128 x2 = simde_mm_loadu_ps(d[2] + i);
+                simde__m128 x3 = simde_mm_loadu_ps(d[3] + i);
+                SIMDE_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+                x0 = f.tick(x0, pole, targets[v]);
+                x1 = f.tick(x1, pole, targets[v]);
+                x2 = f.tick(x2, pole, targets[v]);
+                x3 = f.tick(x3, pole, targets[v]);
+                SIMDE_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+                simde_mm_storeu_ps(d[0] + i, x0);
+                simde_mm_storeu_ps(d[1] + i, x1);
+                simde_mm_storeu_ps(d[2] + i, x2);
+                simde_mm_storeu_ps(d[3] + i, x3);
+            }
+        }
+        for (; i < end; ++i) {
+            for (unsigned v = 0; v < numVectors; ++v) {
+                float* const* d = &data[v * lanesPerVector];
+                const simde__m128 x = simde_mm_setr_ps(d[0][i], d[1][i], d[2][i], d[3][i]);
+                simde_mm_store_ps(y, filters[v].tick(x, pole, targets[v]));
+                for (unsigned l = 0; l < lanesPerVector; ++l)
+                    d[l][i] = y[l];
+            }
+        }
+
+        frame = end;
+    }
+
+    // scatter the state back
+    for (unsigned v = 0; v < numVectors; ++v) {
+        const unsigned first = v * lanesPerVector;
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            simde_mm_store_ps(&coeffs[c][first], filters[v].coeffs[c]);
+        simde_mm_store_ps(&memory[0][first], filters[v].u);
+        simde_mm_store_ps(&memory[1][first], filters[v].w);
+        simde_mm_store_ps(&memory[2][first], filters[v].s);
+        simde_mm_store_ps(&memory[3][first], filters[v].y);
+    }
+
+    for (unsigned l = 0; l < numLanes; ++l) {
+        const Lane& lane = lanes_[l];
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            lane.state->coeffs[c] = coeffs[c][l];
+        for (unsigned m = 0; m < 4; ++m)
+            lane.state->memory[lane.channel][m] = memory[m][l];
+    }
+#else
+    for (unsigned l = 0; l < numLanes; ++l) {
+        const Lane& lane = lanes_[l];
+        float* data = lane.data;
+
+        Biquad f;
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            f.coeffs[c] = lane.coeffs[c];
+        f.u = lane.state->memory[lane.channel][0];
+        f.w = lane.state->memory[lane.channel][1];
+        f.s = lane.state->memory[lane.channel][2];
+        f.y = lane.state->memory[lane.channel][3];
+
+        for (unsigned frame = 0, k = 0; frame < numFrames; ++k) {
+            const unsigned end = std::min(frame + interval, numFrames);
+            const float* targets = &targets_[k * numCoeffs * maxLanes + l];
+            for (unsigned i = frame; i < end; ++i)
+                data[i] = f.tick(data[i], pole_, targets, maxLanes);
+            frame = end;
+        }
+
+        for (unsigned c = 0; c < numCoeffs; ++c)
+            lane.state->coeffs[c] = f.coeffs[c];
+        lane.state->memory[lane.channel][0] = f.u;
+        lane.state->memory[lane.channel][1] = f.w;
+        lane.state->memory[lane.channel][2] = f.s;
+        lane.state->memory[lane.channel][3] = f.y;
+    }
+#endif
+
+    clear();
+}
+
+} // namespace sfz
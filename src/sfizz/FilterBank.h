@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "SfzFilter.h"
+#include "Config.h"
+#include "Buffer.h"
+#include <array>
+
+namespace sfz {
+
+/**
+ * @brief The state of a filter which is processed by a filter bank, for up
+ * to 2 channels. It belongs to the filter and persists across the blocks,
+ * while the lanes of the bank are assigned anew in every block.
+ */
+struct FilterBankState {
+    float coeffs[5] {}; // smoothed b0, b1, b2, a1, a2, shared by the channels
+    float memory[2][4] {}; // per channel: b1.x[n-1], b2.x[n-1], s[n-1], y[n-1]
+};
+
+/**
+ * @brief Process the 2-pole RBJ filters (lpf_2p, hpf_2p, bpf_2p, brf_2p) of
+ * several voices together, with one channel of a voice per vector lane.
+ *
+ * The filters are queued with `add`, which computes the coefficients of each
+ * control interval of the block, and all of them run at once in `process`.
+ * The state of the lanes is kept as a structure of arrays during the block,
+ * and it is gathered from and scattered back to the states of the filters.
+ * The output matches the Faust implementation of these types in `Filter`,
+ * computed in single precision.
+ *
+ * By default, the coefficients are interpolated from tables of the functions
+ * of the cutoff and the resonance, which are built for the sample rate, so
+ * that no transcendental function is evaluated when the filters are queued.
+ */
+class FilterBank {
+public:
+    static constexpr unsigned maxLanes = 2 * config::filterBankVoices;
+
+    FilterBank();
+    /**
+     * @brief Check whether the bank is able to process a type of filter.
+     */
+    static bool supports(FilterType type) noexcept;
+    void setSampleRate(float sampleRate);
+    /**
+     * @brief Set the maximum size of the blocks. No filter may be queued.
+     */
+    void setSamplesPerBlock(int samplesPerBlock);
+    /**
+     * @brief Choose whether to interpolate the coefficients from the tables,
+     * or to compute them exactly.
+     */
+    void setTabulated(bool tabulated) noexcept { tabulated_ = tabulated; }
+    bool isTabulated() const noexcept { return tabulated_; }
+    /**
+     * @brief Queue a filter to process in place over a block.
+     *
+     * @param state the state of the filter
+     * @param type the type of the filter, which the bank supports
+     * @param channels the channels to filter in place
+     * @param numChannels the number of channels, 1 or 2
+     * @param cutoff the cutoff frequencies in Hz, for each frame
+     * @param resonance the resonances in dB, for each frame
+     * @param numFrames the size of the block, the same for all queued filters
+     * @param reset whether to reset the state of the filter, with its
+     *              coefficients set without smoothing
+     * @return false if there are not enough free lanes for the channels
+     */
+    bool add(
+        FilterBankState& state, FilterType type, float* const channels[], unsigned numChannels,
+        const float* cutoff, const float* resonance, unsigned numFrames, bool reset) noexcept;
+    /**
+     * @brief Process the queued filters, and empty the bank.
+     */
+    void process() noexcept;
+    /**
+     * @brief Empty the bank without processing the queued filters.
+     */
+    void clear() noexcept;
+    /**
+     * @brief Get the number of channels queued in the bank.
+     */
+    unsigned getNumLanes() const noexcept { return numLanes_; }
+
+private:
+    struct Lane {
+        float* data { nullptr };
+        FilterBankState* state { nullptr };
+        unsigned channel { 0 };
+        // the coefficients when queued, since the lanes of a filter may be
+        // processed separately and write them back one after the other
+        float coeffs[5] {};
+    };
+
+    void computeCoefficients(FilterType type, float cutoff, float resonance, double* coeffs) const noexcept;
+
+    double sampleRate_ { config::defaultSampleRate };
+    float pole_ { 0.0f };
+    bool tabulated_ { true };
+    // the increase of w0 over a step of the cutoff table, in the first octave
+    float omegaStep_ { 0.0f };
+    // sin(w0) and 1 - cos(w0) by pairs, at cutoffs which divide each octave
+    // into equal steps, from 1 Hz upwards
+    Buffer<float> cutoffTable_;
+    // 1 / 2Q, at resonances in equal steps from -60 dB upwards
+    Buffer<float> resonanceTable_;
+    unsigned numFrames_ { 0 };
+    unsigned numLanes_ { 0 };
+    std::array<Lane, maxLanes> lanes_;
+    // targets of the smoothed coefficients, scaled by the complement of the
+    // pole, indexed as [interval][coefficient][lane]
+    Buffer<float> targets_;
+    // the channel of the unused lanes, kept silent
+    Buffer<float> silence_;
+};
+
+} // namespace sfz
@@ -61,7 +61,7 @@ void sfz::FilterHolder::setup(const Region& region, unsigned filterId, int noteN
     prepared = false;
 }
 
-void sfz::FilterHolder::process(const float** inputs, float** outputs, unsigned numFrames)
+void sfz::FilterHolder::process(const float** inputs, float** outputs, unsigned numFrames, unsigned slot)
 {
     if (numFrames == 0)
         return;
@@ -72,8 +72,20 @@ void sfz::FilterHolder::process(const float** inputs, float** outputs, unsigned
         return;
     }
 
-    ModMatrix& mm = resources.getModMatrix();
-    BufferPool& bufferPool = resources.getBufferPool();
+    if (FilterBank::supports(description->type)) {
+        // filter in place, as a bank of a single filter
+        for (unsigned channelIdx = 0; channelIdx < filter->channels(); channelIdx++) {
+            if (inputs[channelIdx] != outputs[channelIdx])
+                copy<float>({ inputs[channelIdx], numFrames }, { outputs[channelIdx], numFrames });
+        }
+
+        FilterBank& bank = resources.getFilterBank(slot);
+        queue(bank, outputs, numFrames, slot);
+        bank.process();
+        return;
+    }
+
+    BufferPool& bufferPool = resources.getBufferPool(slot);
     auto cutoffSpan = bufferPool.getBuffer(numFrames);
     auto resonanceSpan = bufferPool.getBuffer(numFrames);
     auto gainSpan = bufferPool.getBuffer(numFrames);
@@ -81,20 +93,9 @@ void sfz::FilterHolder::process(const float** inputs, float** outputs, unsigned
     if (!cutoffSpan || !resonanceSpan || !gainSpan)
         return;
 
-    fill<float>(*cutoffSpan, baseCutoff);
-    if (float* mod = mm.getModulation(cutoffTarget)) {
-        for (size_t i = 0; i < numFrames; ++i)
-            (*cutoffSpan)[i] *= centsFactor(mod[i]);
-    }
-    sfz::clampAll(*cutoffSpan, Default::filterCutoff.bounds);
-
-    fill<float>(*resonanceSpan, baseResonance);
-    if (float* mod = mm.getModulation(resonanceTarget))
-        add<float>(absl::Span<float>(mod, numFrames), *resonanceSpan);
-
-    fill<float>(*gainSpan, baseGain);
-    if (float* mod = mm.getModulation(gainTarget))
-        add<float>(absl::Span<float>(mod, numFrames), *gainSpan);
+    computeCutoff(*cutoffSpan, slot);
+    computeResonance(*resonanceSpan, slot);
+    computeGain(*gainSpan, slot);
 
     if (!prepared) {
         filter->prepare(cutoffSpan->front(), resonanceSpan->front(), gainSpan->front());
@@ -111,6 +112,59 @@ void sfz::FilterHolder::process(const float** inputs, float** outputs, unsigned
     );
 }
 
+bool sfz::FilterHolder::queue(FilterBank& bank, float* const channels[], unsigned numFrames, unsigned slot)
+{
+    if (description == nullptr || !FilterBank::supports(description->type))
+        return false;
+
+    if (numFrames == 0)
+        return true;
+
+    BufferPool& bufferPool = resources.getBufferPool(slot);
+    auto cutoffSpan = bufferPool.getBuffer(numFrames);
+    auto resonanceSpan = bufferPool.getBuffer(numFrames);
+
+    // leave the block unfiltered, like `process`
+    if (!cutoffSpan || !resonanceSpan)
+        return true;
+
+    computeCutoff(*cutoffSpan, slot);
+    computeResonance(*resonanceSpan, slot);
+
+    if (!bank.add(bankState, description->type, channels, filter->channels(),
+            cutoffSpan->data(), resonanceSpan->data(), numFrames, !prepared))
+        return false;
+
+    prepared = true;
+    return true;
+}
+
+void sfz::FilterHolder::computeCutoff(absl::Span<float> cutoff, unsigned slot)
+{
+    ModMatrix& mm = resources.getModMatrix();
+    fill<float>(cutoff, baseCutoff);
+    if (float* mod = mm.getModulation(cutoffTarget, slot)) {
+        for (size_t i = 0; i < cutoff.size(); ++i)
+            cutoff[i] *= centsFactor(mod[i]);
+    }
+    sfz::clampAll(cutoff, Default::filterCutoff.bounds);
+}
+
+void sfz::FilterHolder::computeResonance(absl::Span<float> resonance, unsigned slot)
+{
+    ModMatrix& mm = resources.getModMatrix();
+    fill<float>(resonance, baseResonance);
+    if (float* mod = mm.getModulation(resonanceTarget, slot))
+        add<float>(absl::Span<float>(mod, resonance.size()), resonance);
+}
+
+void sfz::FilterHolder::computeGain(absl::Span<float> gain, unsigned slot)
+{
+    ModMatrix& mm = resources.getModMatrix();
+    fill<float>(gain, baseGain);
+    if (float* mod = mm.getModulation(gainTarget, slot))
+        add<float>(absl::Span<float>(mod, gain.size()), gain);
+}
 
 void sfz::FilterHolder::setSampleRate(float sampleRate)
 {
@@ -1,5 +1,6 @@
 #pragma once
 #include "SfzFilter.h"
+#include "FilterBank.h"
 #include "Defaults.h"
 #include "modulations/ModMatrix.h"
 #include <vector>
@@ -30,8 +31,22 @@ public:
      * @param inputs
      * @param outputs
      * @param numFrames
+     * @param slot          the render slot of the calling thread
      */
-    void process(const float** inputs, float** outputs, unsigned numFrames);
+    void process(const float** inputs, float** outputs, unsigned numFrames, unsigned slot);
+    /**
+     * @brief Queue a block of channels to filter in place into a bank,
+     * when the bank supports the type of the filter. The channels are
+     * filtered when the bank is processed.
+     *
+     * @param bank
+     * @param channels
+     * @param numFrames
+     * @param slot          the render slot of the calling thread
+     * @return false if the bank can not process the filter, and it must be
+     *         processed with `process` instead
+     */
+    bool queue(FilterBank& bank, float* const channels[], unsigned numFrames, unsigned slot);
     /**
      * @brief Set the sample rate for a filter
      *
@@ -43,9 +58,13 @@ public:
      */
     void reset();
 private:
+    void computeCutoff(absl::Span<float> cutoff, unsigned slot);
+    void computeResonance(absl::Span<float> resonance, unsigned slot);
+    void computeGain(absl::Span<float> gain, unsigned slot);
     Resources& resources;
     const FilterDescription* description;
     std::unique_ptr<Filter> filter;
+    FilterBankState bankState;
     float baseCutoff { Default::filterCutoff };
     float baseResonance { Default::filterResonance };
     float baseGain { Default::filterGain };
@@ -5,6 +5,7 @@
 // If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
 
 #include "Interpolators.h"
+#include "SincResampler.h"
 
 namespace sfz {
 
@@ -18,6 +19,7 @@ void initializeInterpolators()
     SincInterpolatorTraits<48>::initialize();
     SincInterpolatorTraits<60>::initialize();
     SincInterpolatorTraits<72>::initialize();
+    initializeSincResampler();
 }
 
 } // namespace sfz
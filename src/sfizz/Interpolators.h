@@ -5,6 +5,7 @@
 // If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
 
 #pragma once
+#include <cstdint>
 
 namespace sfz {
 
@@ -38,7 +39,7 @@ enum InterpolatorModel : int {
 /**
  * @brief Initialize interpolators
  *
- * This precomputes windowed-sinc tables globally.
+ * This precomputes windowed-sinc tables and polyphase banks globally.
  * It needs to be called at least once, before using the windowed-sinc models.
  *
  * These are not computed at static initialization time, to prevent slowing down
@@ -63,6 +64,20 @@ void initializeInterpolators();
 template <InterpolatorModel M, class R>
 R interpolate(const R* values, R coeff);
 
+/**
+ * @brief Interpolate from a vector of 16-bit integer samples, which are
+ * converted on the fly and scaled to the [-1, 1] range
+ *
+ * @tparam M the interpolator model
+ * @tparam R the output type
+ * @param values Pointer to a value in a larger vector of values,
+ *               with the same padding requirements as above
+ * @param coeff the interpolation coefficient
+ * @return R
+ */
+template <InterpolatorModel M, class R>
+R interpolate(const int16_t* values, R coeff);
+
 } // namespace sfz
 
 #include "Interpolators.hpp"
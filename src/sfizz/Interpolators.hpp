@@ -10,7 +10,7 @@
 #include "SIMDConfig.h"
 #include <simde/simde-features.h>
 #if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
-#include <simde/x86/sse.h>
+#include <simde/x86/sse2.h>
 #include <simde/arm/neon/addv.h>
 #endif
 
@@ -25,6 +25,28 @@ inline R interpolate(const R* values, R coeff)
     return Interpolator<M, R>::process(values, coeff);
 }
 
+template <InterpolatorModel M, class R>
+inline R interpolate(const int16_t* values, R coeff)
+{
+    // the filters are linear, scale the output rather than each input
+    return Interpolator<M, R>::process(values, coeff) * static_cast<R>(1.0 / 32768);
+}
+
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+inline simde__m128 loadSamplesX4(const float* values)
+{
+    return simde_mm_loadu_ps(values);
+}
+
+inline simde__m128 loadSamplesX4(const int16_t* values)
+{
+    // sign-extend the 16-bit samples to 32-bit, and convert
+    simde__m128i x = simde_mm_loadl_epi64(reinterpret_cast<const simde__m128i*>(values));
+    x = simde_mm_srai_epi32(simde_mm_unpacklo_epi16(x, x), 16);
+    return simde_mm_cvtepi32_ps(x);
+}
+#endif
+
 //------------------------------------------------------------------------------
 // Nearest
 
@@ -32,9 +54,10 @@ template <class R>
 class Interpolator<kInterpolatorNearest, R>
 {
 public:
-    static inline R process(const R* values, R coeff)
+    template <class T>
+    static inline R process(const T* values, R coeff)
     {
-        return values[coeff > static_cast<R>(0.5)];
+        return static_cast<R>(values[coeff > static_cast<R>(0.5)]);
     }
 };
 
@@ -45,9 +68,10 @@ template <class R>
 class Interpolator<kInterpolatorLinear, R>
 {
 public:
-    static inline R process(const R* values, R coeff)
+    template <class T>
+    static inline R process(const T* values, R coeff)
     {
-        return values[0] * (static_cast<R>(1.0) - coeff) + values[1] * coeff;
+        return static_cast<R>(values[0]) * (static_cast<R>(1.0) - coeff) + static_cast<R>(values[1]) * coeff;
     }
 };
 
@@ -59,11 +83,12 @@ template <>
 class Interpolator<kInterpolatorHermite3, float>
 {
 public:
-    static inline float process(const float* values, float coeff)
+    template <class T>
+    static inline float process(const T* values, float coeff)
     {
         simde__m128 x = simde_mm_sub_ps(simde_mm_setr_ps(-1, 0, 1, 2), simde_mm_set1_ps(coeff));
         simde__m128 h = hermite3x4(x);
-        simde__m128 y = simde_mm_mul_ps(h, simde_mm_loadu_ps(values - 1));
+        simde__m128 y = simde_mm_mul_ps(h, loadSamplesX4(values - 1));
         return simde_vaddvq_f32(y);
     }
 };
@@ -76,12 +101,13 @@ template <class R>
 class Interpolator<kInterpolatorHermite3, R>
 {
 public:
-    static inline R process(const R* values, R coeff)
+    template <class T>
+    static inline R process(const T* values, R coeff)
     {
         R y = 0;
         for (int i = -1; i < 3; ++i) {
             R h = hermite3<R>(i - coeff);
-            y += h * values[i];
+            y += h * static_cast<R>(values[i]);
         }
         return y;
     }
@@ -95,11 +121,12 @@ template <>
 class Interpolator<kInterpolatorBspline3, float>
 {
 public:
-    static inline float process(const float* values, float coeff)
+    template <class T>
+    static inline float process(const T* values, float coeff)
     {
         simde__m128 x = simde_mm_sub_ps(simde_mm_setr_ps(-1, 0, 1, 2), simde_mm_set1_ps(coeff));
         simde__m128 h = bspline3x4(x);
-        simde__m128 y = simde_mm_mul_ps(h, simde_mm_loadu_ps(values - 1));
+        simde__m128 y = simde_mm_mul_ps(h, loadSamplesX4(values - 1));
         return simde_vaddvq_f32(y);
     }
 };
@@ -112,12 +139,13 @@ template <class R>
 class Interpolator<kInterpolatorBspline3, R>
 {
 public:
-    static inline R process(const R* values, R coeff)
+    template <class T>
+    static inline R process(const T* values, R coeff)
     {
         R y = 0;
         for (int i = -1; i < 3; ++i) {
             R h = bspline3<R>(i - coeff);
-            y += h * values[i];
+            y += h * static_cast<R>(values[i]);
         }
         return y;
     }
@@ -186,7 +214,8 @@ class SincInterpolator<float, Points>
 public:
     static_assert(Points % 4 == 0, "Windowed sinc must be multiple of 4");
 
-    static inline float process(const float* values, float coeff)
+    template <class T>
+    static inline float process(const T* values, float coeff)
     {
         const auto &ws = *SincInterpolatorTraits<Points>::windowedSinc;
 
@@ -198,7 +227,7 @@ public:
         size_t i = 0;
         do {
             simde__m128 h = ws.getUncheckedX4(x);
-            y = simde_mm_add_ps(y, simde_mm_mul_ps(h, simde_mm_loadu_ps(&values[j0 + i])));
+            y = simde_mm_add_ps(y, simde_mm_mul_ps(h, loadSamplesX4(&values[j0 + i])));
             x = simde_mm_add_ps(x, simde_mm_set1_ps(4.0f));
             i += 4;
         } while (i < Points);
@@ -214,7 +243,8 @@ template <class R, size_t Points>
 class SincInterpolator
 {
 public:
-    static inline R process(const R* values, R coeff)
+    template <class T>
+    static inline R process(const T* values, R coeff)
     {
         const auto &ws = *SincInterpolatorTraits<Points>::windowedSinc;
 
@@ -224,9 +254,9 @@ public:
         for (int i = 0; i < int(Points); ++i)
             h[i] = R(ws.getUnchecked(j0 - coeff + i));
 
-        R y = h[0] * values[j0];
+        R y = h[0] * static_cast<R>(values[j0]);
         for (int i = 1; i < int(Points); ++i)
-            y += h[i] * values[j0 + i];
+            y += h[i] * static_cast<R>(values[j0 + i]);
 
         return y;
     }
@@ -46,6 +46,9 @@ struct LFO::Impl {
     std::array<float, config::maxLFOSubs> subPhases_ {{}};
     std::array<float, config::maxLFOSubs> sampleHoldMem_ {{}};
     std::array<int, config::maxLFOSubs> sampleHoldState_ {{}};
+    // seeded when the LFO starts, so that the sample and hold values do not
+    // depend on the thread which renders the voice
+    fast_rand randomGenerator_;
 };
 
 LFO::LFO(Resources& resources)
@@ -82,6 +85,7 @@ void LFO::start(unsigned triggerDelay)
     impl.subPhases_.fill(0.0f);
     impl.sampleHoldMem_.fill(0.0f);
     impl.sampleHoldState_.fill(0);
+    impl.randomGenerator_.seed(Random::randomGenerator());
 
     float delay = desc.delay;
     for (const auto& mod: desc.delayCC)
@@ -197,7 +201,7 @@ void LFO::processSH(unsigned nth, absl::Span<float> out, const float* phaseIn)
         // value updates twice every period
         if (sampleHoldState != oldState) {
             std::uniform_real_distribution<float> dist(-1.0f, +1.0f);
-            sampleHoldValue = dist(Random::randomGenerator);
+            sampleHoldValue = dist(impl.randomGenerator_);
         }
     }
 
@@ -230,11 +234,21 @@ void LFO::processSteps(absl::Span<float> out, const float* phaseIn)
     }
 }
 
-void LFO::process(absl::Span<float> out)
+void LFO::process(absl::Span<float> out, unsigned slot)
+{
+    processWithStep(out, 1, slot);
+}
+
+void LFO::processDecimated(absl::Span<float> out, unsigned step, unsigned slot)
+{
+    processWithStep(out, std::max(1u, step), slot);
+}
+
+void LFO::processWithStep(absl::Span<float> out, unsigned step, unsigned slot)
 {
     Impl& impl = *impl_;
     const LFODescription& desc = *impl.desc_;
-    BufferPool& pool = impl.resources_.getBufferPool();
+    BufferPool& pool = impl.resources_.getBufferPool(slot);
     size_t numFrames = out.size();
 
     fill(out, 0.0f);
@@ -261,45 +275,60 @@ void LFO::process(absl::Span<float> out)
 
     absl::Span<float> phases = *phasesTemp;
 
+    // the values of the decimated frames are kept at the front of the output
+    const size_t numPoints = (numFrames + step - 1) / step;
+    const absl::Span<float> points = out.first(numPoints);
+
     if (desc.seq) {
-        generatePhase(0, phases);
-        processSteps(out, phases.data());
+        generatePhase(0, phases, step, slot);
+        processSteps(points, phases.data());
         ++subno;
     }
 
     for (; subno < countSubs; ++subno) {
-        generatePhase(subno, phases);
+        generatePhase(subno, phases, step, slot);
         switch (desc.sub[subno].wave) {
         case LFOWave::Triangle:
-            processWave<LFOWave::Triangle>(subno, out, phases.data());
+            processWave<LFOWave::Triangle>(subno, points, phases.data());
             break;
         case LFOWave::Sine:
-            processWave<LFOWave::Sine>(subno, out, phases.data());
+            processWave<LFOWave::Sine>(subno, points, phases.data());
             break;
         case LFOWave::Pulse75:
-            processWave<LFOWave::Pulse75>(subno, out, phases.data());
+            processWave<LFOWave::Pulse75>(subno, points, phases.data());
             break;
         case LFOWave::Square:
-            processWave<LFOWave::Square>(subno, out, phases.data());
+            processWave<LFOWave::Square>(subno, points, phases.data());
             break;
         case LFOWave::Pulse25:
-            processWave<LFOWave::Pulse25>(subno, out, phases.data());
+            processWave<LFOWave::Pulse25>(subno, points, phases.data());
             break;
         case LFOWave::Pulse12_5:
-            processWave<LFOWave::Pulse12_5>(subno, out, phases.data());
+            processWave<LFOWave::Pulse12_5>(subno, points, phases.data());
             break;
         case LFOWave::Ramp:
-            processWave<LFOWave::Ramp>(subno, out, phases.data());
+            processWave<LFOWave::Ramp>(subno, points, phases.data());
             break;
         case LFOWave::Saw:
-            processWave<LFOWave::Saw>(subno, out, phases.data());
+            processWave<LFOWave::Saw>(subno, points, phases.data());
             break;
         case LFOWave::RandomSH:
-            processSH<LFOWave::RandomSH>(subno, out, phases.data());
+            processSH<LFOWave::RandomSH>(subno, points, phases.data());
             break;
         }
     }
 
+    // hold each value until the next one, going backwards so as to not
+    // overwrite the values which are still to be read
+    if (step > 1) {
+        for (size_t k = numPoints; k-- > 0;) {
+            const size_t begin = k * step;
+            const size_t end = std::min(begin + step, numFrames);
+            const float value = out[k];
+            std::fill(out.begin() + begin, out.begin() + end, value);
+        }
+    }
+
     processFadeIn(out);
 }
 
@@ -324,10 +353,10 @@ void LFO::processFadeIn(absl::Span<float> out)
     impl.fadePosition_ = fadePosition;
 }
 
-void LFO::generatePhase(unsigned nth, absl::Span<float> phases)
+void LFO::generatePhase(unsigned nth, absl::Span<float> phases, unsigned step, unsigned slot)
 {
     Impl& impl = *impl_;
-    BufferPool& bufferPool = impl.resources_.getBufferPool();
+    BufferPool& bufferPool = impl.resources_.getBufferPool(slot);
     BeatClock& beatClock = impl.resources_.getBeatClock();
     ModMatrix& modMatrix = impl.resources_.getModMatrix();
     const LFODescription& desc = *impl.desc_;
@@ -339,6 +368,7 @@ void LFO::generatePhase(unsigned nth, absl::Span<float> phases)
     const float ratio = sub.ratio;
     float phase = impl.subPhases_[nth];
     const size_t numFrames = phases.size();
+    const size_t numPoints = (numFrames + step - 1) / step;
 
     // TODO(jpc) lfoN_count: number of repetitions
 
@@ -348,9 +378,9 @@ void LFO::generatePhase(unsigned nth, absl::Span<float> phases)
     const float* phaseMod = nullptr;
     // Note(jpc) we might switch between beats and frequency, if host
     //           switches play state on and off; continually generate both.
-    beatsMod = modMatrix.getModulation(impl.beatsKeyId);
-    freqMod = modMatrix.getModulation(impl.freqKeyId);
-    phaseMod = modMatrix.getModulation(impl.phaseKeyId);
+    beatsMod = modMatrix.getModulation(impl.beatsKeyId, slot);
+    freqMod = modMatrix.getModulation(impl.freqKeyId, slot);
+    phaseMod = modMatrix.getModulation(impl.phaseKeyId, slot);
 
     if (beatClock.isPlaying() && beats > 0) {
         // generate using the beat clock
@@ -371,8 +401,12 @@ void LFO::generatePhase(unsigned nth, absl::Span<float> phases)
                 beatClock.calculatePhaseModulated(temp->data(), phases.data());
             }
         }
+
+        // the beat clock computes every frame, keep the decimated ones
+        for (size_t k = 1; k < numPoints; ++k)
+            phases[k] = phases[k * step];
     }
-    else {
+    else if (step == 1) {
         // generate using the frequency
         if (!freqMod) {
             float incr = ratio * samplePeriod * baseFreq;
@@ -388,16 +422,26 @@ void LFO::generatePhase(unsigned nth, absl::Span<float> phases)
                 phase = wrapPhase(phase + incr);
             }
         }
-
+    }
+    else {
+        // generate using the frequency, advancing by whole steps
+        // the last step can be partial, so that the phase does not drift
+        for (size_t k = 0; k < numPoints; ++k) {
+            const size_t i = k * step;
+            phases[k] = phase;
+            const float freq = freqMod ? (baseFreq + freqMod[i]) : baseFreq;
+            const float incr = ratio * samplePeriod * freq;
+            phase = wrapPhase(phase + incr * static_cast<float>(std::min<size_t>(step, numFrames - i)));
+        }
     }
 
     // apply phase offsets
     if (!phaseMod) {
-        for (size_t i = 0; i < numFrames; ++i)
-            phases[i] = wrapPhase(phases[i] + phaseOffset);
+        for (size_t k = 0; k < numPoints; ++k)
+            phases[k] = wrapPhase(phases[k] + phaseOffset);
     } else {
-        for (size_t i = 0; i < numFrames; ++i)
-            phases[i] = wrapPhase(phases[i] + phaseOffset + phaseMod[i]);
+        for (size_t k = 0; k < numPoints; ++k)
+            phases[k] = wrapPhase(phases[k] + phaseOffset + phaseMod[k * step]);
     }
 
     impl.subPhases_[nth] = phase;
@@ -74,10 +74,18 @@ public:
 
     /**
        Process a cycle of the oscillator.
+       The slot is the render slot of the calling thread, which selects the
+       scratch buffers and the modulation context to use.
 
        TODO(jpc) frequency modulations
      */
-    void process(absl::Span<float> out);
+    void process(absl::Span<float> out, unsigned slot);
+
+    /**
+       Process a cycle of the oscillator at control rate.
+       The wave is evaluated once every `step` frames, and held in between.
+     */
+    void processDecimated(absl::Span<float> out, unsigned step, unsigned slot);
 
 private:
     /**
@@ -113,9 +121,16 @@ private:
     void processFadeIn(absl::Span<float> out);
 
     /**
-       Generate the phase of the N-th generator
+       Process a cycle of the oscillator, evaluating once every `step` frames.
+     */
+    void processWithStep(absl::Span<float> out, unsigned step, unsigned slot);
+
+    /**
+       Generate the phase of the N-th generator, once every `step` frames.
+       The phases are written compactly at the front of the buffer, which
+       must have room for the phases of all the frames.
      */
-    void generatePhase(unsigned nth, absl::Span<float> phases);
+    void generatePhase(unsigned nth, absl::Span<float> phases, unsigned step, unsigned slot);
 
 private:
     struct Impl;
@@ -47,18 +47,41 @@ bool Layer::isSwitchedOn() const noexcept
 }
 
 bool Layer::registerNoteOn(int noteNumber, float velocity, float randValue) noexcept
+{
+    if (region_.keyRange.containsWithEnd(noteNumber))
+        advanceSequence();
+
+    return triggersOnNote(noteNumber, velocity, randValue);
+}
+
+void Layer::advanceSequence() noexcept
+{
+    const Region& region = region_;
+    sequenceSwitched_ =
+        ((sequenceCounter_++ % region.sequenceLength) == region.sequencePosition - 1);
+}
+
+bool Layer::hasSequence() const noexcept
+{
+    // Otherwise the sequence is always switched on, and the counter is unused
+    const Region& region = region_;
+    return region.usesSequenceSwitches || region.sequenceLength > 1;
+}
+
+bool Layer::canTriggerOnNoteOn() const noexcept
+{
+    const Region& region = region_;
+    return region.triggerOnNote
+        && (region.trigger == Trigger::attack || region.trigger == Trigger::first || region.trigger == Trigger::legato);
+}
+
+bool Layer::triggersOnNote(int noteNumber, float velocity, float randValue) const noexcept
 {
     ASSERT(velocity >= 0.0f && velocity <= 1.0f);
 
     const Region& region = region_;
 
     const bool keyOk = region.keyRange.containsWithEnd(noteNumber);
-    if (keyOk) {
-        // Sequence activation
-        sequenceSwitched_ =
-            ((sequenceCounter_++ % region.sequenceLength) == region.sequencePosition - 1);
-    }
-
     const bool polyAftertouchActive =
         region.polyAftertouchRange.containsWithEnd(midiState_.getPolyAftertouch(noteNumber));
 
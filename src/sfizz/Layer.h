@@ -67,6 +67,32 @@ public:
      * @return false
      */
     bool registerNoteOn(int noteNumber, float velocity, float randValue) noexcept;
+    /**
+     * @brief Check if the region should trigger on a note on event, without
+     * advancing the sequence. This is the second half of `registerNoteOn`.
+     *
+     * @param noteNumber
+     * @param velocity
+     * @param randValue
+     * @return true if the region should trigger on this event.
+     * @return false
+     */
+    bool triggersOnNote(int noteNumber, float velocity, float randValue) const noexcept;
+    /**
+     * @brief Advance the round-robin sequence on a note on event within the
+     * key range. This is the first half of `registerNoteOn`.
+     */
+    void advanceSequence() noexcept;
+    /**
+     * @brief Check whether the layer has a round-robin sequence which
+     * needs to be advanced on every note on within its key range.
+     */
+    bool hasSequence() const noexcept;
+    /**
+     * @brief Check whether the layer can ever trigger on a note on event,
+     * regardless of the note, velocity and switches.
+     */
+    bool canTriggerOnNoteOn() const noexcept;
     /**
      * @brief Register a new note off event. The region may be switched on or off using keys so
      * this function updates the keyswitches state.
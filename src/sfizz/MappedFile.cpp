@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "MappedFile.h"
+#include "utility/Debug.h"
+#include <algorithm>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace sfz {
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#if defined(_WIN32)
+bool MappedFile::open(const fs::path& path)
+{
+    close();
+
+    HANDLE file = CreateFileW(
+        path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    mappingHandle_ = mapping;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mappingHandle_)
+        CloseHandle(static_cast<HANDLE>(mappingHandle_));
+
+    data_ = nullptr;
+    size_ = 0;
+    mappingHandle_ = nullptr;
+}
+
+void MappedFile::adviseSequential() noexcept
+{
+}
+
+void MappedFile::prefetch(size_t, size_t) noexcept
+{
+}
+#else
+bool MappedFile::open(const fs::path& path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        DBG("[sfizz] Cannot map the file " << path);
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_)
+        munmap(const_cast<uint8_t*>(data_), size_);
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void MappedFile::adviseSequential() noexcept
+{
+    if (data_)
+        posix_madvise(const_cast<uint8_t*>(data_), size_, POSIX_MADV_SEQUENTIAL);
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) noexcept
+{
+    if (!data_ || offset >= size_)
+        return;
+
+    // the advice must start on a page boundary
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = offset - offset % pageSize;
+    const size_t end = std::min(size_, offset + length);
+    posix_madvise(const_cast<uint8_t*>(data_ + start), end - start, POSIX_MADV_WILLNEED);
+}
+#endif
+
+} // namespace sfz
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "ghc/fs_std.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace sfz {
+
+/**
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * The pages are shared with the system file cache, so that several processes
+ * mapping the same file do not duplicate its contents in memory.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file, replacing any previous mapping.
+     *
+     * @param path
+     * @return true if the file was mapped
+     */
+    bool open(const fs::path& path);
+    /**
+     * @brief Release the mapping.
+     */
+    void close();
+
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    /**
+     * @brief Hint that the mapping is going to be read mostly in order.
+     */
+    void adviseSequential() noexcept;
+    /**
+     * @brief Hint that a range of bytes is going to be read soon, so that
+     * the system can start reading it in the background.
+     *
+     * @param offset the offset of the range in bytes
+     * @param length the length of the range in bytes
+     */
+    void prefetch(size_t offset, size_t length) noexcept;
+
+private:
+    const uint8_t* data_ { nullptr };
+    size_t size_ { 0 };
+#if defined(_WIN32)
+    void* mappingHandle_ { nullptr };
+#endif
+};
+
+} // namespace sfz
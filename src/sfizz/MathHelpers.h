@@ -623,7 +623,7 @@ class fast_rand {
 public:
     typedef uint32_t result_type;
 
-    fast_rand() noexcept
+    constexpr fast_rand() noexcept
     {
     }
 
@@ -716,9 +716,13 @@ private:
  *
  * TODO: could be moved into a singleton class holder
  *
+ * These are thread-local, because voices can be rendered concurrently. The
+ * voices and LFOs draw their seeds from them when they start, on the thread
+ * which dispatches the events, and render from their own generators, so that
+ * the results do not depend on the rendering thread.
  */
 namespace Random {
-static fast_rand randomGenerator;
+static thread_local fast_rand randomGenerator;
 } // namespace Random
 
 /**
@@ -10,6 +10,7 @@
 
 sfz::MidiState::MidiState()
 {
+    setSamplesPerBlock(samplesPerBlock);
     resetEventStates();
     resetNoteStates();
 }
@@ -152,10 +153,27 @@ float sfz::MidiState::getVelocityOverride() const noexcept
 void sfz::MidiState::insertEventInVector(EventVector& events, int delay, float value)
 {
     const auto insertionPoint = absl::c_lower_bound(events, delay, MidiEventDelayComparator {});
-    if (insertionPoint == events.end() || insertionPoint->delay != delay)
+    if (insertionPoint != events.end() && insertionPoint->delay == delay) {
+        insertionPoint->value = value;
+        return;
+    }
+
+    if (events.size() < events.capacity()) {
         events.insert(insertionPoint, { delay, value });
+        return;
+    }
+
+    // The vector is full, and must not reallocate on the audio thread.
+    // The new event replaces the one before it, except for the first event which
+    // holds the state at the start of the block; the event after it starts earlier then.
+    ++numCoalescedEvents;
+    const auto index = insertionPoint - events.begin();
+    if (index > 1)
+        *(insertionPoint - 1) = { delay, value };
+    else if (index == 1 && insertionPoint != events.end())
+        insertionPoint->delay = delay;
     else
-        insertionPoint->value = value;
+        events.back().value = value;
 }
 
 void sfz::MidiState::pitchBendEvent(int delay, float pitchBendValue) noexcept
@@ -65,7 +65,8 @@ public:
     /**
      * @brief Set the maximum size of the blocks for the callback. The actual
      * size can be lower in each callback but should not be larger
-     * than this value.
+     * than this value. This also sets the capacity of the event lists, which
+     * hold at most one event per frame and never grow on the audio thread.
      *
      * @param samplesPerBlock
      */
@@ -199,10 +200,18 @@ public:
      */
     void resetEventStates() noexcept;
 
+    /**
+     * @brief Get the number of events which were coalesced with their
+     * neighbors because an event list was full, since the creation.
+     */
+    unsigned getNumCoalescedEvents() const noexcept { return numCoalescedEvents; }
+
 private:
 
     /**
-     * @brief Insert events in a sorted event vector.
+     * @brief Insert events in a sorted event vector. If the vector is full,
+     * the event is coalesced with its neighbors instead, so that the vector
+     * never reallocates.
      *
      * @param events
      * @param delay
@@ -279,6 +288,7 @@ private:
     int samplesPerBlock { config::defaultSamplesPerBlock };
     float alternate { 0.0f };
     unsigned internalClock { 0 };
+    unsigned numCoalescedEvents { 0 };
     fast_real_distribution<float> unipolarDist { 0.0f, 1.0f };
     fast_real_distribution<float> bipolarDist { -1.0f, 1.0f };
 };
@@ -19,7 +19,10 @@ void sfz::PolyphonyGroup::registerVoice(Voice* voice) noexcept
 
 void sfz::PolyphonyGroup::removeVoice(const Voice* voice) noexcept
 {
-    swapAndPopFirst(voices, [voice](const Voice* v) { return v == voice; });
+    // Keep the start order, which the voice stealing relies on
+    auto it = absl::c_find(voices, voice);
+    if (it != voices.end())
+        voices.erase(it);
 }
 
 void sfz::PolyphonyGroup::removeAllVoices() noexcept
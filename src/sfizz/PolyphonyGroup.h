@@ -51,7 +51,7 @@ public:
      */
     unsigned numPlayingVoices() const noexcept;
     /**
-     * @brief Get the active voices
+     * @brief Get the active voices, in the order in which they started
      *
      * @return const std::vector<Voice*>&
      */
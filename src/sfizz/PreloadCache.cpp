@@ -0,0 +1,342 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "PreloadCache.h"
+#include "FilePool.h"
+#include "FileId.h"
+#include "MappedFile.h"
+#include "utility/Debug.h"
+#include <absl/algorithm/container.h>
+#include <absl/strings/str_cat.h>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+namespace sfz {
+
+namespace {
+
+constexpr char entryMagic[8] { 'S', 'F', 'Z', 'P', 'R', 'E', 'L', 'D' };
+constexpr uint32_t entryVersion { 1 };
+constexpr uint64_t entryDataAlignment { 64 };
+
+/**
+ * @brief The header of a cache entry, followed by the path of the sample file
+ * and, at an aligned offset, the planar channel data.
+ */
+struct EntryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    // key
+    uint64_t fileSize;
+    int64_t fileTime;
+    uint32_t requestedFrames;
+    uint8_t reverse;
+    uint8_t requestedCompact;
+    // file information
+    uint8_t hasLoop;
+    uint8_t hasWavetable;
+    int64_t end;
+    int64_t loopStart;
+    int64_t loopEnd;
+    double sampleRate;
+    int32_t numChannels;
+    int32_t rootKey;
+    uint32_t wavetableSize;
+    int32_t wavetableInterpolation;
+    uint8_t wavetableOneShot;
+    // preloaded data
+    uint8_t compact;
+    uint8_t reserved[2];
+    uint32_t dataChannels;
+    uint32_t dataFrames;
+    uint32_t pathSize;
+    uint64_t dataOffset;
+};
+
+static_assert(std::is_trivially_copyable<EntryHeader>::value, "The header must be trivially copyable");
+
+bool getSourceKey(const fs::path& file, uint64_t& fileSize, int64_t& fileTime)
+{
+    std::error_code ec;
+    fileSize = static_cast<uint64_t>(fs::file_size(file, ec));
+    if (ec)
+        return false;
+    const auto time = fs::last_write_time(file, ec);
+    if (ec)
+        return false;
+    fileTime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+template <class T>
+void readChannels(const uint8_t* input, unsigned numChannels, size_t numFrames, FileSampleBuffer<T>& output)
+{
+    output.reset();
+    output.addChannels(numChannels);
+    output.resize(numFrames);
+    output.clear();
+    for (unsigned c = 0; c < numChannels; ++c)
+        std::memcpy(output.channelWriter(c), input + c * numFrames * sizeof(T), numFrames * sizeof(T));
+}
+
+template <class T>
+void writeChannels(std::ostream& stream, const FileSampleBuffer<T>& input)
+{
+    for (size_t c = 0, n = input.getNumChannels(); c < n; ++c) {
+        const absl::Span<const T> channel = input.getConstSpan(c);
+        stream.write(reinterpret_cast<const char*>(channel.data()), channel.size() * sizeof(T));
+    }
+}
+
+} // namespace
+
+void PreloadCache::setDirectory(const fs::path& directory)
+{
+    directory_ = directory;
+    if (directory_.empty())
+        return;
+
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) {
+        DBG("[sfizz] Cannot create the preload cache directory " << directory_ << ": " << ec.message());
+        directory_.clear();
+        return;
+    }
+
+    trim();
+}
+
+void PreloadCache::trim() const
+{
+    storedBytes_ = 0;
+    if (!isEnabled())
+        return;
+
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uint64_t size;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it { directory_, ec }, end; !ec && it != end; it.increment(ec)) {
+        const fs::path& path = it->path();
+        if (path.extension() != ".preload")
+            continue;
+
+        std::error_code entryError;
+        const auto size = static_cast<uint64_t>(fs::file_size(path, entryError));
+        if (entryError)
+            continue;
+        const fs::file_time_type time = fs::last_write_time(path, entryError);
+        if (entryError)
+            continue;
+
+        entries.push_back({ path, time, size });
+        totalSize += size;
+    }
+
+    if (totalSize <= maxSize_)
+        return;
+
+    absl::c_sort(entries, [](const Entry& lhs, const Entry& rhs) { return lhs.time < rhs.time; });
+
+    // An entry mapped by another process may fail to be removed, skip it
+    for (const Entry& entry : entries) {
+        if (totalSize <= maxSize_)
+            break;
+        if (fs::remove(entry.path, ec))
+            totalSize -= entry.size;
+    }
+}
+
+fs::path PreloadCache::entryPath(const std::string& source, const FileId& fileId, uint32_t numFrames, bool compact) const
+{
+    // FNV-1a, which unlike std::hash is stable from one run to the next
+    uint64_t hash = 0xcbf29ce484222325u;
+    auto feed = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3u;
+    };
+    const uint8_t flags[2] { fileId.isReverse(), compact };
+    feed(source.data(), source.size());
+    feed(flags, sizeof(flags));
+    feed(&numFrames, sizeof(numFrames));
+
+    return directory_ / absl::StrCat(absl::Hex(hash, absl::kZeroPad16), ".preload");
+}
+
+std::shared_ptr<const FileHead> PreloadCache::load(const fs::path& file, const FileId& fileId, uint32_t numFrames, bool compact) const
+{
+    if (!isEnabled())
+        return {};
+
+    uint64_t fileSize;
+    int64_t fileTime;
+    if (!getSourceKey(file, fileSize, fileTime))
+        return {};
+
+    const std::string source = file.u8string();
+    const fs::path path = entryPath(source, fileId, numFrames, compact);
+    MappedFile entry;
+    if (!entry.open(path))
+        return {};
+
+    EntryHeader header;
+    if (entry.size() < sizeof(header))
+        return {};
+    std::memcpy(&header, entry.data(), sizeof(header));
+
+    const bool valid = std::memcmp(header.magic, entryMagic, sizeof(entryMagic)) == 0
+        && header.version == entryVersion
+        && header.headerSize == sizeof(header)
+        && header.fileSize == fileSize
+        && header.fileTime == fileTime
+        && header.requestedFrames == numFrames
+        && header.reverse == fileId.isReverse()
+        && header.requestedCompact == compact
+        && header.pathSize == source.size()
+        && sizeof(header) + header.pathSize <= entry.size()
+        && std::memcmp(entry.data() + sizeof(header), source.data(), source.size()) == 0
+        && header.dataChannels >= 1 && header.dataChannels <= 2;
+    if (!valid)
+        return {};
+
+    const uint64_t sampleSize = header.compact ? sizeof(int16_t) : sizeof(float);
+    const uint64_t dataSize = uint64_t(header.dataChannels) * header.dataFrames * sampleSize;
+    if (header.dataOffset > entry.size() || dataSize > entry.size() - header.dataOffset)
+        return {};
+
+    auto head = std::make_shared<FileHead>();
+    FileInformation& information = head->information;
+    information.end = header.end;
+    information.loopStart = header.loopStart;
+    information.loopEnd = header.loopEnd;
+    information.hasLoop = header.hasLoop != 0;
+    information.sampleRate = header.sampleRate;
+    information.numChannels = header.numChannels;
+    information.rootKey = header.rootKey;
+    information.wavetable.reset();
+    if (header.hasWavetable) {
+        WavetableInfo wavetable;
+        wavetable.tableSize = header.wavetableSize;
+        wavetable.crossTableInterpolation = header.wavetableInterpolation;
+        wavetable.oneShot = header.wavetableOneShot != 0;
+        information.wavetable = wavetable;
+    }
+
+    const uint8_t* channelData = entry.data() + header.dataOffset;
+    head->compact = header.compact != 0;
+    if (head->compact)
+        readChannels(channelData, header.dataChannels, header.dataFrames, head->compactData);
+    else
+        readChannels(channelData, header.dataChannels, header.dataFrames, head->data);
+
+    // Mark the entry as recently used, so that trimming keeps it longer
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return head;
+}
+
+bool PreloadCache::store(const fs::path& file, const FileId& fileId, uint32_t numFrames, bool compact, const FileHead& head) const
+{
+    if (!isEnabled())
+        return false;
+
+    uint64_t fileSize;
+    int64_t fileTime;
+    if (!getSourceKey(file, fileSize, fileTime))
+        return false;
+
+    const std::string source = file.u8string();
+    const FileInformation& information = head.information;
+
+    EntryHeader header {};
+    std::memcpy(header.magic, entryMagic, sizeof(entryMagic));
+    header.version = entryVersion;
+    header.headerSize = sizeof(header);
+    header.fileSize = fileSize;
+    header.fileTime = fileTime;
+    header.requestedFrames = numFrames;
+    header.reverse = fileId.isReverse();
+    header.requestedCompact = compact;
+    header.hasLoop = information.hasLoop;
+    header.hasWavetable = information.wavetable.has_value();
+    header.end = information.end;
+    header.loopStart = information.loopStart;
+    header.loopEnd = information.loopEnd;
+    header.sampleRate = information.sampleRate;
+    header.numChannels = information.numChannels;
+    header.rootKey = information.rootKey;
+    if (information.wavetable) {
+        header.wavetableSize = information.wavetable->tableSize;
+        header.wavetableInterpolation = information.wavetable->crossTableInterpolation;
+        header.wavetableOneShot = information.wavetable->oneShot;
+    }
+    header.compact = head.compact;
+    header.dataChannels = static_cast<uint32_t>(head.getNumChannels());
+    header.dataFrames = static_cast<uint32_t>(head.getNumFrames());
+    header.pathSize = static_cast<uint32_t>(source.size());
+    header.dataOffset = (sizeof(header) + source.size() + entryDataAlignment - 1) & ~(entryDataAlignment - 1);
+
+    if (header.dataChannels < 1 || header.dataChannels > 2)
+        return false;
+
+    const fs::path path = entryPath(source, fileId, numFrames, compact);
+
+    // Write under a name which is unique to this thread, then move it in place
+    const size_t threadHash = std::hash<std::thread::id>()(std::this_thread::get_id());
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path temporaryPath = path;
+    temporaryPath += absl::StrCat(".", absl::Hex(threadHash), absl::Hex(now), ".tmp");
+
+    {
+        fs::ofstream stream { temporaryPath, std::ios::binary };
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(source.data(), source.size());
+        const std::string padding(header.dataOffset - sizeof(header) - source.size(), '\0');
+        stream.write(padding.data(), padding.size());
+        if (head.compact)
+            writeChannels(stream, head.compactData);
+        else
+            writeChannels(stream, head.data);
+        stream.close();
+
+        if (!stream) {
+            DBG("[sfizz] Cannot write the preload cache entry " << temporaryPath);
+            std::error_code ec;
+            fs::remove(temporaryPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temporaryPath, path, ec);
+    if (ec) {
+        DBG("[sfizz] Cannot write the preload cache entry " << path << ": " << ec.message());
+        fs::remove(temporaryPath, ec);
+        return false;
+    }
+
+    // Trim after storing a sixteenth of the maximum size
+    const uint64_t entrySize = header.dataOffset + uint64_t(header.dataChannels) * header.dataFrames *
+        (head.compact ? sizeof(int16_t) : sizeof(float));
+    if (storedBytes_.fetch_add(entrySize) + entrySize > maxSize_ / 16)
+        trim();
+
+    return true;
+}
+
+} // namespace sfz
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "Config.h"
+#include "ghc/fs_std.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace sfz {
+
+class FileId;
+struct FileHead;
+
+/**
+ * @brief A persistent cache of preloaded sample data, kept in a directory on
+ * the disk and shared by the processes which use the same directory.
+ *
+ * An entry holds the file information and the decoded head of a sample, in
+ * the format in which the file pool stores it in memory. The entry is only
+ * used if the sample file has kept the size and modification time it had
+ * when the entry was written, and if the preloading parameters match.
+ *
+ * The entries which were least recently used are removed when the size of
+ * the directory goes over a maximum, which also drops the stale entries of
+ * samples whose preloading parameters have changed.
+ */
+class PreloadCache {
+public:
+    /**
+     * @brief Set the directory of the cache, which is created if needed.
+     * An empty path disables the cache.
+     *
+     * @param directory
+     */
+    void setDirectory(const fs::path& directory);
+    /**
+     * @brief Get the directory of the cache, empty if it is disabled.
+     */
+    const fs::path& getDirectory() const noexcept { return directory_; }
+    /**
+     * @brief Check whether the cache is in use.
+     */
+    bool isEnabled() const noexcept { return !directory_.empty(); }
+    /**
+     * @brief Set the maximum size of the entries in the directory, above
+     * which the least recently used entries are removed.
+     *
+     * @param maxSize the size in bytes
+     */
+    void setMaxSize(uint64_t maxSize) noexcept { maxSize_ = maxSize; }
+    /**
+     * @brief Get the maximum size of the entries in the directory.
+     */
+    uint64_t getMaxSize() const noexcept { return maxSize_; }
+
+    /**
+     * @brief Read the information and the preloaded data of a sample file
+     * from the cache. This marks the entry as recently used.
+     *
+     * @param file the path of the sample file
+     * @param fileId the sample identifier
+     * @param numFrames the number of frames requested for preloading
+     * @param compact whether the compact storage is enabled
+     * @return the preloaded head, or null if no valid entry was found
+     */
+    std::shared_ptr<const FileHead> load(const fs::path& file, const FileId& fileId, uint32_t numFrames, bool compact) const;
+
+    /**
+     * @brief Write the information and the preloaded data of a sample file
+     * in the cache. The entry is written to a temporary file first, so that
+     * concurrent readers never observe a partial entry. The cache is trimmed
+     * whenever the stored entries add up to a fraction of the maximum size.
+     *
+     * @param file the path of the sample file
+     * @param fileId the sample identifier
+     * @param numFrames the number of frames requested for preloading
+     * @param compact whether the compact storage is enabled
+     * @param head the preloaded head to store
+     * @return true if the entry was written
+     */
+    bool store(const fs::path& file, const FileId& fileId, uint32_t numFrames, bool compact, const FileHead& head) const;
+
+    /**
+     * @brief Remove the least recently used entries until the entries of the
+     * directory fit in the maximum size. This is done when the directory is
+     * set, and regularly when storing entries.
+     */
+    void trim() const;
+
+private:
+    fs::path entryPath(const std::string& source, const FileId& fileId, uint32_t numFrames, bool compact) const;
+
+    fs::path directory_;
+    uint64_t maxSize_ { config::preloadCacheMaxSize };
+    // bytes stored since the last trim
+    mutable std::atomic<uint64_t> storedBytes_ { 0 };
+};
+
+} // namespace sfz
@@ -33,7 +33,10 @@ void sfz::RegionSet::registerVoice(Voice* voice) noexcept
 
 void sfz::RegionSet::removeVoice(const Voice* voice) noexcept
 {
-    swapAndPopFirst(voices, [voice](const Voice* v) { return v == voice; });
+    // Keep the start order, which the voice stealing relies on
+    auto it = absl::c_find(voices, voice);
+    if (it != voices.end())
+        voices.erase(it);
 }
 
 void sfz::RegionSet::registerVoiceInHierarchy(const Region* region, Voice* voice) noexcept
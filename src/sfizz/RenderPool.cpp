@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "RenderPool.h"
+#include "Config.h"
+#include "ScopedFTZ.h"
+#include "utility/Debug.h"
+#include <algorithm>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sfz {
+
+RenderPool::RenderPool()
+{
+}
+
+RenderPool::~RenderPool()
+{
+    stopWorkers();
+}
+
+void RenderPool::setNumThreads(unsigned numThreads)
+{
+    numThreads = std::max(1u, std::min(numThreads, config::maxRenderThreads));
+
+    if (numThreads == getNumThreads())
+        return;
+
+    stopWorkers();
+
+    running_ = true;
+    const unsigned numWorkers = numThreads - 1;
+    workers_.reserve(numWorkers);
+    for (unsigned i = 0; i < numWorkers; ++i) {
+        workers_.emplace_back(new Worker);
+        Worker* worker = workers_.back().get();
+        worker->thread = std::thread(&RenderPool::workerLoop, this, worker, i + 1);
+    }
+}
+
+void RenderPool::stopWorkers()
+{
+    running_ = false;
+
+    for (auto& worker : workers_)
+        worker->start.post();
+
+    for (auto& worker : workers_)
+        worker->thread.join();
+
+    workers_.clear();
+}
+
+void RenderPool::run(unsigned count, JobFunction function, void* data) noexcept
+{
+    if (count == 0)
+        return;
+
+    jobFunction_ = function;
+    jobData_ = data;
+    jobCount_ = count;
+    nextJob_.store(0);
+
+    // the calling thread takes one of the jobs, wake as many workers as needed
+    const unsigned numWoken = std::min(static_cast<unsigned>(workers_.size()), count - 1);
+    std::error_code ec;
+    for (unsigned i = 0; i < numWoken; ++i)
+        workers_[i]->start.post(ec);
+
+    processJobs(0);
+
+    for (unsigned i = 0; i < numWoken; ++i)
+        done_.wait(ec);
+}
+
+void RenderPool::processJobs(unsigned slot) noexcept
+{
+    const JobFunction function = jobFunction_;
+    void* data = jobData_;
+    const unsigned count = jobCount_;
+
+    for (unsigned index; (index = nextJob_.fetch_add(1)) < count; )
+        function(data, index, slot);
+}
+
+void RenderPool::workerLoop(Worker* worker, unsigned slot)
+{
+    raiseCurrentThreadPriority();
+
+    // the workers process audio, keep them consistent with the calling thread
+    ScopedFTZ ftz;
+
+    while (worker->start.wait(), running_) {
+        processJobs(slot);
+        done_.post();
+    }
+}
+
+void RenderPool::raiseCurrentThreadPriority() noexcept
+{
+#if defined(_WIN32)
+    HANDLE thread = GetCurrentThread();
+    const int priority = THREAD_PRIORITY_TIME_CRITICAL;
+    if (!SetThreadPriority(thread, priority)) {
+        std::system_error error(GetLastError(), std::system_category());
+        DBG("[sfizz] Cannot set current thread priority: " << error.what());
+    }
+#else
+    pthread_t thread = pthread_self();
+    int policy;
+    sched_param param;
+
+    if (pthread_getschedparam(thread, &policy, &param) != 0) {
+        DBG("[sfizz] Cannot get current thread scheduling parameters");
+        return;
+    }
+
+    policy = SCHED_FIFO;
+    const int minprio = sched_get_priority_min(policy);
+    const int maxprio = sched_get_priority_max(policy);
+    param.sched_priority = minprio + config::renderThreadPthreadPriority * (maxprio - minprio) / 100;
+
+    if (pthread_setschedparam(thread, policy, &param) != 0) {
+        DBG("[sfizz] Cannot set current thread scheduling parameters");
+        return;
+    }
+#endif
+}
+
+} // namespace sfz
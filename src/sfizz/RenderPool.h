@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "RTSemaphore.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace sfz {
+
+/**
+ * @brief A pool of worker threads which share the rendering of a block with
+ * the real-time thread.
+ *
+ * The pool is sized with a total number of threads, which counts the calling
+ * thread. The calling thread always takes part in the processing as slot 0,
+ * and the worker threads use the slots 1 to N-1. The slot is passed to the
+ * jobs, and it identifies which set of per-thread scratch resources they own.
+ *
+ * Dispatching a job does not allocate nor take locks; the workers are woken
+ * up using semaphores and they pick job indices from an atomic counter.
+ */
+class RenderPool {
+public:
+    RenderPool();
+    ~RenderPool();
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    /**
+     * @brief Set the total number of rendering threads, including the caller.
+     * This starts or stops worker threads, and must not be called while
+     * a job is being processed.
+     *
+     * @param numThreads the number of threads, where 1 means no workers
+     */
+    void setNumThreads(unsigned numThreads);
+
+    /**
+     * @brief Get the total number of rendering threads, including the caller.
+     */
+    unsigned getNumThreads() const noexcept { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    /**
+     * @brief Run a job for every index in the range [0, count), and wait for
+     * all of them to complete. The job is called as `job(index, slot)`,
+     * possibly concurrently from several threads, in no particular order.
+     *
+     * @param count the number of indices to process
+     * @param job the callable object
+     */
+    template <class F>
+    void parallelFor(unsigned count, F& job) noexcept
+    {
+        auto trampoline = [](void* data, unsigned index, unsigned slot) noexcept {
+            (*static_cast<F*>(data))(index, slot);
+        };
+        run(count, trampoline, &job);
+    }
+
+private:
+    typedef void (*JobFunction)(void*, unsigned, unsigned);
+    void run(unsigned count, JobFunction function, void* data) noexcept;
+    void processJobs(unsigned slot) noexcept;
+    void stopWorkers();
+    static void raiseCurrentThreadPriority() noexcept;
+
+    struct Worker {
+        RTSemaphore start;
+        std::thread thread;
+    };
+
+    void workerLoop(Worker* worker, unsigned slot);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    RTSemaphore done_;
+    std::atomic<bool> running_ { false };
+
+    JobFunction jobFunction_ { nullptr };
+    void* jobData_ { nullptr };
+    unsigned jobCount_ { 0 };
+    std::atomic<unsigned> nextJob_ { 0 };
+};
+
+} // namespace sfz
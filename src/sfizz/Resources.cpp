@@ -9,19 +9,27 @@
 #include "MidiState.h"
 #include "FilePool.h"
 #include "BufferPool.h"
+#include "FilterBank.h"
 #include "Logger.h"
 #include "Wavetables.h"
 #include "Curve.h"
 #include "Tuning.h"
 #include "BeatClock.h"
 #include "Metronome.h"
+#include "utility/Debug.h"
 #include "modulations/ModMatrix.h"
+#include <algorithm>
+#include <vector>
 
 namespace sfz {
 
 struct Resources::Impl {
     SynthConfig synthConfig;
-    BufferPool bufferPool;
+    std::vector<std::unique_ptr<BufferPool>> bufferPools; // one per render slot
+    std::vector<std::unique_ptr<FilterBank>> filterBanks; // one per render slot
+    float sampleRate { config::defaultSampleRate };
+    int samplesPerBlock { config::defaultSamplesPerBlock };
+    unsigned bufferPoolCapacity { config::bufferPoolCapacity };
     MidiState midiState;
     Logger logger;
     CurveSet curves;
@@ -37,6 +45,7 @@ struct Resources::Impl {
 Resources::Resources()
     : impl_(new Impl)
 {
+    setNumRenderSlots(1);
 }
 
 Resources::~Resources()
@@ -46,6 +55,9 @@ Resources::~Resources()
 void Resources::setSampleRate(float samplerate)
 {
     Impl& impl = *impl_;
+    impl.sampleRate = samplerate;
+    for (auto& filterBank : impl.filterBanks)
+        filterBank->setSampleRate(samplerate);
     impl.midiState.setSampleRate(samplerate);
     impl.modMatrix.setSampleRate(samplerate);
     impl.beatClock.setSampleRate(samplerate);
@@ -55,12 +67,68 @@ void Resources::setSampleRate(float samplerate)
 void Resources::setSamplesPerBlock(int samplesPerBlock)
 {
     Impl& impl = *impl_;
-    impl.bufferPool.setBufferSize(samplesPerBlock);
+    impl.samplesPerBlock = samplesPerBlock;
+    for (auto& bufferPool : impl.bufferPools)
+        bufferPool->setBufferSize(samplesPerBlock);
+    for (auto& filterBank : impl.filterBanks)
+        filterBank->setSamplesPerBlock(samplesPerBlock);
     impl.midiState.setSamplesPerBlock(samplesPerBlock);
     impl.modMatrix.setSamplesPerBlock(samplesPerBlock);
     impl.beatClock.setSamplesPerBlock(samplesPerBlock);
 }
 
+void Resources::setNumRenderSlots(unsigned numSlots)
+{
+    Impl& impl = *impl_;
+    ASSERT(numSlots > 0);
+
+    const size_t oldSize = impl.bufferPools.size();
+    impl.bufferPools.resize(numSlots);
+    for (size_t i = oldSize; i < numSlots; ++i) {
+        impl.bufferPools[i].reset(new BufferPool);
+        impl.bufferPools[i]->setBufferSize(impl.samplesPerBlock);
+        impl.bufferPools[i]->setCapacity(impl.bufferPoolCapacity);
+    }
+
+    impl.filterBanks.resize(numSlots);
+    for (size_t i = oldSize; i < numSlots; ++i) {
+        impl.filterBanks[i].reset(new FilterBank);
+        impl.filterBanks[i]->setSampleRate(impl.sampleRate);
+        impl.filterBanks[i]->setSamplesPerBlock(impl.samplesPerBlock);
+    }
+
+    impl.modMatrix.setNumContexts(numSlots);
+}
+
+void Resources::setBufferPoolCapacity(unsigned numBuffers)
+{
+    Impl& impl = *impl_;
+    impl.bufferPoolCapacity = numBuffers;
+    for (auto& bufferPool : impl.bufferPools)
+        bufferPool->setCapacity(numBuffers);
+}
+
+unsigned Resources::getBufferPoolCapacity() const noexcept
+{
+    return impl_->bufferPools.front()->getCapacity();
+}
+
+unsigned Resources::getMaxBuffersUsed() const noexcept
+{
+    unsigned maxBuffersUsed = 0;
+    for (const auto& bufferPool : impl_->bufferPools)
+        maxBuffersUsed = std::max(maxBuffersUsed, bufferPool->getMaxBuffersUsed());
+    return maxBuffersUsed;
+}
+
+unsigned Resources::getNumFailedBufferRequests() const noexcept
+{
+    unsigned numFailedRequests = 0;
+    for (const auto& bufferPool : impl_->bufferPools)
+        numFailedRequests += bufferPool->getNumFailedRequests();
+    return numFailedRequests;
+}
+
 void Resources::clearNonState()
 {
     Impl& impl = *impl_;
@@ -87,7 +155,19 @@ const SynthConfig& Resources::getSynthConfig() const noexcept
 
 const BufferPool& Resources::getBufferPool() const noexcept
 {
-    return impl_->bufferPool;
+    return *impl_->bufferPools.front();
+}
+
+BufferPool& Resources::getBufferPool(unsigned slot) noexcept
+{
+    ASSERT(slot < impl_->bufferPools.size());
+    return *impl_->bufferPools[slot];
+}
+
+FilterBank& Resources::getFilterBank(unsigned slot) noexcept
+{
+    ASSERT(slot < impl_->filterBanks.size());
+    return *impl_->filterBanks[slot];
 }
 
 const MidiState& Resources::getMidiState() const noexcept
@@ -12,6 +12,7 @@ namespace sfz {
 
 struct SynthConfig;
 class BufferPool;
+class FilterBank;
 class MidiState;
 class Logger;
 class CurveSet;
@@ -31,6 +32,31 @@ public:
 
     void setSampleRate(float samplerate);
     void setSamplesPerBlock(int samplesPerBlock);
+    /**
+     * @brief Set the number of threads which render voices concurrently.
+     * Each of them gets its own buffer pool, filter bank and modulation
+     * context.
+     *
+     */
+    void setNumRenderSlots(unsigned numSlots);
+    /**
+     * @brief Set the capacity of the buffer pools, in buffers of the block size.
+     *
+     */
+    void setBufferPoolCapacity(unsigned numBuffers);
+    unsigned getBufferPoolCapacity() const noexcept;
+    /**
+     * @brief Get the highest number of buffers which were in use at once
+     * in any of the buffer pools.
+     *
+     */
+    unsigned getMaxBuffersUsed() const noexcept;
+    /**
+     * @brief Get the number of buffer requests which the pools could not
+     * satisfy.
+     *
+     */
+    unsigned getNumFailedBufferRequests() const noexcept;
     /**
      * @brief Clear resources that are related to a currently loaded SFZ file
      *
@@ -62,6 +88,18 @@ public:
 
     #undef ACCESSOR_RW
 
+    /**
+     * @brief Get the buffer pool of a render slot. The accessor without
+     * argument returns the pool of slot 0, which is the calling thread.
+     *
+     */
+    BufferPool& getBufferPool(unsigned slot) noexcept;
+    /**
+     * @brief Get the filter bank of a render slot.
+     *
+     */
+    FilterBank& getFilterBank(unsigned slot) noexcept;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "SincResampler.h"
+#include "Interpolators.h"
+#include "WindowedSinc.h"
+#include "Buffer.h"
+#include "Config.h"
+#include "SIMDConfig.h"
+#include "utility/Debug.h"
+#include "simd/SincResamplerAVX2.h"
+#include "cpuid/cpuinfo.hpp"
+#include <simde/simde-features.h>
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+#include <simde/x86/sse.h>
+#endif
+#if SFIZZ_CPU_FAMILY_X86_64 || SFIZZ_CPU_FAMILY_I386
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+#include <array>
+
+namespace sfz {
+
+namespace {
+
+constexpr std::array<unsigned, 8> sincBankSizes {{ 8, 12, 16, 24, 36, 48, 60, 72 }};
+
+struct SincBankStorage {
+    SincBankStorage()
+    {
+        const unsigned numPhases = config::sincResamplerPhases;
+
+        for (unsigned b = 0; b < sincBankSizes.size(); ++b) {
+            const unsigned points = sincBankSizes[b];
+            const int j0 = 1 - int(points) / 2;
+            const double beta = SincInterpolatorDetail::getBetaForNumPoints(points);
+
+            Buffer<float>& memory = memories[b];
+            memory.resize((numPhases + 1) * points);
+            for (unsigned p = 0; p <= numPhases; ++p) {
+                const double coeff = double(p) / numPhases;
+                for (unsigned i = 0; i < points; ++i) {
+                    const double x = j0 + int(i) - coeff;
+                    memory[p * points + i] = static_cast<float>(
+                        WindowedSincDetail::calculateExact(x, points, beta));
+                }
+            }
+
+            banks[b].coeffs = memory.data();
+            banks[b].points = points;
+            banks[b].numPhases = numPhases;
+        }
+    }
+
+    std::array<Buffer<float>, sincBankSizes.size()> memories;
+    std::array<SincBank, sincBankSizes.size()> banks;
+};
+
+const SincBankStorage* sincBankStorage = nullptr;
+
+inline const float* getRow(const SincBank& bank, float coeff, float& mu)
+{
+    float pos = coeff * bank.numPhases;
+    int p = static_cast<int>(pos);
+    p = (p < 0) ? 0 : (p < int(bank.numPhases)) ? p : int(bank.numPhases) - 1;
+    mu = pos - p;
+    return bank.coeffs + p * bank.points;
+}
+
+//------------------------------------------------------------------------------
+// Default kernel, 128-bit vectors where available
+
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+/**
+ * Interpolate the frames 0 and 1, with the taps interpolated between the
+ * rows `h0` and `h1` and the next ones. The result is `{ l0, r0, l1, r1 }`,
+ * or `{ y0, y0, y1, y1 }` for a mono source.
+ */
+template <bool Stereo, class T>
+inline simde__m128 interpolatePair(
+    const float* h0, const float* h1, float mu0, float mu1,
+    const T* l0, const T* r0, const T* l1, const T* r1, unsigned points)
+{
+    const simde__m128 m0 = simde_mm_set1_ps(mu0);
+    const simde__m128 m1 = simde_mm_set1_ps(mu1);
+    simde__m128 yl0 = simde_mm_setzero_ps();
+    simde__m128 yr0 = simde_mm_setzero_ps();
+    simde__m128 yl1 = simde_mm_setzero_ps();
+    simde__m128 yr1 = simde_mm_setzero_ps();
+
+    for (unsigned i = 0; i < points; i += 4) {
+        simde__m128 a0 = simde_mm_loadu_ps(h0 + i);
+        simde__m128 c0 = simde_mm_add_ps(a0, simde_mm_mul_ps(m0, simde_mm_sub_ps(simde_mm_loadu_ps(h0 + points + i), a0)));
+        simde__m128 a1 = simde_mm_loadu_ps(h1 + i);
+        simde__m128 c1 = simde_mm_add_ps(a1, simde_mm_mul_ps(m1, simde_mm_sub_ps(simde_mm_loadu_ps(h1 + points + i), a1)));
+        yl0 = simde_mm_add_ps(yl0, simde_mm_mul_ps(c0, loadSamplesX4(l0 + i)));
+        yl1 = simde_mm_add_ps(yl1, simde_mm_mul_ps(c1, loadSamplesX4(l1 + i)));
+        if (Stereo) {
+            yr0 = simde_mm_add_ps(yr0, simde_mm_mul_ps(c0, loadSamplesX4(r0 + i)));
+            yr1 = simde_mm_add_ps(yr1, simde_mm_mul_ps(c1, loadSamplesX4(r1 + i)));
+        }
+    }
+
+    if (!Stereo) {
+        yr0 = yl0;
+        yr1 = yl1;
+    }
+
+    // sum the accumulators horizontally, all four at once
+    SIMDE_MM_TRANSPOSE4_PS(yl0, yr0, yl1, yr1);
+    return simde_mm_add_ps(simde_mm_add_ps(yl0, yr0), simde_mm_add_ps(yl1, yr1));
+}
+#endif
+
+template <bool Stereo, bool Adding, class T>
+void resample(
+    const SincBank& bank, const T* left, const T* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames, float scale)
+{
+    const unsigned points = bank.points;
+    const int j0 = 1 - int(points) / 2;
+
+#if SIMDE_NATURAL_VECTOR_SIZE_GE(128)
+    const simde__m128 mmScale = simde_mm_set1_ps(scale);
+    alignas(16) float y[4];
+
+    for (unsigned n = 0; n < numFrames; n += 2) {
+        // an odd frame at the end is paired with itself
+        const unsigned count = (n + 1 < numFrames) ? 2 : 1;
+        const unsigned n1 = n + count - 1;
+
+        float mu0;
+        float mu1;
+        const float* h0 = getRow(bank, coeffs[n], mu0);
+        const float* h1 = getRow(bank, coeffs[n1], mu1);
+        const int i0 = indices[n] + j0;
+        const int i1 = indices[n1] + j0;
+
+        simde__m128 result = interpolatePair<Stereo>(
+            h0, h1, mu0, mu1, left + i0, (Stereo ? right : left) + i0,
+            left + i1, (Stereo ? right : left) + i1, points);
+        simde_mm_store_ps(y, simde_mm_mul_ps(result, mmScale));
+#else
+    float y[2];
+
+    for (unsigned n = 0; n < numFrames; ++n) {
+        const unsigned count = 1;
+
+        float mu;
+        const float* h = getRow(bank, coeffs[n], mu);
+        const T* l = left + indices[n] + j0;
+        const T* r = (Stereo ? right : left) + indices[n] + j0;
+
+        float yl = 0.0f;
+        float yr = 0.0f;
+        for (unsigned i = 0; i < points; ++i) {
+            float c = h[i] + mu * (h[points + i] - h[i]);
+            yl += c * static_cast<float>(l[i]);
+            if (Stereo)
+                yr += c * static_cast<float>(r[i]);
+        }
+        y[0] = yl * scale;
+        y[1] = yr * scale;
+#endif
+
+        for (unsigned k = 0; k < count; ++k) {
+            if (Adding) {
+                const float g = addingGains[n + k];
+                outLeft[n + k] += g * y[2 * k];
+                if (Stereo)
+                    outRight[n + k] += g * y[2 * k + 1];
+            } else {
+                outLeft[n + k] = y[2 * k];
+                if (Stereo)
+                    outRight[n + k] = y[2 * k + 1];
+            }
+        }
+    }
+}
+
+template <class T>
+void resampleAny(
+    const SincBank& bank, const T* left, const T* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames, float scale)
+{
+    if (right) {
+        if (addingGains)
+            resample<true, true>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+        else
+            resample<true, false>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+    } else {
+        if (addingGains)
+            resample<false, true>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+        else
+            resample<false, false>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+    }
+}
+
+void sincResampleDefault(
+    const SincBank& bank, const float* left, const float* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    resampleAny(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, 1.0f);
+}
+
+void sincResampleDefault(
+    const SincBank& bank, const int16_t* left, const int16_t* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    resampleAny(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, 1.0f / 32768);
+}
+
+//------------------------------------------------------------------------------
+// Dispatch
+
+template <class T>
+using SincResampleKernel = void (*)(
+    const SincBank&, const T*, const T*, const int*, const float*,
+    const float*, float*, float*, unsigned);
+
+SincResampleKernel<float> sincResampleFloat = &sincResampleDefault;
+SincResampleKernel<int16_t> sincResampleInt16 = &sincResampleDefault;
+
+#if SFIZZ_CPU_FAMILY_X86_64 || SFIZZ_CPU_FAMILY_I386
+/**
+ * @brief Check the FMA3 flag of the processor, in the ECX register of the
+ * CPUID leaf 1, which the cpuid library does not report.
+ */
+bool cpuHasFMA()
+{
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 1);
+    const unsigned ecx = static_cast<unsigned>(registers[2]);
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+#endif
+    return (ecx & (1u << 12)) != 0;
+}
+#endif
+
+} // namespace
+
+void initializeSincResampler()
+{
+    static const SincBankStorage storage;
+    sincBankStorage = &storage;
+
+#if SFIZZ_CPU_FAMILY_X86_64 || SFIZZ_CPU_FAMILY_I386
+    cpuid::cpuinfo info;
+    if (info.has_avx2() && cpuHasFMA()) {
+        sincResampleFloat = &sincResampleAVX2;
+        sincResampleInt16 = &sincResampleAVX2;
+    }
+#endif
+}
+
+const SincBank& getSincBank(unsigned points)
+{
+    ASSERT(sincBankStorage);
+
+    unsigned b = 0;
+    while (b + 1 < sincBankSizes.size() && sincBankSizes[b] < points)
+        ++b;
+
+    ASSERT(sincBankSizes[b] == points);
+    return sincBankStorage->banks[b];
+}
+
+void sincResample(
+    unsigned points, const float* left, const float* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    sincResampleFloat(getSincBank(points), left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames);
+}
+
+void sincResample(
+    unsigned points, const int16_t* left, const int16_t* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    sincResampleInt16(getSincBank(points), left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames);
+}
+
+} // namespace sfz
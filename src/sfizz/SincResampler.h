@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include <cstdint>
+
+namespace sfz {
+
+/**
+ * @brief A polyphase bank of windowed-sinc coefficients.
+ *
+ * Row `p` holds the `points` taps of the interpolator for the fractional
+ * position `p / numPhases`, and an extra row is stored for the position 1,
+ * so the taps of any position are linearly interpolated between two
+ * consecutive rows. Each row is read with contiguous vector loads, instead
+ * of one table lookup per tap.
+ */
+struct SincBank {
+    const float* coeffs { nullptr };
+    unsigned points { 0 };
+    unsigned numPhases { 0 };
+};
+
+/**
+ * @brief Initialize the polyphase banks of the sinc resampler, and select
+ * its kernel for the running CPU.
+ *
+ * This is called by `initializeInterpolators`.
+ */
+void initializeSincResampler();
+
+/**
+ * @brief Get the polyphase bank of a windowed sinc
+ *
+ * @param points the number of points of the sinc, one of 8, 12, 16, 24, 36,
+ *               48, 60 or 72
+ */
+const SincBank& getSincBank(unsigned points);
+
+/**
+ * @brief Resample one or two channels with a windowed-sinc interpolator.
+ *
+ * The output frame `i` is interpolated around `source[indices[i]]` with the
+ * fractional position `coeffs[i]`, with the same padding requirements as
+ * `interpolate`. The channels share the computation of the taps.
+ *
+ * @param points the number of points of the sinc
+ * @param left the left source channel
+ * @param right the right source channel, or null for a mono source
+ * @param indices the integral source positions
+ * @param coeffs the fractional source positions, in [0, 1]
+ * @param addingGains the gains to mix the output into the destination with,
+ *                    or null to overwrite the destination
+ * @param outLeft the left destination
+ * @param outRight the right destination, unused for a mono source
+ * @param numFrames the number of frames to resample
+ */
+void sincResample(
+    unsigned points, const float* left, const float* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept;
+
+/**
+ * @brief Resample one or two channels of 16-bit integer samples, which are
+ * scaled to the [-1, 1] range
+ */
+void sincResample(
+    unsigned points, const int16_t* left, const int16_t* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept;
+
+} // namespace sfz
@@ -35,6 +35,7 @@
 #include <absl/types/optional.h>
 #include <absl/types/span.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <random>
@@ -61,6 +62,9 @@ Synth::Impl::Impl()
     initializeSIMDDispatchers();
     initializeInterpolators();
 
+    // the voices rendered together serially use a slot each
+    resources_.setNumRenderSlots(config::filterBankVoices);
+
     parser_.setListener(this);
     effectFactory_.registerStandardEffectTypes();
     initEffectBuses();
@@ -214,6 +218,8 @@ void Synth::Impl::buildRegion(const std::vector<Opcode>& regionOpcodes)
         voiceManager_.ensureNumPolyphonyGroups(lastRegion->group);
     }
 
+    voiceManager_.ensureRegionIndexes(*lastRegion);
+
     if (currentSet_ != nullptr) {
         lastRegion->parent = currentSet_;
         currentSet_->addRegion(lastRegion);
@@ -269,6 +275,8 @@ void Synth::Impl::clear()
         list.clear();
     for (auto& list : noteActivationLists_)
         list.clear();
+    for (auto& candidates : noteOnCandidates_)
+        candidates.clear();
     for (auto& list : ccActivationLists_)
         list.clear();
     previousKeyswitchLists_.clear();
@@ -567,6 +575,11 @@ void Synth::Impl::prepareSfzLoad(const fs::path& path)
 
     clear();
 
+    // The sample files may have changed since the last load
+    FilePool& filePool = resources_.getFilePool();
+    filePool.clearFileInformationCache();
+    filePool.clearDirectoryCache();
+
 #ifndef NDEBUG
     if (reloading) {
         DBG("[sfizz] Reloading the current file");
@@ -576,7 +589,6 @@ void Synth::Impl::prepareSfzLoad(const fs::path& path)
     if (!reloading) {
 
         // Clear the background queues and clear the filePool
-        auto& filePool = resources_.getFilePool();
         filePool.waitForBackgroundLoading();
         filePool.clear();
 
@@ -679,6 +691,16 @@ void Synth::Impl::finalizeSfzLoad()
 
     FlexEGs::clearUnusedCurves();
 
+    // Check the sample files and read their information in parallel
+    std::vector<FileId> sampleIds;
+    absl::flat_hash_map<FileId, size_t> sampleIndices;
+    for (const LayerPtr& layer : layers_) {
+        const Region& region = layer->getRegion();
+        if (!region.isGenerator() && sampleIndices.emplace(*region.sampleId, sampleIds.size()).second)
+            sampleIds.push_back(*region.sampleId);
+    }
+    const auto sampleInformation = filePool.checkAndGetFileInformation(absl::MakeSpan(sampleIds));
+
     while (currentRegionIndex < currentRegionCount) {
         Layer& layer = *layers_[currentRegionIndex];
         Region& region = layer.getRegion();
@@ -686,17 +708,16 @@ void Synth::Impl::finalizeSfzLoad()
         absl::optional<FileInformation> fileInformation;
 
         if (!region.isGenerator()) {
-            if (!filePool.checkSampleId(*region.sampleId)) {
-                removeCurrentRegion();
-                continue;
-            }
-
-            fileInformation = filePool.getFileInformation(*region.sampleId);
+            const size_t sampleIndex = sampleIndices[*region.sampleId];
+            fileInformation = sampleInformation[sampleIndex];
             if (!fileInformation) {
                 removeCurrentRegion();
                 continue;
             }
 
+            if (*region.sampleId != sampleIds[sampleIndex])
+                region.sampleId.reset(new FileId(sampleIds[sampleIndex]));
+
             region.hasWavetableSample = fileInformation->wavetable.has_value();
 
             if (fileInformation->end < config::wavetableMaxFrames) {
@@ -704,7 +725,7 @@ void Synth::Impl::finalizeSfzLoad()
                 bool allZeros = true;
                 int numChannels = sample->information.numChannels;
                 for (int i = 0; i < numChannels; ++i) {
-                    allZeros &= allWithin(sample->preloadedData.getConstSpan(i),
+                    allZeros &= allWithin(sample->head->data.getConstSpan(i),
                         -config::virtuallyZero, config::virtuallyZero);
                 }
 
@@ -842,8 +863,11 @@ void Synth::Impl::finalizeSfzLoad()
     if (reloading)
         filePool.resetPreloadCallCounts();
 
+    std::vector<std::pair<FileId, uint32_t>> preloadList;
+    preloadList.reserve(filesToLoad.size());
     for (const auto& toLoad: filesToLoad)
-        filePool.preloadFile(toLoad.first, toLoad.second);
+        preloadList.emplace_back(toLoad.first, static_cast<uint32_t>(toLoad.second));
+    filePool.preloadFiles(preloadList);
 
     // Remove preloaded data with no linked regions
     if (reloading)
@@ -906,6 +930,8 @@ void Synth::Impl::finalizeSfzLoad()
     // cache the set of used CCs for future access
     currentUsedCCs_ = collectAllUsedCCs();
 
+    buildNoteOnCandidates();
+
     // cache the set of keys assigned
     for (const LayerPtr& layerPtr : layers_) {
         const Region& region = layerPtr->getRegion();
@@ -1000,6 +1026,8 @@ void Synth::setSamplesPerBlock(int samplesPerBlock) noexcept
         voice.setSamplesPerBlock(samplesPerBlock);
 
     impl.resources_.setSamplesPerBlock(samplesPerBlock);
+    impl.filterBank_.setSamplesPerBlock(samplesPerBlock);
+    impl.resizeVoiceOutputs();
 
     for (int i = 0; i < impl.numOutputs_; ++i) {
         for (auto& bus : impl.getEffectBusesForOutput(i)) {
@@ -1024,6 +1052,7 @@ void Synth::setSampleRate(float sampleRate) noexcept
         voice.setSampleRate(sampleRate);
 
     impl.resources_.setSampleRate(sampleRate);
+    impl.filterBank_.setSampleRate(sampleRate);
 
     for (int i = 0; i < impl.numOutputs_; ++i) {
         for (auto& bus : impl.getEffectBusesForOutput(i)) {
@@ -1054,22 +1083,30 @@ void Synth::renderBlock(AudioSpan<float> buffer) noexcept
     FilePool& filePool = impl.resources_.getFilePool();
     BufferPool& bufferPool = impl.resources_.getBufferPool();
 
-    if (synthConfig.freeWheeling)
+    if (synthConfig.freeWheeling) {
         filePool.waitForBackgroundLoading();
+        filePool.waitForStreaming();
+    }
 
     const auto now = std::chrono::high_resolution_clock::now();
     const auto timeSinceLastCollection =
-        std::chrono::duration_cast<std::chrono::seconds>(now - impl.lastGarbageCollection_);
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - impl.lastGarbageCollection_);
+
+    // Collect more often when the samples do not fit in the memory budget
+    const auto collectionPeriod = filePool.isOverMemoryBudget() ?
+        std::chrono::milliseconds(config::memoryBudgetCheckPeriod) :
+        std::chrono::milliseconds(std::chrono::seconds(config::fileClearingPeriod));
 
-    if (timeSinceLastCollection.count() > config::fileClearingPeriod) {
+    if (timeSinceLastCollection > collectionPeriod) {
         impl.lastGarbageCollection_ = now;
         filePool.triggerGarbageCollection();
     }
 
-    auto tempSpan = bufferPool.getStereoBuffer(numFrames);
+    filePool.triggerStreaming();
+
     auto tempMixSpan = bufferPool.getStereoBuffer(numFrames);
     auto rampSpan = bufferPool.getBuffer(numFrames);
-    if (!tempSpan || !tempMixSpan || !rampSpan) {
+    if (!tempMixSpan || !rampSpan) {
         DBG("[sfizz] Could not get a temporary buffer; exiting callback... ");
         return;
     }
@@ -1102,32 +1139,98 @@ void Synth::renderBlock(AudioSpan<float> buffer) noexcept
         ScopedTiming logger { callbackBreakdown.renderMethod, ScopedTiming::Operation::addToDuration };
         tempMixSpan->fill(0.0f);
 
-        for (auto& voice : impl.voiceManager_) {
-            if (voice.isFree())
-                continue;
-
-            mm.beginVoice(voice.getId(), voice.getRegion()->getId(), voice.getTriggerEvent().value);
-
+        auto mixVoice = [&](Voice& voice, AudioSpan<float> voiceSpan) {
             const Region* region = voice.getRegion();
             ASSERT(region != nullptr);
             const auto& effectBuses = impl.getEffectBusesForOutput(region->output);
 
-            voice.renderBlock(*tempSpan);
             for (size_t i = 0, n = effectBuses.size(); i < n; ++i) {
                 if (auto& bus = effectBuses[i]) {
                     float addGain = region->getGainToEffectBus(i);
-                    bus->addToInputs(*tempSpan, addGain, numFrames);
+                    bus->addToInputs(voiceSpan, addGain, numFrames);
                 }
             }
             callbackBreakdown.data += voice.getLastDataDuration();
             callbackBreakdown.amplitude += voice.getLastAmplitudeDuration();
             callbackBreakdown.filters += voice.getLastFilterDuration();
             callbackBreakdown.panning += voice.getLastPanningDuration();
+        };
+
+        // Render the active voices in the order of their index, so that the
+        // mix does not depend on the order in which they were started
+        auto& renderVoices = impl.renderVoices_;
+        const auto& activeVoices = impl.voiceManager_.getActiveVoices();
+        renderVoices.assign(activeVoices.begin(), activeVoices.end());
+        absl::c_sort(renderVoices, [](const Voice* lhs, const Voice* rhs) {
+            return lhs->getId().number() < rhs->getId().number();
+        });
+
+        if (impl.renderPool_.getNumThreads() > 1 && renderVoices.size() >= config::parallelRenderMinVoices) {
+            // Render every voice into its own output, using the modulation
+            // context and the buffers of the thread which processes it.
+            // The outputs are mixed afterwards in the voice order, so the
+            // result does not depend on the scheduling.
+            mm.precomputePerCycle();
+
+            auto renderJob = [&impl, &mm, numFrames](unsigned index, unsigned slot) {
+                Voice& voice = *impl.renderVoices_[index];
+                mm.beginVoice(voice.getId(), voice.getRegion()->getId(), voice.getTriggerEvent().value, slot);
+                voice.renderBlock(AudioSpan<float>(*impl.voiceOutputs_[index]).first(numFrames), slot);
+                mm.endVoice(slot);
+            };
+            impl.renderPool_.parallelFor(static_cast<unsigned>(renderVoices.size()), renderJob);
+
+            for (size_t i = 0, n = renderVoices.size(); i < n; ++i) {
+                Voice& voice = *renderVoices[i];
+                mixVoice(voice, AudioSpan<float>(*impl.voiceOutputs_[i]).first(numFrames));
+
+                if (voice.toBeCleanedUp())
+                    voice.reset();
+            }
+        }
+        else {
+            // Render the voices in groups, whose filters get processed
+            // together in the filter bank. Every voice of a group uses its
+            // own slot, so its modulations persist between the steps.
+            FilterBank& filterBank = impl.filterBank_;
+            std::array<bool, config::filterBankVoices> rendering;
+
+            for (size_t first = 0, n = renderVoices.size(); first < n; first += config::filterBankVoices) {
+                const unsigned count = static_cast<unsigned>(std::min<size_t>(config::filterBankVoices, n - first));
+                auto voiceSpan = [&impl, numFrames](unsigned k) {
+                    return AudioSpan<float>(*impl.voiceOutputs_[k]).first(numFrames);
+                };
+
+                size_t numFilters = 0;
+                for (unsigned k = 0; k < count; ++k) {
+                    Voice& voice = *renderVoices[first + k];
+                    mm.beginVoice(voice.getId(), voice.getRegion()->getId(), voice.getTriggerEvent().value, k);
+                    rendering[k] = voice.startBlock(voiceSpan(k), k);
+                    if (rendering[k])
+                        numFilters = std::max(numFilters, voice.getRegion()->filters.size());
+                }
 
-            mm.endVoice();
+                for (size_t f = 0; f < numFilters; ++f) {
+                    for (unsigned k = 0; k < count; ++k) {
+                        if (rendering[k])
+                            renderVoices[first + k]->queueFilter(static_cast<unsigned>(f), voiceSpan(k), filterBank);
+                    }
 
-            if (voice.toBeCleanedUp())
-                voice.reset();
+                    ScopedTiming logger { callbackBreakdown.filters, ScopedTiming::Operation::addToDuration };
+                    filterBank.process();
+                }
+
+                for (unsigned k = 0; k < count; ++k) {
+                    Voice& voice = *renderVoices[first + k];
+                    if (rendering[k])
+                        voice.finishBlock(voiceSpan(k));
+                    mixVoice(voice, voiceSpan(k));
+                    mm.endVoice(k);
+
+                    if (voice.toBeCleanedUp())
+                        voice.reset();
+                }
+            }
         }
     }
 
@@ -1205,12 +1308,17 @@ void Synth::noteOn(int delay, int noteNumber, int velocity) noexcept
 
 void Synth::hdNoteOn(int delay, int noteNumber, float normalizedVelocity) noexcept
 {
-    ASSERT(noteNumber < 128);
-    ASSERT(noteNumber >= 0);
     Impl& impl = *impl_;
     ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
-    impl.resources_.getMidiState().noteOnEvent(delay, noteNumber, normalizedVelocity);
-    impl.noteOnDispatch(delay, noteNumber, normalizedVelocity);
+    impl.performNoteOn(delay, noteNumber, normalizedVelocity);
+}
+
+void Synth::Impl::performNoteOn(int delay, int noteNumber, float velocity) noexcept
+{
+    ASSERT(noteNumber < 128);
+    ASSERT(noteNumber >= 0);
+    resources_.getMidiState().noteOnEvent(delay, noteNumber, velocity);
+    noteOnDispatch(delay, noteNumber, velocity);
 }
 
 void Synth::noteOff(int delay, int noteNumber, int velocity) noexcept
@@ -1221,22 +1329,28 @@ void Synth::noteOff(int delay, int noteNumber, int velocity) noexcept
 
 void Synth::hdNoteOff(int delay, int noteNumber, float normalizedVelocity) noexcept
 {
-    ASSERT(noteNumber < 128);
-    ASSERT(noteNumber >= 0);
     Impl& impl = *impl_;
     ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
+    impl.performNoteOff(delay, noteNumber, normalizedVelocity);
+}
+
+void Synth::Impl::performNoteOff(int delay, int noteNumber, float velocity) noexcept
+{
+    ASSERT(noteNumber < 128);
+    ASSERT(noteNumber >= 0);
 
     // FIXME: Some keyboards (e.g. Casio PX5S) can send a real note-off velocity. In this case, do we have a
     // way in sfz to specify that a release trigger should NOT use the note-on velocity?
     // auto replacedVelocity = (velocity == 0 ? getNoteVelocity(noteNumber) : velocity);
-    MidiState& midiState = impl.resources_.getMidiState();
-    midiState.noteOffEvent(delay, noteNumber, normalizedVelocity);
+    MidiState& midiState = resources_.getMidiState();
+    midiState.noteOffEvent(delay, noteNumber, velocity);
     const auto replacedVelocity = midiState.getNoteVelocity(noteNumber);
 
-    for (auto& voice : impl.voiceManager_)
-        voice.registerNoteOff(delay, noteNumber, replacedVelocity);
+    // Releasing voices does not start nor stop any voice, so the index is stable
+    for (Voice* voice : voiceManager_.getVoicesByNote(noteNumber))
+        voice->registerNoteOff(delay, noteNumber, replacedVelocity);
 
-    impl.noteOffDispatch(delay, noteNumber, replacedVelocity);
+    noteOffDispatch(delay, noteNumber, replacedVelocity);
 }
 
 void Synth::Impl::startVoice(Layer* layer, int delay, const TriggerEvent& triggerEvent, SisterVoiceRingBuilder& ring) noexcept
@@ -1251,11 +1365,17 @@ void Synth::Impl::startVoice(Layer* layer, int delay, const TriggerEvent& trigge
     ASSERT(selectedVoice->isFree());
     if (selectedVoice->startVoice(layer, delay, triggerEvent))
         ring.addVoiceToRing(selectedVoice);
+    else if (selectedVoice->toBeCleanedUp())
+        selectedVoice->reset(); // the render loop only visits active voices
+
 }
 
 void Synth::Impl::checkOffGroups(const Region* region, int delay, int number)
 {
-    for (auto& voice : voiceManager_) {
+    // The note off dispatch can start voices, which get appended to the index
+    const std::vector<Voice*>& voices = voiceManager_.getVoicesByOffGroup(region->group);
+    for (size_t i = 0; i < voices.size(); ++i) {
+        Voice& voice = *voices[i];
         if (voice.checkOffGroup(region, delay, number)) {
             const TriggerEvent& event = voice.getTriggerEvent();
             if (event.type == TriggerEventType::NoteOn)
@@ -1310,8 +1430,12 @@ void Synth::Impl::noteOnDispatch(int delay, int noteNumber, float velocity) noex
     for (Layer* layer : downKeyswitchLists_[noteNumber])
         layer->keySwitched_ = true;
 
-    for (Layer* layer : noteActivationLists_[noteNumber]) {
-        if (layer->registerNoteOn(noteNumber, velocity, randValue)) {
+    NoteOnCandidates& candidates = noteOnCandidates_[noteNumber];
+    for (Layer* layer : candidates.sequenced)
+        layer->advanceSequence();
+
+    for (Layer* layer : candidates.bucket(velocity)) {
+        if (layer->triggersOnNote(noteNumber, velocity, randValue)) {
             const Region& region = layer->getRegion();
             checkOffGroups(&region, delay, noteNumber);
             TriggerEvent triggerEvent { TriggerEventType::NoteOn, noteNumber, velocity };
@@ -1325,6 +1449,41 @@ void Synth::Impl::noteOnDispatch(int delay, int noteNumber, float velocity) noex
     }
 }
 
+void Synth::Impl::buildNoteOnCandidates()
+{
+    constexpr int numBuckets = NoteOnCandidates::numVelocityBuckets;
+
+    for (int note = 0; note < 128; ++note) {
+        NoteOnCandidates& candidates = noteOnCandidates_[note];
+        candidates.clear();
+
+        const LayerViewVector& activationList = noteActivationLists_[note];
+        for (Layer* layer : activationList) {
+            if (layer->hasSequence())
+                candidates.sequenced.push_back(layer);
+        }
+
+        for (int index = 0; index < numBuckets; ++index) {
+            candidates.bucketStarts[index] = static_cast<uint32_t>(candidates.layers.size());
+            for (Layer* layer : activationList) {
+                if (!layer->canTriggerOnNoteOn())
+                    continue;
+
+                // The bucket holds the velocities v such that index <= v * numBuckets < index + 1,
+                // the last one also holding 1. With `sw_vel=previous`, the velocity is replaced.
+                const Region& region = layer->getRegion();
+                const UncheckedRange<float>& range = region.velocityRange;
+                const bool inBucket = region.velocityOverride == VelocityOverride::previous
+                    || ((range.getStart() * numBuckets < index + 1 || index == numBuckets - 1)
+                        && range.getEnd() * numBuckets >= index);
+                if (inBucket)
+                    candidates.layers.push_back(layer);
+            }
+        }
+        candidates.bucketStarts[numBuckets] = static_cast<uint32_t>(candidates.layers.size());
+    }
+}
+
 void Synth::Impl::startDelayedSustainReleases(Layer* layer, int delay, SisterVoiceRingBuilder& ring) noexcept
 {
     const Region& region = layer->getRegion();
@@ -1396,12 +1555,14 @@ void Synth::Impl::ccDispatch(int delay, int ccNumber, float value) noexcept
 void Synth::hdcc(int delay, int ccNumber, float normValue) noexcept
 {
     Impl& impl = *impl_;
+    ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
     impl.performHdcc(delay, ccNumber, normValue, true);
 }
 
 void Synth::automateHdcc(int delay, int ccNumber, float normValue) noexcept
 {
     Impl& impl = *impl_;
+    ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
     impl.performHdcc(delay, ccNumber, normValue, false);
 }
 
@@ -1410,8 +1571,6 @@ void Synth::Impl::performHdcc(int delay, int ccNumber, float normValue, bool asM
     ASSERT(ccNumber < config::numCCs);
     ASSERT(ccNumber >= 0);
 
-    ScopedTiming logger { dispatchDuration_, ScopedTiming::Operation::addToDuration };
-
     changedCCsThisCycle_.set(ccNumber);
 
     MidiState& midiState = resources_.getMidiState();
@@ -1430,8 +1589,8 @@ void Synth::Impl::performHdcc(int delay, int ccNumber, float normValue, bool asM
         }
     }
 
-    for (auto& voice : voiceManager_)
-        voice.registerCC(delay, ccNumber, normValue);
+    for (Voice* voice : voiceManager_.getVoicesByCC(ccNumber))
+        voice->registerCC(delay, ccNumber, normValue);
 
     ccDispatch(delay, ccNumber, normValue);
     midiState.ccEvent(delay, ccNumber, normValue);
@@ -1469,19 +1628,23 @@ void Synth::pitchWheel(int delay, int pitch) noexcept
 void Synth::hdPitchWheel(int delay, float normalizedPitch) noexcept
 {
     Impl& impl = *impl_;
-
     ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
-    impl.resources_.getMidiState().pitchBendEvent(delay, normalizedPitch);
+    impl.performPitchWheel(delay, normalizedPitch);
+}
 
-    for (const Impl::LayerPtr& layer : impl.layers_) {
-        layer->registerPitchWheel(normalizedPitch);
+void Synth::Impl::performPitchWheel(int delay, float pitch) noexcept
+{
+    resources_.getMidiState().pitchBendEvent(delay, pitch);
+
+    for (const LayerPtr& layer : layers_) {
+        layer->registerPitchWheel(pitch);
     }
 
-    for (auto& voice : impl.voiceManager_) {
-        voice.registerPitchWheel(delay, normalizedPitch);
+    for (Voice* voice : voiceManager_.getActiveVoices()) {
+        voice->registerPitchWheel(delay, pitch);
     }
 
-    impl.performHdcc(delay, ExtendedCCs::pitchBend, normalizedPitch, false);
+    performHdcc(delay, ExtendedCCs::pitchBend, pitch, false);
 }
 
 void Synth::channelAftertouch(int delay, int aftertouch) noexcept
@@ -1494,18 +1657,22 @@ void Synth::hdChannelAftertouch(int delay, float normAftertouch) noexcept
 {
     Impl& impl = *impl_;
     ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
+    impl.performChannelAftertouch(delay, normAftertouch);
+}
 
-    impl.resources_.getMidiState().channelAftertouchEvent(delay, normAftertouch);
+void Synth::Impl::performChannelAftertouch(int delay, float aftertouch) noexcept
+{
+    resources_.getMidiState().channelAftertouchEvent(delay, aftertouch);
 
-    for (const Impl::LayerPtr& layerPtr : impl.layers_) {
-        layerPtr->registerAftertouch(normAftertouch);
+    for (const LayerPtr& layerPtr : layers_) {
+        layerPtr->registerAftertouch(aftertouch);
     }
 
-    for (auto& voice : impl.voiceManager_) {
-        voice.registerAftertouch(delay, normAftertouch);
+    for (Voice* voice : voiceManager_.getActiveVoices()) {
+        voice->registerAftertouch(delay, aftertouch);
     }
 
-    impl.performHdcc(delay, ExtendedCCs::channelAftertouch, normAftertouch, false);
+    performHdcc(delay, ExtendedCCs::channelAftertouch, aftertouch, false);
 }
 
 void Synth::polyAftertouch(int delay, int noteNumber, int aftertouch) noexcept
@@ -1518,14 +1685,107 @@ void Synth::hdPolyAftertouch(int delay, int noteNumber, float normAftertouch) no
 {
     Impl& impl = *impl_;
     ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
+    impl.performPolyAftertouch(delay, noteNumber, normAftertouch);
+}
 
-    impl.resources_.getMidiState().polyAftertouchEvent(delay, noteNumber, normAftertouch);
+void Synth::Impl::performPolyAftertouch(int delay, int noteNumber, float aftertouch) noexcept
+{
+    resources_.getMidiState().polyAftertouchEvent(delay, noteNumber, aftertouch);
 
-    for (auto& voice : impl.voiceManager_)
-        voice.registerPolyAftertouch(delay, noteNumber, normAftertouch);
+    for (Voice* voice : voiceManager_.getActiveVoices())
+        voice->registerPolyAftertouch(delay, noteNumber, aftertouch);
 
     // Note information is lost on this CC
-    impl.performHdcc(delay, ExtendedCCs::polyphonicAftertouch, normAftertouch, false);
+    performHdcc(delay, ExtendedCCs::polyphonicAftertouch, aftertouch, false);
+}
+
+bool Synth::Impl::isStateOnlyCC(int ccNumber) const noexcept
+{
+    if (!ccActivationLists_[ccNumber].empty())
+        return false;
+    if (ccNumber < 128 && sustainOrSostenuto_.test(ccNumber))
+        return false;
+    return true;
+}
+
+/**
+ * @brief Check whether a batched event is superseded by a later event of the same
+ * type and number at the same delay. A note event in between observes the value of
+ * the first event, which is then kept, and so are the events of controllers which
+ * trigger regions or act as pedals, since each of them may change what sounds.
+ */
+bool Synth::Impl::isSupersededInBatch(const Event* events, size_t numEvents, size_t index) const noexcept
+{
+    const Synth::Event& event = events[index];
+    switch (event.type) {
+    case Synth::EventCC:
+        if (event.number < 0 || event.number >= config::numCCs || !isStateOnlyCC(event.number))
+            return false;
+        break;
+    case Synth::EventPitchWheel:
+        if (!isStateOnlyCC(ExtendedCCs::pitchBend))
+            return false;
+        break;
+    case Synth::EventChannelAftertouch:
+        if (!isStateOnlyCC(ExtendedCCs::channelAftertouch))
+            return false;
+        break;
+    case Synth::EventPolyAftertouch:
+        if (!isStateOnlyCC(ExtendedCCs::polyphonicAftertouch))
+            return false;
+        break;
+    default:
+        return false;
+    }
+
+    for (size_t i = index + 1; i < numEvents && events[i].delay == event.delay; ++i) {
+        const Synth::Event& other = events[i];
+        if (other.type == Synth::EventNoteOn || other.type == Synth::EventNoteOff)
+            return false;
+        const bool channelWide = event.type == Synth::EventPitchWheel || event.type == Synth::EventChannelAftertouch;
+        if (other.type == event.type && (channelWide || other.number == event.number))
+            return true;
+    }
+    return false;
+}
+
+void Synth::sendEvents(const Event* events, size_t numEvents) noexcept
+{
+    Impl& impl = *impl_;
+    ScopedTiming logger { impl.dispatchDuration_, ScopedTiming::Operation::addToDuration };
+
+    for (size_t i = 0; i < numEvents; ++i) {
+        const Event& event = events[i];
+        ASSERT(i == 0 || events[i - 1].delay <= event.delay);
+
+        switch (event.type) {
+        case EventNoteOn:
+            impl.performNoteOn(event.delay, event.number, event.value);
+            break;
+        case EventNoteOff:
+            impl.performNoteOff(event.delay, event.number, event.value);
+            break;
+        case EventCC:
+            if (!impl.isSupersededInBatch(events, numEvents, i))
+                impl.performHdcc(event.delay, event.number, event.value, true);
+            break;
+        case EventPitchWheel:
+            if (!impl.isSupersededInBatch(events, numEvents, i))
+                impl.performPitchWheel(event.delay, event.value);
+            break;
+        case EventChannelAftertouch:
+            if (!impl.isSupersededInBatch(events, numEvents, i))
+                impl.performChannelAftertouch(event.delay, event.value);
+            break;
+        case EventPolyAftertouch:
+            if (!impl.isSupersededInBatch(events, numEvents, i))
+                impl.performPolyAftertouch(event.delay, event.number, event.value);
+            break;
+        default:
+            DBG("[sfizz] Unknown event type " << event.type << " in a batch");
+            break;
+        }
+    }
 }
 
 void Synth::tempo(int delay, float secondsPerBeat) noexcept
@@ -1904,6 +2164,10 @@ void Synth::Impl::resetVoices(int numVoices)
     }
 
     applySettingsPerVoice();
+    resizeVoiceOutputs();
+    if (genController_) // not created yet when first called from the constructor
+        genController_->setupVoiceSmoothers(config::calculateActualVoices(numVoices_));
+    resources_.getFilePool().setNumStreams(config::calculateActualVoices(numVoices_));
 }
 
 void Synth::Impl::applySettingsPerVoice()
@@ -1921,6 +2185,39 @@ void Synth::Impl::applySettingsPerVoice()
     }
 }
 
+void Synth::Impl::resizeVoiceOutputs()
+{
+    const size_t numVoices = config::calculateActualVoices(numVoices_);
+    renderVoices_.clear();
+    renderVoices_.reserve(numVoices);
+
+    // the serial rendering only needs the outputs of a group of voices
+    size_t numOutputs = config::filterBankVoices;
+    if (renderPool_.getNumThreads() > 1)
+        numOutputs = std::max(numOutputs, numVoices);
+
+    voiceOutputs_.resize(numOutputs);
+    for (auto& output : voiceOutputs_)
+        output.reset(new AudioBuffer<float>(2, samplesPerBlock_));
+}
+
+int Synth::getNumRenderThreads() const noexcept
+{
+    Impl& impl = *impl_;
+    return static_cast<int>(impl.renderPool_.getNumThreads());
+}
+
+void Synth::setNumRenderThreads(int numThreads) noexcept
+{
+    ASSERT(numThreads > 0);
+    Impl& impl = *impl_;
+
+    const unsigned newNumThreads = static_cast<unsigned>(std::max(1, numThreads));
+    impl.renderPool_.setNumThreads(newNumThreads);
+    impl.resources_.setNumRenderSlots(std::max(impl.renderPool_.getNumThreads(), config::filterBankVoices));
+    impl.resizeVoiceOutputs();
+}
+
 void Synth::Impl::setupModMatrix()
 {
     ModMatrix& mm = resources_.getModMatrix();
@@ -1999,6 +2296,7 @@ void Synth::Impl::setupModMatrix()
     }
 
     mm.init();
+    genController_->setupVoiceSmoothers(config::calculateActualVoices(numVoices_));
 }
 
 void Synth::setPreloadSize(uint32_t preloadSize) noexcept
@@ -2019,6 +2317,140 @@ uint32_t Synth::getPreloadSize() const noexcept
     return impl.resources_.getFilePool().getPreloadSize();
 }
 
+void Synth::setDiskStreaming(bool diskStreaming) noexcept
+{
+    Impl& impl = *impl_;
+    FilePool& filePool = impl.resources_.getFilePool();
+
+    // fast path
+    if (diskStreaming == filePool.getDiskStreaming())
+        return;
+
+    // the voices must let go of their streams before these get reallocated
+    for (auto& voice : impl.voiceManager_)
+        voice.reset();
+
+    filePool.setDiskStreaming(diskStreaming);
+}
+
+bool Synth::getDiskStreaming() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getDiskStreaming();
+}
+
+void Synth::setCompactSampleStorage(bool compactStorage) noexcept
+{
+    Impl& impl = *impl_;
+    FilePool& filePool = impl.resources_.getFilePool();
+
+    // fast path
+    if (compactStorage == filePool.getCompactStorage())
+        return;
+
+    // the voices read the sample data which is about to be replaced
+    for (auto& voice : impl.voiceManager_)
+        voice.reset();
+
+    filePool.setCompactStorage(compactStorage);
+}
+
+bool Synth::getCompactSampleStorage() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getCompactStorage();
+}
+
+void Synth::setPreloadCacheDirectory(const fs::path& directory)
+{
+    Impl& impl = *impl_;
+    impl.resources_.getFilePool().setPreloadCacheDirectory(directory);
+}
+
+const fs::path& Synth::getPreloadCacheDirectory() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getPreloadCacheDirectory();
+}
+
+void Synth::setSampleSharing(bool sampleSharing) noexcept
+{
+    Impl& impl = *impl_;
+    impl.resources_.getFilePool().setSampleSharing(sampleSharing);
+}
+
+bool Synth::getSampleSharing() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getSampleSharing();
+}
+
+void Synth::setBufferPoolCapacity(unsigned numBuffers)
+{
+    Impl& impl = *impl_;
+    impl.resources_.setBufferPoolCapacity(numBuffers);
+}
+
+unsigned Synth::getBufferPoolCapacity() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getBufferPoolCapacity();
+}
+
+unsigned Synth::getMaxBuffersUsed() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getMaxBuffersUsed();
+}
+
+unsigned Synth::getNumFailedBufferRequests() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getNumFailedBufferRequests();
+}
+
+void Synth::setControlRateModulation(bool controlRate) noexcept
+{
+    Impl& impl = *impl_;
+    impl.resources_.getModMatrix().setControlRate(controlRate);
+}
+
+bool Synth::getControlRateModulation() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getModMatrix().isControlRate();
+}
+
+void Synth::setSampleMemoryBudget(size_t numBytes) noexcept
+{
+    Impl& impl = *impl_;
+    impl.resources_.getFilePool().setMemoryBudget(numBytes);
+}
+
+size_t Synth::getSampleMemoryBudget() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getMemoryBudget();
+}
+
+size_t Synth::getSampleMemoryUsage() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getMemoryUsage();
+}
+
+size_t Synth::getNumSampleEvictions() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getNumEvictions();
+}
+
+size_t Synth::getSampleEvictedBytes() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.resources_.getFilePool().getEvictedBytes();
+}
+
 void Synth::enableFreeWheeling() noexcept
 {
     Impl& impl = *impl_;
@@ -2045,10 +2477,12 @@ void Synth::Impl::resetAllControllers(int delay) noexcept
     for (int cc = 0; cc < config::numCCs; ++cc)
         midiState.ccEvent(delay, cc, defaultCCValues_[cc]);
 
-    for (auto& voice : voiceManager_) {
-        voice.registerPitchWheel(delay, 0);
-        for (int cc = 0; cc < config::numCCs; ++cc)
-            voice.registerCC(delay, cc, defaultCCValues_[cc]);
+    for (Voice* voice : voiceManager_.getActiveVoices())
+        voice->registerPitchWheel(delay, 0);
+
+    for (int cc = 0; cc < config::numCCs; ++cc) {
+        for (Voice* voice : voiceManager_.getVoicesByCC(cc))
+            voice->registerCC(delay, cc, defaultCCValues_[cc]);
     }
 
     for (const LayerPtr& layerPtr : layers_) {
@@ -2108,8 +2542,10 @@ void Synth::disableLogging() noexcept
 void Synth::allSoundOff() noexcept
 {
     Impl& impl = *impl_;
-    for (auto& voice : impl.voiceManager_)
-        voice.reset();
+    // Resetting a voice removes it from the active voices
+    const auto& activeVoices = impl.voiceManager_.getActiveVoices();
+    while (!activeVoices.empty())
+        activeVoices.back()->reset();
     for (int i = 0; i < impl.numOutputs_; ++i) {
         for (auto& effectBus : impl.getEffectBusesForOutput(i))
             if (effectBus)
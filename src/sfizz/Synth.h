@@ -92,6 +92,28 @@ public:
         ProcessFreewheeling,
     };
 
+    /**
+     * @brief Type of an event sent in a batch with sendEvents()
+     */
+    enum EventType {
+        EventNoteOn,
+        EventNoteOff,
+        EventCC,
+        EventPitchWheel,
+        EventChannelAftertouch,
+        EventPolyAftertouch,
+    };
+
+    /**
+     * @brief A high-precision event sent in a batch with sendEvents()
+     */
+    struct Event {
+        int delay; // the delay in the block
+        int type; // the EventType
+        int number; // the note or CC number, unused by the channel-wide events
+        float value; // the normalized velocity, CC value, pitch or aftertouch
+    };
+
     /**
      * @brief Empties the current regions and load a new SFZ file into the synth.
      *
@@ -499,6 +521,18 @@ public:
      * @param normAftertouch
      */
     void hdPolyAftertouch(int delay, int noteNumber, float normAftertouch) noexcept;
+    /**
+     * @brief Send a batch of high-precision events to the synth, which are
+     * dispatched in a single pass. An event which is followed at the same
+     * delay by another of the same type and number, with no note event in
+     * between, is superseded by it and skipped, unless regions trigger on its
+     * controller or the controller is a sustain or sostenuto pedal.
+     *
+     * @param events the events, sorted by delay; the delays should be lower than
+     *               the size of the block in the next call to renderBlock().
+     * @param numEvents the number of events
+     */
+    void sendEvents(const Event* events, size_t numEvents) noexcept;
     /**
      * @brief       Send the time signature.
      *
@@ -563,6 +597,24 @@ public:
      * @param numVoices
      */
     void setNumVoices(int numVoices) noexcept;
+    /**
+     * @brief Get the number of threads which render the voices, including
+     * the thread which calls `renderBlock`.
+     *
+     * @return int
+     */
+    int getNumRenderThreads() const noexcept;
+    /**
+     * @brief Change the number of threads which render the voices, including
+     * the thread which calls `renderBlock`. With a single thread, which is
+     * the default, the voices are rendered serially. Otherwise, the active
+     * voices are distributed over a pool of worker threads, and their outputs
+     * are mixed in a deterministic order.
+     * This function starts or stops threads; call it out of the RT thread.
+     *
+     * @param numThreads
+     */
+    void setNumRenderThreads(int numThreads) noexcept;
 
     /**
      * @brief Set the preloaded file size.
@@ -582,6 +634,127 @@ public:
      */
     uint32_t getPreloadSize() const noexcept;
 
+    /**
+     * @brief Enable or disable disk streaming. When enabled, the samples
+     * which are not looped are read from the disk through a fixed-size window
+     * per voice, which bounds the memory used by the playing samples. The
+     * looped samples are still loaded entirely in memory.
+     * This function stops all the voices and allocates memory; call it out
+     * of the RT thread.
+     *
+     * @param diskStreaming
+     */
+    void setDiskStreaming(bool diskStreaming) noexcept;
+
+    /**
+     * @brief Get whether disk streaming is enabled.
+     *
+     * @return bool
+     */
+    bool getDiskStreaming() const noexcept;
+
+    /**
+     * @brief Enable or disable the compact storage of samples. When enabled,
+     * the 16-bit files are kept in memory in their native format and
+     * converted to float during interpolation, which halves their memory
+     * footprint. Other formats are still stored as float.
+     * This function stops all the voices and reloads the preloaded data; call
+     * it out of the RT thread.
+     *
+     * @param compactStorage
+     */
+    void setCompactSampleStorage(bool compactStorage) noexcept;
+
+    /**
+     * @brief Get whether the compact storage of samples is enabled.
+     *
+     * @return bool
+     */
+    bool getCompactSampleStorage() const noexcept;
+
+    /**
+     * @brief Set the directory of the persistent preload cache. The file
+     * information and the decoded preloaded data of the samples are stored
+     * there, and reused by later loads as long as the sample files keep their
+     * size and modification time. An empty path disables the cache.
+     * The directory is used from the next instrument load; call this function
+     * out of the RT thread.
+     *
+     * @param directory
+     */
+    void setPreloadCacheDirectory(const fs::path& directory);
+
+    /**
+     * @brief Get the directory of the persistent preload cache, or an empty
+     * path if it is disabled.
+     */
+    const fs::path& getPreloadCacheDirectory() const noexcept;
+
+    /**
+     * @brief Set whether the preloaded sample data is shared with the other
+     * synth instances of the process which enable sharing. Instruments which
+     * use the same sample files then keep a single copy of their preloaded
+     * data in memory. The setting is used from the next instrument load;
+     * call this function out of the RT thread.
+     *
+     * @param sampleSharing
+     */
+    void setSampleSharing(bool sampleSharing) noexcept;
+
+    /**
+     * @brief Get whether the preloaded sample data is shared with the other
+     * synth instances.
+     */
+    bool getSampleSharing() const noexcept;
+
+    /**
+     * @brief Enable or disable the control-rate evaluation of modulations.
+     * When enabled, the modulation sources which only drive filter and
+     * equalizer parameters are evaluated once every control interval instead
+     * of every frame, and hold their values in between. These parameters are
+     * only read at control rate, so this saves processing at little cost.
+     *
+     * @param controlRate
+     */
+    void setControlRateModulation(bool controlRate) noexcept;
+
+    /**
+     * @brief Get whether the control-rate evaluation of modulations is enabled.
+     */
+    bool getControlRateModulation() const noexcept;
+
+    /**
+     * @brief Set the memory budget of the sample data, in bytes, or 0 to
+     * disable it. Over the budget, the files which were entirely loaded in
+     * the background are released, the least recently used first, as soon
+     * as no voice plays them. The preloaded data counts against the budget
+     * but is never released.
+     *
+     * @param numBytes
+     */
+    void setSampleMemoryBudget(size_t numBytes) noexcept;
+
+    /**
+     * @brief Get the memory budget of the sample data, in bytes.
+     */
+    size_t getSampleMemoryBudget() const noexcept;
+
+    /**
+     * @brief Get the memory used by the sample data, in bytes.
+     */
+    size_t getSampleMemoryUsage() const noexcept;
+
+    /**
+     * @brief Get the number of files released to fit in the memory budget.
+     */
+    size_t getNumSampleEvictions() const noexcept;
+
+    /**
+     * @brief Get the amount of sample data released to fit in the memory
+     * budget, in bytes.
+     */
+    size_t getSampleEvictedBytes() const noexcept;
+
     /**
      * @brief Gets the number of allocated buffers.
      *
@@ -596,10 +769,38 @@ public:
      */
     int getAllocatedBytes() const noexcept { return Buffer<float>::counter().getTotalBytes(); }
 
+    /**
+     * @brief Set the capacity of the scratch buffer pools, in buffers of the
+     * block size. Every rendering thread has its own pool. Call this function
+     * out of the RT thread.
+     *
+     * @param numBuffers
+     */
+    void setBufferPoolCapacity(unsigned numBuffers);
+
+    /**
+     * @brief Get the capacity of the scratch buffer pools, in buffers of the
+     * block size.
+     */
+    unsigned getBufferPoolCapacity() const noexcept;
+
+    /**
+     * @brief Get the highest number of scratch buffers which were in use at
+     * once by a rendering thread.
+     */
+    unsigned getMaxBuffersUsed() const noexcept;
+
+    /**
+     * @brief Get the number of scratch buffer requests which failed because
+     * a pool was exhausted. Each failure causes some processing to be skipped.
+     */
+    unsigned getNumFailedBufferRequests() const noexcept;
+
     /**
      * @brief Enable freewheeling on the synth. This will wait for background
-     * loaded files to finish loading before each render callback to ensure that
-     * there will be no dropouts.
+     * loaded files to finish loading, and for the streamed files to fill their
+     * window, before each render callback to ensure that there will be no
+     * dropouts.
      *
      */
     void enableFreeWheeling() noexcept;
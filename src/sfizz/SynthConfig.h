@@ -30,5 +30,9 @@ struct SynthConfig
     }
 
     bool sustainCancelsRelease { Default::sustainCancelsRelease };
+
+    // play the samples of constant pitch without the position buffers;
+    // disabling it forces the general path, to compare against it
+    bool constantRatioFastPath { true };
 };
 }
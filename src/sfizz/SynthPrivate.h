@@ -7,6 +7,9 @@
 #include "VoiceManager.h"
 #include "Layer.h"
 #include "BitArray.h"
+#include "RenderPool.h"
+#include "AudioBuffer.h"
+#include "FilterBank.h"
 #include "modulations/sources/ADSREnvelope.h"
 #include "modulations/sources/Controller.h"
 #include "modulations/sources/FlexEnvelope.h"
@@ -15,6 +18,7 @@
 #include "modulations/sources/LFO.h"
 #include "parser/Parser.h"
 #include "parser/ParserListener.h"
+#include <absl/types/span.h>
 
 namespace sfz {
 
@@ -107,6 +111,11 @@ struct Synth::Impl final: public Parser::Listener {
      * @brief Make the stored settings take effect in all the voices
      */
     void applySettingsPerVoice();
+    /**
+     * @brief Allocate the voice outputs for parallel rendering, if enabled.
+     * They are released if the rendering is serial.
+     */
+    void resizeVoiceOutputs();
 
     /**
      * @brief Establish all connections of the modulation matrix.
@@ -138,6 +147,12 @@ struct Synth::Impl final: public Parser::Listener {
      */
     void noteOffDispatch(int delay, int noteNumber, float velocity) noexcept;
 
+    /**
+     * @brief Build the note on candidates of each key from the note
+     * activation lists.
+     */
+    void buildNoteOnCandidates();
+
     /**
      * @brief Check all regions and start voices for cc events
      *
@@ -147,6 +162,25 @@ struct Synth::Impl final: public Parser::Listener {
      */
     void ccDispatch(int delay, int ccNumber, float value) noexcept;
 
+    /**
+     * @brief Check whether the events of a controller only change its state,
+     * so that one of them may be dropped in favor of a later one. This is not
+     * the case if regions trigger on the controller, or if it is a pedal.
+     *
+     * @param ccNumber
+     */
+    bool isStateOnlyCC(int ccNumber) const noexcept;
+
+    /**
+     * @brief Check whether a batched event is superseded by a later event of
+     * the same type and number at the same delay.
+     *
+     * @param events
+     * @param numEvents
+     * @param index
+     */
+    bool isSupersededInBatch(const Event* events, size_t numEvents, size_t index) const noexcept;
+
     /**
      * @brief Start a voice for a specific region.
      * This will do the needed polyphony checks and voice stealing.
@@ -219,6 +253,49 @@ struct Synth::Impl final: public Parser::Listener {
     void setKeyswitchLabel(int swNumber, std::string name);
     void clearKeyswitchLabels();
 
+    /**
+     * @brief Perform a note on event
+     *
+     * @param delay
+     * @param noteNumber
+     * @param velocity
+     */
+    void performNoteOn(int delay, int noteNumber, float velocity) noexcept;
+
+    /**
+     * @brief Perform a note off event
+     *
+     * @param delay
+     * @param noteNumber
+     * @param velocity
+     */
+    void performNoteOff(int delay, int noteNumber, float velocity) noexcept;
+
+    /**
+     * @brief Perform a pitch wheel event
+     *
+     * @param delay
+     * @param pitch
+     */
+    void performPitchWheel(int delay, float pitch) noexcept;
+
+    /**
+     * @brief Perform a channel aftertouch event
+     *
+     * @param delay
+     * @param aftertouch
+     */
+    void performChannelAftertouch(int delay, float aftertouch) noexcept;
+
+    /**
+     * @brief Perform a polyphonic aftertouch event
+     *
+     * @param delay
+     * @param noteNumber
+     * @param aftertouch
+     */
+    void performPolyAftertouch(int delay, int noteNumber, float aftertouch) noexcept;
+
     /**
      * @brief Perform a CC event
      *
@@ -289,6 +366,39 @@ struct Synth::Impl final: public Parser::Listener {
     std::array<LayerViewVector, 128> upKeyswitchLists_;
     LayerViewVector previousKeyswitchLists_;
     std::array<LayerViewVector, 128> noteActivationLists_;
+
+    /**
+     * @brief The layers which may start on a note on event for a key, split
+     * into velocity buckets so that a note on only checks the layers whose
+     * velocity range it can hit. Layers which never trigger on a note on are
+     * left out.
+     */
+    struct NoteOnCandidates {
+        static constexpr int numVelocityBuckets = 16;
+        // The layers of all buckets, one bucket after the other, each in the region order
+        LayerViewVector layers;
+        std::array<uint32_t, numVelocityBuckets + 1> bucketStarts {};
+        // The layers of the key with a round-robin sequence to advance
+        LayerViewVector sequenced;
+
+        static int bucketIndex(float velocity) noexcept
+        {
+            return std::min(static_cast<int>(velocity * numVelocityBuckets), numVelocityBuckets - 1);
+        }
+        absl::Span<Layer* const> bucket(float velocity) const noexcept
+        {
+            const int index = bucketIndex(velocity);
+            return absl::MakeConstSpan(layers).subspan(
+                bucketStarts[index], bucketStarts[index + 1] - bucketStarts[index]);
+        }
+        void clear() noexcept
+        {
+            layers.clear();
+            bucketStarts.fill(0);
+            sequenced.clear();
+        }
+    };
+    std::array<NoteOnCandidates, 128> noteOnCandidates_;
     std::array<LayerViewVector, config::numCCs> ccActivationLists_;
 
     // Effect factory and buses
@@ -340,6 +450,13 @@ struct Synth::Impl final: public Parser::Listener {
         bool haveFilterLFO { false };
     } settingsPerVoice_;
 
+    // Parallel voice rendering
+    RenderPool renderPool_;
+    VoiceViewVector renderVoices_;
+    std::vector<std::unique_ptr<AudioBuffer<float>>> voiceOutputs_;
+    // the filters of the voices which are rendered together serially
+    FilterBank filterBank_;
+
     Duration dispatchDuration_ { 0 };
 
     std::chrono::time_point<std::chrono::high_resolution_clock> lastGarbageCollection_;
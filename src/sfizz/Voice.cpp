@@ -13,6 +13,7 @@
 #include "FilterPool.h"
 #include "FlexEnvelope.h"
 #include "Interpolators.h"
+#include "SincResampler.h"
 #include "LFO.h"
 #include "MathHelpers.h"
 #include "ModifierHelpers.h"
@@ -36,6 +37,7 @@
 #include <absl/algorithm/container.h>
 #include <absl/types/span.h>
 #include <random>
+#include <type_traits>
 
 namespace sfz {
 
@@ -50,6 +52,18 @@ struct Voice::Impl
      * @param buffer
      */
     void fillWithData(AudioSpan<float> buffer) noexcept;
+    /**
+     * @brief Fill a span with data from a sample file, when the playback
+     * ratio is constant over the block. This skips the position buffers.
+     *
+     * @param buffer
+     * @param ratio the playback ratio
+     * @param sampleEnd the last frame which can be played
+     * @param shouldLoop whether the sample is looping
+     * @return false if the block reaches the end of the sample or a loop
+     *         boundary, and must go through the general path instead
+     */
+    bool fillWithConstantRatio(AudioSpan<float> buffer, float ratio, int sampleEnd, bool shouldLoop) noexcept;
     /**
      * @brief Fill a span with data from a generator source. This is the first step
      * in rendering each block of data.
@@ -61,30 +75,84 @@ struct Voice::Impl
     /**
      * @brief Fill a destination with an interpolated source.
      *
-     * @param source the source sample
+     * @param source the source sample, as float or 16-bit integer
      * @param dest the destination buffer
      * @param indices the integral parts of the source positions
      * @param coeffs the fractional parts of the source positions
      */
-    template <InterpolatorModel M, bool Adding>
+    template <InterpolatorModel M, bool Adding, class T>
     static void fillInterpolated(
-        const AudioSpan<const float>& source, const AudioSpan<float>& dest,
+        const AudioSpan<const T>& source, const AudioSpan<float>& dest,
         absl::Span<const int> indices, absl::Span<const float> coeffs,
         absl::Span<const float> addingGains);
 
+    /**
+     * @brief Fill a destination with a source resampled by the windowed-sinc
+     *        polyphase kernel, which processes both channels at once.
+     *
+     * @param source the source sample, as float or 16-bit integer
+     * @param dest the destination buffer
+     * @param indices the integral parts of the source positions
+     * @param coeffs the fractional parts of the source positions
+     * @param points the number of points of the sinc
+     */
+    template <bool Adding, class T>
+    static void fillSincResampled(
+        const AudioSpan<const T>& source, const AudioSpan<float>& dest,
+        absl::Span<const int> indices, absl::Span<const float> coeffs,
+        absl::Span<const float> addingGains, unsigned points);
+
+    /**
+     * @brief Advance a source position by a constant step, split into an
+     *        integral and a fractional part. The fractional part is carried
+     *        into the index when it reaches 1.
+     *
+     * @param index the integral position
+     * @param coeff the fractional position
+     * @param intStep the integral part of the step
+     * @param fracStep the fractional part of the step
+     */
+    static void stepPosition(int& index, float& coeff, int intStep, float fracStep) noexcept
+    {
+        index += intStep;
+        coeff += fracStep;
+        if (coeff >= 1.0f) {
+            coeff -= 1.0f;
+            index += 1;
+        }
+    }
+
+    /**
+     * @brief Fill a destination with a source read at a constant ratio.
+     *        The source is copied directly at a ratio of 1 from an integral
+     *        position, and otherwise stepped through in small chunks.
+     *
+     * @param source the source sample, as float or 16-bit integer
+     * @param dest the destination buffer
+     * @param index the integral position of the first frame
+     * @param coeff the fractional position of the first frame
+     * @param intStep the integral part of the playback ratio
+     * @param fracStep the fractional part of the playback ratio
+     * @param quality the quality level 1-10
+     */
+    template <class T>
+    static void fillConstantRatio(
+        const AudioSpan<const T>& source, const AudioSpan<float>& dest,
+        int index, float coeff, int intStep, float fracStep, int quality);
+
     /**
      * @brief Fill a destination with an interpolated source, selecting
      *        interpolation type dynamically by quality level.
      *
-     * @param source the source sample
+     * @param source the source sample, as float or 16-bit integer
      * @param dest the destination buffer
      * @param indices the integral parts of the source positions
      * @param coeffs the fractional parts of the source positions
      * @param quality the quality level 1-10
      */
-    template <bool Adding>
+    template <bool Adding, class T>
     static void fillInterpolatedWithQuality(
-        const AudioSpan<const float>& source, const AudioSpan<float>& dest,
+        const AudioSpan<const T>& source, const AudioSpan<float>& dest,
         absl::Span<const int> indices, absl::Span<const float> coeffs,
         absl::Span<const float> addingGains, int quality);
 
@@ -257,13 +325,18 @@ struct Voice::Impl
     } loop_;
 
     FileDataHolder currentPromise_;
+    FileStreamHolder currentStream_;
 
     int samplesPerBlock_ { config::defaultSamplesPerBlock };
     float sampleRate_ { config::defaultSampleRate };
 
     Resources& resources_;
+    // the render slot of the thread which processes the current block
+    unsigned renderSlot_ {};
 
     std::vector<FilterHolder> filters_;
+    // the filters of the current block which were already queued or processed
+    unsigned filtersProcessed_ { 0 };
     std::vector<EQHolder> equalizers_;
     std::vector<std::unique_ptr<LFO>> lfos_;
     std::vector<std::unique_ptr<FlexEnvelope>> flexEGs_;
@@ -290,6 +363,9 @@ struct Voice::Impl
     Duration filterDuration_;
 
     fast_real_distribution<float> uniformNoiseDist_ { -config::uniformNoiseBounds, config::uniformNoiseBounds };
+    // seeded when the voice starts, so that the noise does not depend on
+    // the thread which renders the voice
+    fast_rand randomGenerator_;
     fast_gaussian_generator<float> gaussianNoiseDist_ { 0.0f, config::noiseVariance };
 
     Smoother gainSmoother_;
@@ -427,6 +503,7 @@ bool Voice::startVoice(Layer* layer, int delay, const TriggerEvent& event) noexc
     }
 
     impl.switchState(State::playing);
+    impl.randomGenerator_.seed(Random::randomGenerator());
 
     impl.updateExtendedCCValues();
 
@@ -470,7 +547,11 @@ bool Voice::startVoice(Layer* layer, int delay, const TriggerEvent& event) noexc
         impl.setupOscillatorUnison();
     } else {
         FilePool& filePool = resources.getFilePool();
-        impl.currentPromise_ = filePool.getFilePromise(region.sampleId);
+        // Looping and repeating regions jump back, these are loaded entirely
+        if (filePool.getDiskStreaming() && !region.shouldLoop() && !region.sampleCount)
+            impl.currentPromise_ = filePool.getFileStream(region.sampleId, impl.currentStream_);
+        if (!impl.currentStream_)
+            impl.currentPromise_ = filePool.getFilePromise(region.sampleId);
         if (!impl.currentPromise_) {
             impl.switchState(State::cleanMeUp);
             return false;
@@ -766,15 +847,24 @@ void Voice::setSamplesPerBlock(int samplesPerBlock) noexcept
     impl.powerFollower_.setSamplesPerBlock(samplesPerBlock);
 }
 
-void Voice::renderBlock(AudioSpan<float, 2> buffer) noexcept
+void Voice::renderBlock(AudioSpan<float, 2> buffer, unsigned slot) noexcept
+{
+    if (startBlock(buffer, slot))
+        finishBlock(buffer);
+}
+
+bool Voice::startBlock(AudioSpan<float, 2> buffer, unsigned slot) noexcept
 {
     Impl& impl = *impl_;
     ASSERT(static_cast<int>(buffer.getNumFrames()) <= impl.samplesPerBlock_);
+    impl.renderSlot_ = slot;
+    impl.filtersProcessed_ = 0;
+    impl.filterDuration_ = Duration(0);
     buffer.fill(0.0f);
 
     const Region* region = impl.region_;
     if (region == nullptr || region->disabled())
-        return;
+        return false;
 
     const auto delay = min(static_cast<size_t>(impl.initialDelay_), buffer.getNumFrames());
     auto delayed_buffer = buffer.subspan(delay);
@@ -791,9 +881,42 @@ void Voice::renderBlock(AudioSpan<float, 2> buffer) noexcept
     if (region->isStereo()) {
         impl.ampStageStereo(buffer);
         impl.panStageStereo(buffer);
-        impl.filterStageStereo(buffer);
     } else {
         impl.ampStageMono(buffer);
+    }
+
+    return true;
+}
+
+void Voice::queueFilter(unsigned index, AudioSpan<float, 2> buffer, FilterBank& bank) noexcept
+{
+    Impl& impl = *impl_;
+    ASSERT(index == impl.filtersProcessed_);
+
+    if (index >= impl.region_->filters.size())
+        return;
+
+    ScopedTiming logger { impl.filterDuration_, ScopedTiming::Operation::addToDuration };
+    const auto numFrames = static_cast<unsigned>(buffer.getNumFrames());
+    const float* inputChannels[2] { buffer.getChannel(0), buffer.getChannel(1) };
+    float* outputChannels[2] { buffer.getChannel(0), buffer.getChannel(1) };
+
+    FilterHolder& filter = impl.filters_[index];
+    if (!filter.queue(bank, outputChannels, numFrames, impl.renderSlot_))
+        filter.process(inputChannels, outputChannels, numFrames, impl.renderSlot_);
+
+    ++impl.filtersProcessed_;
+}
+
+void Voice::finishBlock(AudioSpan<float, 2> buffer) noexcept
+{
+    Impl& impl = *impl_;
+    const Region* region = impl.region_;
+    ASSERT(region != nullptr);
+
+    if (region->isStereo()) {
+        impl.filterStageStereo(buffer);
+    } else {
         impl.filterStageMono(buffer);
         impl.panStageMono(buffer);
     }
@@ -824,6 +947,12 @@ void Voice::renderBlock(AudioSpan<float, 2> buffer) noexcept
 #endif
 }
 
+unsigned Voice::getRenderSlot() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.renderSlot_;
+}
+
 void Voice::Impl::resetCrossfades() noexcept
 {
     float xfadeValue { 1.0f };
@@ -850,7 +979,7 @@ void Voice::Impl::applyCrossfades(absl::Span<float> modulationSpan) noexcept
     const auto xfCurve = region_->crossfadeCCCurve;
 
     MidiState& midiState = resources_.getMidiState();
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
 
     auto tempSpan = bufferPool.getBuffer(numSamples);
     auto xfadeSpan = bufferPool.getBuffer(numSamples);
@@ -891,20 +1020,20 @@ void Voice::Impl::amplitudeEnvelope(absl::Span<float> modulationSpan) noexcept
     ModMatrix& mm = resources_.getModMatrix();
 
     // Amplitude EG
-    absl::Span<const float> ampegOut(mm.getModulation(masterAmplitudeTarget_), numSamples);
+    absl::Span<const float> ampegOut(mm.getModulation(masterAmplitudeTarget_, renderSlot_), numSamples);
     ASSERT(ampegOut.data());
     copy(ampegOut, modulationSpan);
 
     // Amplitude envelope
     applyGain1<float>(baseGain_, modulationSpan);
-    if (float* mod = mm.getModulation(amplitudeTarget_)) {
+    if (float* mod = mm.getModulation(amplitudeTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             modulationSpan[i] *= mod[i];
     }
 
     // Volume envelope
     applyGain1<float>(db2mag(baseVolumedB_), modulationSpan);
-    if (float* mod = mm.getModulation(volumeTarget_)) {
+    if (float* mod = mm.getModulation(volumeTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             modulationSpan[i] *= db2mag(mod[i]);
     }
@@ -920,7 +1049,7 @@ void Voice::Impl::ampStageMono(AudioSpan<float> buffer) noexcept
     const auto numSamples = buffer.getNumFrames();
     const auto leftBuffer = buffer.getSpan(0);
 
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
 
     auto modulationSpan = bufferPool.getBuffer(numSamples);
     if (!modulationSpan)
@@ -935,7 +1064,7 @@ void Voice::Impl::ampStageStereo(AudioSpan<float> buffer) noexcept
 {
     ScopedTiming logger { amplitudeDuration_ };
 
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
 
     const auto numSamples = buffer.getNumFrames();
     auto modulationSpan = bufferPool.getBuffer(numSamples);
@@ -955,7 +1084,7 @@ void Voice::Impl::panStageMono(AudioSpan<float> buffer) noexcept
     const auto leftBuffer = buffer.getSpan(0);
     const auto rightBuffer = buffer.getSpan(1);
 
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
 
     auto modulationSpan = bufferPool.getBuffer(numSamples);
     if (!modulationSpan)
@@ -968,7 +1097,7 @@ void Voice::Impl::panStageMono(AudioSpan<float> buffer) noexcept
 
     // Apply panning
     fill(*modulationSpan, region_->pan);
-    if (float* mod = mm.getModulation(panTarget_)) {
+    if (float* mod = mm.getModulation(panTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             (*modulationSpan)[i] += mod[i];
     }
@@ -982,7 +1111,7 @@ void Voice::Impl::panStageStereo(AudioSpan<float> buffer) noexcept
     const auto leftBuffer = buffer.getSpan(0);
     const auto rightBuffer = buffer.getSpan(1);
 
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
 
     auto modulationSpan = bufferPool.getBuffer(numSamples);
     if (!modulationSpan)
@@ -992,7 +1121,7 @@ void Voice::Impl::panStageStereo(AudioSpan<float> buffer) noexcept
 
     // Apply panning
     fill(*modulationSpan, region_->pan);
-    if (float* mod = mm.getModulation(panTarget_)) {
+    if (float* mod = mm.getModulation(panTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             (*modulationSpan)[i] += mod[i];
     }
@@ -1000,14 +1129,14 @@ void Voice::Impl::panStageStereo(AudioSpan<float> buffer) noexcept
 
     // Apply the width/position process
     fill(*modulationSpan, region_->width);
-    if (float* mod = mm.getModulation(widthTarget_)) {
+    if (float* mod = mm.getModulation(widthTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             (*modulationSpan)[i] += mod[i];
     }
     width(*modulationSpan, leftBuffer, rightBuffer);
 
     fill(*modulationSpan, region_->position);
-    if (float* mod = mm.getModulation(positionTarget_)) {
+    if (float* mod = mm.getModulation(positionTarget_, renderSlot_)) {
         for (size_t i = 0; i < numSamples; ++i)
             (*modulationSpan)[i] += mod[i];
     }
@@ -1020,23 +1149,23 @@ void Voice::Impl::panStageStereo(AudioSpan<float> buffer) noexcept
 
 void Voice::Impl::filterStageMono(AudioSpan<float> buffer) noexcept
 {
-    ScopedTiming logger { filterDuration_ };
+    ScopedTiming logger { filterDuration_, ScopedTiming::Operation::addToDuration };
     const auto numSamples = buffer.getNumFrames();
     const auto leftBuffer = buffer.getSpan(0);
     const float* inputChannel[1] { leftBuffer.data() };
     float* outputChannel[1] { leftBuffer.data() };
-    for (unsigned i = 0; i < region_->filters.size(); ++i) {
-        filters_[i].process(inputChannel, outputChannel, numSamples);
+    for (unsigned i = filtersProcessed_; i < region_->filters.size(); ++i) {
+        filters_[i].process(inputChannel, outputChannel, numSamples, renderSlot_);
     }
 
     for (unsigned i = 0; i < region_->equalizers.size(); ++i) {
-        equalizers_[i].process(inputChannel, outputChannel, numSamples);
+        equalizers_[i].process(inputChannel, outputChannel, numSamples, renderSlot_);
     }
 }
 
 void Voice::Impl::filterStageStereo(AudioSpan<float> buffer) noexcept
 {
-    ScopedTiming logger { filterDuration_ };
+    ScopedTiming logger { filterDuration_, ScopedTiming::Operation::addToDuration };
     const auto numSamples = buffer.getNumFrames();
     const auto leftBuffer = buffer.getSpan(0);
     const auto rightBuffer = buffer.getSpan(1);
@@ -1044,12 +1173,12 @@ void Voice::Impl::filterStageStereo(AudioSpan<float> buffer) noexcept
     const float* inputChannels[2] { leftBuffer.data(), rightBuffer.data() };
     float* outputChannels[2] { leftBuffer.data(), rightBuffer.data() };
 
-    for (unsigned i = 0; i < region_->filters.size(); ++i) {
-        filters_[i].process(inputChannels, outputChannels, numSamples);
+    for (unsigned i = filtersProcessed_; i < region_->filters.size(); ++i) {
+        filters_[i].process(inputChannels, outputChannels, numSamples, renderSlot_);
     }
 
     for (unsigned i = 0; i < region_->equalizers.size(); ++i) {
-        equalizers_[i].process(inputChannels, outputChannels, numSamples);
+        equalizers_[i].process(inputChannels, outputChannels, numSamples, renderSlot_);
     }
 }
 
@@ -1064,11 +1193,29 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
         return;
     }
 
-    auto source = currentPromise_->getData();
+    // 16-bit files may be kept in memory in their native format
+    const bool compact = currentPromise_->compact;
+    const auto source = compact ? AudioSpan<const float>() : currentPromise_->getData();
+    const auto compactSource = compact ? currentPromise_->getCompactData() : AudioSpan<const int16_t>();
+    const size_t dataFrames = compact ? compactSource.getNumFrames() : source.getNumFrames();
 
-    BufferPool& bufferPool = resources_.getBufferPool();
+    BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
     const CurveSet& curves = resources_.getCurves();
 
+    // Update loop characteristics with the current CC state
+    updateLoopInformation();
+    const auto loop = this->loop_;
+
+    // Looping logic
+    const bool hasLoopSamples = static_cast<size_t>(loop.end) < dataFrames;
+    const bool loopCountReached = region_->loopCount && loop_.restarts >= *region_->loopCount;
+    const bool loopContinuous = (region_->loopMode == LoopMode::loop_continuous);
+    const bool loopSustain = (region_->loopMode == LoopMode::loop_sustain) && !released();
+    const bool shouldLoop = hasLoopSamples && (loopSustain || loopContinuous) && !loopCountReached;
+
+    const int sourceFrames = currentStream_ ? int(currentStream_->getNumFrames()) : int(dataFrames);
+    const auto sampleEnd = min( int(sampleEnd_), int(currentPromise_->information.end), sourceFrames) - 1;
+
     // calculate interpolation data
     //   indices: integral position in the source audio
     //   coeffs: fractional position normalized 0-1
@@ -1085,6 +1232,17 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
         pitchEnvelope(pitch);
 
         float baseRatio = pitchRatio_ * speedRatio_;
+
+        // Most voices play at a constant pitch over the block
+        const bool constantPitch = !currentStream_ &&
+            resources_.getSynthConfig().constantRatioFastPath &&
+            allWithin<float>(pitch, pitch.front(), pitch.front());
+        if (constantPitch) {
+            const float ratio = baseRatio * centsFactor(pitch.front());
+            if (fillWithConstantRatio(buffer, ratio, sampleEnd, shouldLoop))
+                return;
+        }
+
         for (size_t i = 0; i < numSamples; ++i)
             (*jumps)[i] = baseRatio * centsFactor(pitch[i]);
 
@@ -1098,17 +1256,6 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
         add1<int>(sourcePosition_, *indices);
     }
 
-    // Update loop characteristics with the current CC state
-    updateLoopInformation();
-    const auto loop = this->loop_;
-
-    // Looping logic
-    const bool hasLoopSamples = static_cast<size_t>(loop.end) < source.getNumFrames();
-    const bool loopCountReached = region_->loopCount && loop_.restarts >= *region_->loopCount;
-    const bool loopContinuous = (region_->loopMode == LoopMode::loop_continuous);
-    const bool loopSustain = (region_->loopMode == LoopMode::loop_sustain) && !released();
-    const bool shouldLoop = hasLoopSamples && (loopSustain || loopContinuous) && !loopCountReached;
-
     /*
                loop start             loop end
                    v                      |
@@ -1147,8 +1294,6 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
         numPartitions = 1;
     }
 
-    const auto sampleEnd = min( int(sampleEnd_), int(currentPromise_->information.end), int(source.getNumFrames())) - 1;
-
     int blockRestarts { 0 };
     int oldIndex {};
     int oldPartitionType {};
@@ -1222,6 +1367,37 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
     // interpolation processing
     const int quality = getCurrentSampleQuality();
 
+    if (currentStream_) {
+        // The indices are increasing, render in pieces which fit in the view
+        auto viewIndices = bufferPool.getIndexBuffer(numSamples);
+        if (!viewIndices)
+            return;
+
+        unsigned i = 0;
+        while (i < numSamples) {
+            const int first = (*indices)[i];
+            unsigned next = i + 1;
+            while (next < numSamples && (*indices)[next] - first < config::streamViewFrames)
+                ++next;
+            const unsigned size = next - i;
+
+            const int count = (*indices)[next - 1] - first + 1;
+            AudioSpan<const float> view = compact ?
+                currentStream_->getFrames(compactSource, first, static_cast<size_t>(count)) :
+                currentStream_->getFrames(source, first, static_cast<size_t>(count));
+            absl::Span<int> pieceIndices = viewIndices->subspan(i, size);
+            absl::c_copy(indices->subspan(i, size), pieceIndices.begin());
+            subtract1(first, pieceIndices);
+
+            fillInterpolatedWithQuality<false>(
+                view, buffer.subspan(i, size), pieceIndices, coeffs->subspan(i, size), {}, quality);
+            i = next;
+        }
+
+        currentStream_->setReadPosition(indices->back() - config::excessFileFrames);
+        numPartitions = 0;
+    }
+
     for (unsigned ptNo = 0; ptNo < numPartitions; ++ptNo) {
         // current partition
         const int ptType = partitionTypes[ptNo];
@@ -1234,8 +1410,12 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
         absl::Span<const int> ptIndices = indices->subspan(ptStart, ptSize);
         absl::Span<const float> ptCoeffs = coeffs->subspan(ptStart, ptSize);
 
-        fillInterpolatedWithQuality<false>(
-            source, ptBuffer, ptIndices, ptCoeffs, {}, quality);
+        if (compact)
+            fillInterpolatedWithQuality<false>(
+                compactSource, ptBuffer, ptIndices, ptCoeffs, {}, quality);
+        else
+            fillInterpolatedWithQuality<false>(
+                source, ptBuffer, ptIndices, ptCoeffs, {}, quality);
 
         if (ptType == kPartitionLoopXfade) {
             auto xfTemp1 = bufferPool.getBuffer(numSamples);
@@ -1324,8 +1504,12 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
                         xfCurve[i] = clamp(xfInCurvePos[i], 0.0f, 1.0f);
                 }
                 // apply in curve
-                fillInterpolatedWithQuality<true>(
-                    source, xfInBuffer, xfInIndices, xfInCoeffs, xfCurve, quality);
+                if (compact)
+                    fillInterpolatedWithQuality<true>(
+                        compactSource, xfInBuffer, xfInIndices, xfInCoeffs, xfCurve, quality);
+                else
+                    fillInterpolatedWithQuality<true>(
+                        source, xfInBuffer, xfInIndices, xfInCoeffs, xfCurve, quality);
             }
         }
     }
@@ -1341,9 +1525,92 @@ void Voice::Impl::fillWithData(AudioSpan<float> buffer) noexcept
 #endif
 }
 
-template <InterpolatorModel M, bool Adding>
+bool Voice::Impl::fillWithConstantRatio(AudioSpan<float> buffer, float ratio, int sampleEnd, bool shouldLoop) noexcept
+{
+    const size_t numSamples = buffer.getNumFrames();
+    const int intStep = static_cast<int>(ratio);
+    const float fracStep = ratio - static_cast<float>(intStep);
+
+    // position of the first frame, relative to the current source position;
+    // the first sample is taken if the voice just started
+    const float firstPosition = floatPositionOffset_ + (age_ == 0 ? 0.0f : ratio);
+    const int firstIndex = sourcePosition_ + static_cast<int>(firstPosition);
+    const float firstCoeff = firstPosition - static_cast<float>(static_cast<int>(firstPosition));
+
+    // step to the last frame exactly as the interpolation does, so that the
+    // checks below cover all the frames which are read
+    int lastIndex = firstIndex;
+    float lastCoeff = firstCoeff;
+    for (size_t i = 1; i < numSamples; ++i)
+        stepPosition(lastIndex, lastCoeff, intStep, fracStep);
+
+    if (lastIndex >= sampleEnd)
+        return false;
+
+    if (shouldLoop) {
+        const auto& loop = this->loop_;
+        const bool wraps = lastIndex > loop.end;
+        const bool xfading = lastIndex >= loop.start && lastIndex >= loop.xfOutStart;
+        if (wraps || xfading)
+            return false;
+    }
+
+    const int quality = getCurrentSampleQuality();
+
+    if (currentPromise_->compact)
+        fillConstantRatio(currentPromise_->getCompactData(), buffer, firstIndex, firstCoeff, intStep, fracStep, quality);
+    else
+        fillConstantRatio(currentPromise_->getData(), buffer, firstIndex, firstCoeff, intStep, fracStep, quality);
+
+    sourcePosition_ = lastIndex;
+    floatPositionOffset_ = lastCoeff;
+    return true;
+}
+
+template <class T>
+void Voice::Impl::fillConstantRatio(
+    const AudioSpan<const T>& source, const AudioSpan<float>& dest,
+    int index, float coeff, int intStep, float fracStep, int quality)
+{
+    const unsigned numFrames = static_cast<unsigned>(dest.getNumFrames());
+    const unsigned numChannels = min(source.getNumChannels(), dest.getNumChannels());
+
+    if (intStep == 1 && fracStep == 0.0f && coeff == 0.0f) {
+        // the interpolators are transparent on integral positions
+        constexpr float scale = std::is_same<T, int16_t>::value ? (1.0f / 32768) : 1.0f;
+        for (unsigned c = 0; c < numChannels; ++c) {
+            const T* input = source.getChannel(c) + index;
+            float* output = dest.getChannel(c);
+            for (unsigned i = 0; i < numFrames; ++i)
+                output[i] = scale * static_cast<float>(input[i]);
+        }
+        return;
+    }
+
+    // step through the source in chunks, with the positions on the stack
+    constexpr unsigned chunkSize = 64;
+    int indices[chunkSize];
+    float coeffs[chunkSize];
+
+    for (unsigned i = 0; i < numFrames; ) {
+        const unsigned size = min(chunkSize, numFrames - i);
+        for (unsigned j = 0; j < size; ++j) {
+            if (i + j > 0)
+                stepPosition(index, coeff, intStep, fracStep);
+            indices[j] = index;
+            coeffs[j] = coeff;
+        }
+
+        fillInterpolatedWithQuality<false>(
+            source, dest.subspan(i, size), absl::MakeConstSpan(indices, size),
+            absl::MakeConstSpan(coeffs, size), {}, quality);
+        i += size;
+    }
+}
+
+template <InterpolatorModel M, bool Adding, class T>
 void Voice::Impl::fillInterpolated(
-    const AudioSpan<const float>& source, const AudioSpan<float>& dest,
+    const AudioSpan<const T>& source, const AudioSpan<float>& dest,
     absl::Span<const int> indices, absl::Span<const float> coeffs,
     absl::Span<const float> addingGains)
 {
@@ -1383,9 +1650,24 @@ void Voice::Impl::fillInterpolated(
     }
 }
 
-template <bool Adding>
+template <bool Adding, class T>
+void Voice::Impl::fillSincResampled(
+    const AudioSpan<const T>& source, const AudioSpan<float>& dest,
+    absl::Span<const int> indices, absl::Span<const float> coeffs,
+    absl::Span<const float> addingGains, unsigned points)
+{
+    const bool stereo = source.getNumChannels() > 1;
+    sincResample(
+        points, source.getConstSpan(0).data(),
+        stereo ? source.getConstSpan(1).data() : nullptr,
+        indices.data(), coeffs.data(), Adding ? addingGains.data() : nullptr,
+        dest.getChannel(0), stereo ? dest.getChannel(1) : nullptr,
+        static_cast<unsigned>(indices.size()));
+}
+
+template <bool Adding, class T>
 void Voice::Impl::fillInterpolatedWithQuality(
-    const AudioSpan<const float>& source, const AudioSpan<float>& dest,
+    const AudioSpan<const T>& source, const AudioSpan<float>& dest,
     absl::Span<const int> indices, absl::Span<const float> coeffs,
     absl::Span<const float> addingGains, int quality)
 {
@@ -1415,52 +1697,28 @@ void Voice::Impl::fillInterpolatedWithQuality(
         }
         break;
     case 3:
-        {
-            constexpr auto itp = kInterpolatorSinc8;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 8);
         break;
     case 4:
-        {
-            constexpr auto itp = kInterpolatorSinc12;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 12);
         break;
     case 5:
-        {
-            constexpr auto itp = kInterpolatorSinc16;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 16);
         break;
     case 6:
-        {
-            constexpr auto itp = kInterpolatorSinc24;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 24);
         break;
     case 7:
-        {
-            constexpr auto itp = kInterpolatorSinc36;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 36);
         break;
     case 8:
-        {
-            constexpr auto itp = kInterpolatorSinc48;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 48);
         break;
     case 9:
-        {
-            constexpr auto itp = kInterpolatorSinc60;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 60);
         break;
     case 10:
-        {
-            constexpr auto itp = kInterpolatorSinc72;
-            fillInterpolated<itp, Adding>(source, dest, indices, coeffs, addingGains);
-        }
+        fillSincResampled<Adding>(source, dest, indices, coeffs, addingGains, 72);
         break;
     }
 }
@@ -1486,7 +1744,7 @@ void Voice::Impl::fillWithGenerator(AudioSpan<float> buffer) noexcept
 
     if (region_->sampleId->filename() == "*noise") {
         auto gen = [&]() {
-            return uniformNoiseDist_(Random::randomGenerator);
+            return uniformNoiseDist_(randomGenerator_);
         };
         absl::c_generate(leftSpan, gen);
         absl::c_generate(rightSpan, gen);
@@ -1502,7 +1760,7 @@ void Voice::Impl::fillWithGenerator(AudioSpan<float> buffer) noexcept
     } else {
         const size_t numFrames = buffer.getNumFrames();
 
-        BufferPool& bufferPool = resources_.getBufferPool();
+        BufferPool& bufferPool = resources_.getBufferPool(renderSlot_);
         ModMatrix& modMatrix = resources_.getModMatrix();
 
         auto frequencies = bufferPool.getBuffer(numFrames);
@@ -1547,7 +1805,7 @@ void Voice::Impl::fillWithGenerator(AudioSpan<float> buffer) noexcept
             if (!tempSpan || !tempLeftSpan || !tempRightSpan)
                 return;
 
-            const float* detuneMod = modMatrix.getModulation(oscillatorDetuneTarget_);
+            const float* detuneMod = modMatrix.getModulation(oscillatorDetuneTarget_, renderSlot_);
             for (unsigned u = 0, uSize = waveUnisonSize_; u < uSize; ++u) {
                 WavetableOscillator& osc = waveOscillators_[u];
                 osc.setQuality(quality);
@@ -1588,7 +1846,7 @@ void Voice::Impl::fillWithGenerator(AudioSpan<float> buffer) noexcept
             if (!modulatorSpan)
                 return;
 
-            const float* detuneMod = modMatrix.getModulation(oscillatorDetuneTarget_);
+            const float* detuneMod = modMatrix.getModulation(oscillatorDetuneTarget_, renderSlot_);
             if (!detuneMod)
                 fill(*detuneSpan, waveDetuneRatio_[1]);
             else {
@@ -1603,7 +1861,7 @@ void Voice::Impl::fillWithGenerator(AudioSpan<float> buffer) noexcept
             const float oscillatorModDepth = region_->oscillatorModDepth;
             if (oscillatorModDepth != 1.0f)
                 applyGain1(oscillatorModDepth, *modulatorSpan);
-            const float* modDepthMod = modMatrix.getModulation(oscillatorModDepthTarget_);
+            const float* modDepthMod = modMatrix.getModulation(oscillatorModDepthTarget_, renderSlot_);
             if (modDepthMod)
                 applyGain(absl::MakeConstSpan(modDepthMod, numFrames), *modulatorSpan);
 
@@ -1687,6 +1945,7 @@ void Voice::reset() noexcept
     impl.switchState(State::idle);
     impl.region_ = nullptr;
     impl.currentPromise_.reset();
+    impl.currentStream_.reset();
     impl.sourcePosition_ = 0;
     impl.age_ = 0;
     impl.count_ = 1;
@@ -1978,7 +2237,7 @@ void Voice::Impl::pitchEnvelope(absl::Span<float> pitchSpan) noexcept
 
     ModMatrix& mm = resources_.getModMatrix();
 
-    if (float* mod = mm.getModulation(pitchTarget_))
+    if (float* mod = mm.getModulation(pitchTarget_, renderSlot_))
         add<float>(absl::MakeSpan(mod, numFrames), pitchSpan);
 }
 
@@ -18,6 +18,7 @@
 namespace sfz {
 enum InterpolatorModel : int;
 class LFO;
+class FilterBank;
 class FlexEnvelope;
 struct Layer;
 
@@ -196,8 +197,47 @@ public:
      * @brief Render a block of data for this voice into the span
      *
      * @param buffer
+     * @param slot the render slot of the calling thread, which selects the
+     *             scratch buffers and the modulation context to use
      */
-    void renderBlock(AudioSpan<float, 2> buffer) noexcept;
+    void renderBlock(AudioSpan<float, 2> buffer, unsigned slot) noexcept;
+
+    /**
+     * @brief Render a block in steps, so that the filters of several voices
+     * are processed together in a filter bank. This renders the stages up
+     * to the filters. Then `queueFilter` is called for each filter of the
+     * region in order, with the bank processed after each call, and
+     * `finishBlock` renders the remaining stages. The modulation context of
+     * the slot must stay on the voice until the block is finished.
+     *
+     * @param buffer
+     * @param slot the render slot of the voice
+     * @return false if the voice has nothing to render, in which case the
+     *         buffer is silent and the other steps are skipped
+     */
+    bool startBlock(AudioSpan<float, 2> buffer, unsigned slot) noexcept;
+
+    /**
+     * @brief Queue a filter of the block into a bank, or process it directly
+     * if the bank does not support its type.
+     *
+     * @param index the index of the filter, following the previous one
+     * @param buffer the buffer passed to `startBlock`
+     * @param bank
+     */
+    void queueFilter(unsigned index, AudioSpan<float, 2> buffer, FilterBank& bank) noexcept;
+
+    /**
+     * @brief Render the stages of the block which follow the filters.
+     *
+     * @param buffer the buffer passed to `startBlock`
+     */
+    void finishBlock(AudioSpan<float, 2> buffer) noexcept;
+
+    /**
+     * @brief Get the render slot of the block being rendered
+     */
+    unsigned getRenderSlot() const noexcept;
 
     /**
      * @brief Is the voice free?
@@ -8,30 +8,81 @@
 #include "SisterVoiceRing.h"
 #include "RegionSet.h"
 #include <absl/algorithm/container.h>
+#include <algorithm>
 
 namespace sfz {
 
+namespace {
+
+std::vector<Voice*>& ensureVoiceBucket(std::vector<Voice*>& bucket)
+{
+    bucket.reserve(config::maxVoices);
+    return bucket;
+}
+
+void removeFromBucket(std::vector<Voice*>& bucket, const Voice* voice)
+{
+    swapAndPopFirst(bucket, [voice](const Voice* v) { return v == voice; });
+}
+
+bool hasHigherIndex(const Voice* lhs, const Voice* rhs)
+{
+    return lhs->getId().number() > rhs->getId().number();
+}
+
+} // namespace
+
 void VoiceManager::onVoiceStateChanging(NumericId<Voice> id, Voice::State state)
 {
     if (state == Voice::State::idle) {
         Voice* voice = getVoiceById(id);
+        addFreeVoice(voice);
         const Region* region = voice->getRegion();
         const uint32_t group = region->group;
         RegionSet::removeVoiceFromHierarchy(region, voice);
-        swapAndPopFirst(activeVoices_, [voice](const Voice* v) { return v == voice; });
+        removeVoiceFromIndexes(voice);
+        // Keep the start order, which the voice stealing relies on
+        auto it = absl::c_find(activeVoices_, voice);
+        if (it != activeVoices_.end())
+            activeVoices_.erase(it);
         ASSERT(polyphonyGroups_.contains(group));
         polyphonyGroups_[group].removeVoice(voice);
     } else if (state == Voice::State::playing) {
         Voice* voice = getVoiceById(id);
+        removeFreeVoice(voice);
         const Region* region = voice->getRegion();
         const uint32_t group = region->group;
         activeVoices_.push_back(voice);
+        registerVoiceInIndexes(voice);
         RegionSet::registerVoiceInHierarchy(region, voice);
         ASSERT(polyphonyGroups_.contains(group));
         polyphonyGroups_[group].registerVoice(voice);
+    } else {
+        // A voice can be cleaned up without having played
+        removeFreeVoice(getVoiceById(id));
     }
 }
 
+void VoiceManager::addFreeVoice(Voice* voice) noexcept
+{
+    const auto it = std::lower_bound(freeVoices_.begin(), freeVoices_.end(), voice, hasHigherIndex);
+    if (it == freeVoices_.end() || *it != voice)
+        freeVoices_.insert(it, voice);
+}
+
+void VoiceManager::removeFreeVoice(const Voice* voice) noexcept
+{
+    // Usually the voice was just taken from the back
+    if (!freeVoices_.empty() && freeVoices_.back() == voice) {
+        freeVoices_.pop_back();
+        return;
+    }
+
+    const auto it = std::lower_bound(freeVoices_.begin(), freeVoices_.end(), voice, hasHigherIndex);
+    if (it != freeVoices_.end() && *it == voice)
+        freeVoices_.erase(it);
+}
+
 const Voice* VoiceManager::getVoiceById(NumericId<Voice> id) const noexcept
 {
     const size_t size = list_.size();
@@ -55,11 +106,73 @@ Voice* VoiceManager::getVoiceById(NumericId<Voice> id) noexcept
         const_cast<const VoiceManager*>(this)->getVoiceById(id));
 }
 
+void VoiceManager::registerVoiceInIndexes(Voice* voice) noexcept
+{
+    const Region* region = voice->getRegion();
+    const TriggerEvent& event = voice->getTriggerEvent();
+
+    if (event.type == TriggerEventType::NoteOn && event.number >= 0 && event.number < 128)
+        noteVoices_[event.number].push_back(voice);
+
+    ccVoices_[region->sustainCC].push_back(voice);
+    if (region->sostenutoCC != region->sustainCC)
+        ccVoices_[region->sostenutoCC].push_back(voice);
+
+    if (region->offBy && (event.type == TriggerEventType::NoteOn || event.type == TriggerEventType::CC))
+        offGroupVoices_[*region->offBy].push_back(voice);
+}
+
+void VoiceManager::removeVoiceFromIndexes(const Voice* voice) noexcept
+{
+    const Region* region = voice->getRegion();
+    const TriggerEvent& event = voice->getTriggerEvent();
+
+    if (event.type == TriggerEventType::NoteOn && event.number >= 0 && event.number < 128)
+        removeFromBucket(noteVoices_[event.number], voice);
+
+    removeFromBucket(ccVoices_[region->sustainCC], voice);
+    if (region->sostenutoCC != region->sustainCC)
+        removeFromBucket(ccVoices_[region->sostenutoCC], voice);
+
+    if (region->offBy && (event.type == TriggerEventType::NoteOn || event.type == TriggerEventType::CC))
+        removeFromBucket(offGroupVoices_[*region->offBy], voice);
+}
+
+void VoiceManager::ensureRegionIndexes(const Region& region) noexcept
+{
+    ensureVoiceBucket(ccVoices_[region.sustainCC]);
+    ensureVoiceBucket(ccVoices_[region.sostenutoCC]);
+    if (region.offBy)
+        ensureVoiceBucket(offGroupVoices_[*region.offBy]);
+}
+
+const std::vector<Voice*>& VoiceManager::getVoicesByNote(int noteNumber) const noexcept
+{
+    if (noteNumber < 0 || noteNumber >= static_cast<int>(noteVoices_.size()))
+        return noVoices_;
+
+    return noteVoices_[noteNumber];
+}
+
+const std::vector<Voice*>& VoiceManager::getVoicesByCC(int ccNumber) const noexcept
+{
+    const auto it = ccVoices_.find(ccNumber);
+    return (it != ccVoices_.end()) ? it->second : noVoices_;
+}
+
+const std::vector<Voice*>& VoiceManager::getVoicesByOffGroup(int64_t group) const noexcept
+{
+    const auto it = offGroupVoices_.find(group);
+    return (it != offGroupVoices_.end()) ? it->second : noVoices_;
+}
+
 void VoiceManager::reset()
 {
     for (auto& voice : list_)
         voice.reset();
 
+    ccVoices_.clear();
+    offGroupVoices_.clear();
     polyphonyGroups_.clear();
     polyphonyGroups_.emplace(0, PolyphonyGroup{});
     setStealingAlgorithm(StealingAlgorithm::Oldest);
@@ -110,6 +223,13 @@ void VoiceManager::clear()
         pg.second.removeAllVoices();
     list_.clear();
     activeVoices_.clear();
+    freeVoices_.clear();
+    for (auto& voices : noteVoices_)
+        voices.clear();
+    for (auto& voices : ccVoices_)
+        voices.second.clear();
+    for (auto& voices : offGroupVoices_)
+        voices.second.clear();
 }
 
 void VoiceManager::setStealingAlgorithm(StealingAlgorithm algorithm)
@@ -147,12 +267,8 @@ void VoiceManager::checkPolyphony(const Region* region, int delay, const Trigger
 
 Voice* VoiceManager::findFreeVoice() noexcept
 {
-    auto freeVoice = absl::c_find_if(list_, [](const Voice& voice) {
-        return voice.isFree();
-    });
-
-    if (freeVoice != list_.end())
-        return &*freeVoice;
+    if (!freeVoices_.empty())
+        return freeVoices_.back();
 
     DBG("Engine hard polyphony reached");
     return {};
@@ -167,12 +283,18 @@ void VoiceManager::requireNumVoices(int numVoices, Resources& resources)
     list_.reserve(numEffectiveVoices);
     temp_.reserve(numEffectiveVoices);
     activeVoices_.reserve(numEffectiveVoices);
+    freeVoices_.reserve(numEffectiveVoices);
+    for (auto& voices : noteVoices_)
+        ensureVoiceBucket(voices);
 
     for (int i = 0; i < numEffectiveVoices; ++i) {
         list_.emplace_back(i, resources);
         Voice& lastVoice = list_.back();
         lastVoice.setStateListener(this);
     }
+
+    for (auto it = list_.rbegin(); it != list_.rend(); ++it)
+        freeVoices_.push_back(&*it);
 }
 
 void VoiceManager::checkRegionPolyphony(const Region* region, int delay) noexcept
@@ -13,6 +13,7 @@
 #include "Resources.h"
 #include "Voice.h"
 #include "VoiceStealing.h"
+#include <array>
 #include <vector>
 
 namespace sfz {
@@ -72,6 +73,42 @@ struct VoiceManager final : public Voice::StateListener
      */
     void setGroupPolyphony(int groupIdx, unsigned polyphony) noexcept;
 
+    /**
+     * @brief Prepare the voice indexes for a region, so that starting
+     * voices on it does not allocate. Call this for each region in an sfz file.
+     *
+     * @param region
+     */
+    void ensureRegionIndexes(const Region& region) noexcept;
+
+    /**
+     * @brief Get the active voices which were triggered by a note on
+     * event for this note number. The voices which get started meanwhile
+     * are appended, so iterate on indices if you can start voices.
+     *
+     * @param noteNumber
+     * @return const std::vector<Voice*>&
+     */
+    const std::vector<Voice*>& getVoicesByNote(int noteNumber) const noexcept;
+
+    /**
+     * @brief Get the active voices which react to this controller, which
+     * is the sustain or sostenuto pedal of their region.
+     *
+     * @param ccNumber
+     * @return const std::vector<Voice*>&
+     */
+    const std::vector<Voice*>& getVoicesByCC(int ccNumber) const noexcept;
+
+    /**
+     * @brief Get the active voices which can be turned off by a region of
+     * this group, through their `off_by` opcode.
+     *
+     * @param group
+     * @return const std::vector<Voice*>&
+     */
+    const std::vector<Voice*>& getVoicesByOffGroup(int64_t group) const noexcept;
+
     /**
      * @brief Get a view into a given polyphony group
      *
@@ -109,6 +146,16 @@ struct VoiceManager final : public Voice::StateListener
      */
     size_t getNumActiveVoices() const { return activeVoices_.size(); }
 
+    /**
+     * @brief Get the active voices, which are the voices from their start
+     * until they become free again, in the order in which they started.
+     * Starting or resetting voices modifies this list, so do not iterate
+     * on it while doing so.
+     *
+     * @return const std::vector<Voice*>&
+     */
+    const std::vector<Voice*>& getActiveVoices() const noexcept { return activeVoices_; }
+
     /**
      * @brief Get the number of polyphony groups
      *
@@ -117,7 +164,8 @@ struct VoiceManager final : public Voice::StateListener
     size_t getNumPolyphonyGroups() const noexcept { return polyphonyGroups_.size(); }
 
     /**
-     * @brief Find a voice that is not currently playing
+     * @brief Find a voice that is not currently playing, which is the
+     * free voice with the lowest index
      *
      * @return Voice*
      */
@@ -137,9 +185,33 @@ private:
     int getNumEffectiveVoices() const noexcept { return config::calculateActualVoices(numRequiredVoices_); }
     std::vector<Voice> list_;
     std::vector<Voice*> activeVoices_;
+    // The free voices, by decreasing index so that the next one is at the back
+    std::vector<Voice*> freeVoices_;
     std::vector<Voice*> temp_;
     // These are the `group=` groups where you can off voices
     absl::flat_hash_map<int, PolyphonyGroup> polyphonyGroups_;
+    // Indexes of the active voices, which each hold at most `config::maxVoices`
+    // so that the references and the iterators stay valid as voices start
+    std::array<std::vector<Voice*>, 128> noteVoices_;
+    absl::flat_hash_map<int, std::vector<Voice*>> ccVoices_;
+    absl::flat_hash_map<int64_t, std::vector<Voice*>> offGroupVoices_;
+    const std::vector<Voice*> noVoices_;
+
+    /**
+     * @brief Add or remove a voice from the indexes
+     *
+     * @param voice
+     */
+    void registerVoiceInIndexes(Voice* voice) noexcept;
+    void removeVoiceFromIndexes(const Voice* voice) noexcept;
+
+    /**
+     * @brief Add or remove a voice from the free list
+     *
+     * @param voice
+     */
+    void addFreeVoice(Voice* voice) noexcept;
+    void removeFreeVoice(const Voice* voice) noexcept;
     std::unique_ptr<VoiceStealer> stealer_ { absl::make_unique<OldestStealer>() };
 
     /**
@@ -8,6 +8,11 @@ namespace sfz {
  * A voice is counted as incrementing the voice count and "stealable" if voiceCond(voice) is true.
  * For each stealable voice, the voice becomes the stealing candidate if candidateCont(voice, candidate) is true.
  *
+ * The candidates come in the order in which the voices started, so their age
+ * never increases along the list: all voices age by the same amount on each
+ * block. Once the polyphony is reached, a later voice cannot be a better
+ * candidate for the checkers below, and the scan stops.
+ *
  * @tparam F
  * @tparam G
  * @param candidates
@@ -25,6 +30,8 @@ Voice* genericPolyphonyCheck(absl::Span<Voice*> candidates, unsigned polyphony,
             if (candidateCond(voice, candidate))
                 candidate = voice;
             numPlaying += 1;
+            if (numPlaying >= polyphony)
+                break;
         }
     }
 
@@ -89,7 +96,15 @@ Voice* OldestStealer::checkPolyphony(absl::Span<Voice*> candidates, unsigned max
  */
 sfz::Voice* stealEnvelopeAndAge(absl::Span<Voice*> voices) noexcept
 {
-    absl::c_sort(voices, voiceOrdering);
+    // The voices come in their start order, which is sorted by age already;
+    // only the voices of equal ages may need reordering, and they are adjacent
+    for (size_t i = 1; i < voices.size(); ++i) {
+        Voice* voice = voices[i];
+        size_t j = i;
+        for (; j > 0 && voiceOrdering(voice, voices[j - 1]); --j)
+            voices[j] = voices[j - 1];
+        voices[j] = voice;
+    }
 
     const auto sumPower = absl::c_accumulate(voices, 0.0f, [](float sum, const Voice* v) {
         return sum + v->getAveragePower();
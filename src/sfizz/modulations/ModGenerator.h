@@ -67,6 +67,23 @@ public:
      */
     virtual void generate(const ModKey& sourceKey, NumericId<Voice> voiceNum, absl::Span<float> buffer) = 0;
 
+    /**
+     * @brief Generate a cycle of the modulator at control rate
+     * The output only needs to be exact at the frames which are multiples of
+     * `step`, and it may hold these values in between. By default, the cycle
+     * is generated at full rate.
+     *
+     * @param sourceKey source key
+     * @param voiceNum voice number if the generator is per-voice, otherwise undefined
+     * @param buffer output buffer
+     * @param step interval in frames between the exact values
+     */
+    virtual void generateDecimated(const ModKey& sourceKey, NumericId<Voice> voiceNum, absl::Span<float> buffer, unsigned step)
+    {
+        (void)step;
+        generate(sourceKey, voiceNum, buffer);
+    }
+
     /**
      * @brief Advance the generator by a number of frames
      * This is called instead of `generate` in case the output is discarded.
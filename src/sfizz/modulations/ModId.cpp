@@ -65,17 +65,17 @@ int ModIds::flags(ModId id) noexcept
     case ModId::Volume:
         return kModIsPerVoice|kModIsAdditive;
     case ModId::FilGain:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::FilCutoff:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::FilResonance:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::EqGain:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::EqFrequency:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::EqBandwidth:
-        return kModIsPerVoice|kModIsAdditive;
+        return kModIsPerVoice|kModIsAdditive|kModIsControlRate;
     case ModId::OscillatorDetune:
         return kModIsPerVoice|kModIsAdditive;
     case ModId::OscillatorModDepth:
@@ -110,6 +110,8 @@ enum ModFlags : int {
     kModIsAdditive = 1 << 3,
     //! This target is multiplicative (T)
     kModIsMultiplicative = 1 << 4,
+    //! This target is only read every `config::filterControlInterval` frames (T)
+    kModIsControlRate = 1 << 5,
 };
 
 namespace ModIds {
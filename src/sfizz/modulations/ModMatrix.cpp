@@ -24,16 +24,22 @@ struct ModMatrix::Impl {
     uint32_t samplesPerBlock_ {};
 
     uint32_t numFrames_ {};
-    NumericId<Voice> currentVoiceId_ {};
-    NumericId<Region> currentRegionId_ {};
 
-    float currentVoiceTriggerValue_ {};
+    bool controlRate_ { config::controlRateModulation };
+
+    struct ModBuffer {
+        bool ready {};
+        float* data {};
+    };
 
     struct Source {
         ModKey key;
         ModGenerator* gen {};
-        bool bufferReady {};
-        Buffer<float> buffer;
+        uint32_t localIndex {};
+        Buffer<float> sharedData;
+        ModBuffer shared;
+        // all the targets of this source are read at control rate
+        bool controlRateOnly {};
     };
 
     struct ConnectionData {
@@ -47,10 +53,51 @@ struct ModMatrix::Impl {
         ModKey key;
         uint32_t region {};
         absl::flat_hash_map<uint32_t, ConnectionData> connectedSources;
-        bool bufferReady {};
-        Buffer<float> buffer;
+        uint32_t localIndex {};
+        Buffer<float> sharedData;
+        ModBuffer shared;
+        // ranges of the compiled program
+        uint32_t connectionsBegin {};
+        uint32_t connectionsEnd {};
+        uint32_t dependenciesBegin {};
+        uint32_t dependenciesEnd {};
+    };
+
+    static constexpr uint32_t noTarget = ~uint32_t(0);
+
+    // A connection of the compiled program, which `init` flattens out of
+    // the connected sources of the targets.
+    struct Connection {
+        uint32_t sourceIndex {};
+        uint32_t depthModIndex { noTarget };
+        float sourceDepth {};
+        float velToDepth {};
+        // the source is per-voice and must match the region of the voice
+        bool checkRegion {};
     };
 
+    // The state of the voice being processed on a given render slot.
+    // Per-voice sources and targets are stored here, indexed by their
+    // position among the modulations of their own region. Their buffers
+    // are laid out one after the other in a single block of memory.
+    struct VoiceContext {
+        NumericId<Voice> voiceId;
+        NumericId<Region> regionId;
+        float triggerValue {};
+        Buffer<float> data;
+        std::vector<ModBuffer> sources;
+        std::vector<ModBuffer> targets;
+    };
+
+    VoiceContext& getContext(unsigned slot) noexcept;
+    ModBuffer& getBuffer(VoiceContext& context, Source& source) noexcept;
+    ModBuffer& getBuffer(VoiceContext& context, Target& target) noexcept;
+    void resizeContexts();
+    void compileTargets();
+    void collectDependencies(uint32_t targetIndex, std::vector<bool>& visited);
+    float* runTarget(VoiceContext& context, uint32_t targetIndex) noexcept;
+    void generateSource(Source& source, NumericId<Voice> voiceId, absl::Span<float> buffer) noexcept;
+
     absl::flat_hash_map<ModKey, uint32_t> sourceIndex_;
     absl::flat_hash_map<ModKey, uint32_t> targetIndex_;
 
@@ -60,14 +107,122 @@ struct ModMatrix::Impl {
     int maxRegionIdx_ { -1 };
     std::vector<std::vector<uint32_t>> sourceIndicesForRegion_;
     std::vector<std::vector<uint32_t>> targetIndicesForRegion_;
+    size_t maxSourcesPerRegion_ {};
+    size_t maxTargetsPerRegion_ {};
 
     std::vector<Source> sources_;
     std::vector<Target> targets_;
+
+    std::vector<Connection> connections_;
+    std::vector<uint32_t> dependencies_;
+
+    std::vector<VoiceContext> contexts_;
 };
 
+ModMatrix::Impl::VoiceContext& ModMatrix::Impl::getContext(unsigned slot) noexcept
+{
+    ASSERT(slot < contexts_.size());
+    return contexts_[slot];
+}
+
+ModMatrix::Impl::ModBuffer& ModMatrix::Impl::getBuffer(VoiceContext& context, Source& source) noexcept
+{
+    return (source.key.flags() & kModIsPerVoice) ?
+        context.sources[source.localIndex] : source.shared;
+}
+
+ModMatrix::Impl::ModBuffer& ModMatrix::Impl::getBuffer(VoiceContext& context, Target& target) noexcept
+{
+    return (target.key.flags() & kModIsPerVoice) ?
+        context.targets[target.localIndex] : target.shared;
+}
+
+void ModMatrix::Impl::resizeContexts()
+{
+    // Keep every buffer on its own cache lines
+    const size_t stride = (samplesPerBlock_ + 15) & ~size_t(15);
+    const size_t numBuffers = maxSourcesPerRegion_ + maxTargetsPerRegion_;
+
+    for (VoiceContext& context : contexts_) {
+        context.data.resize(numBuffers * stride);
+        context.sources.resize(maxSourcesPerRegion_);
+        context.targets.resize(maxTargetsPerRegion_);
+        float* data = context.data.data();
+        for (ModBuffer& buffer : context.sources) {
+            buffer.data = data;
+            data += stride;
+        }
+        for (ModBuffer& buffer : context.targets) {
+            buffer.data = data;
+            data += stride;
+        }
+    }
+}
+
+void ModMatrix::Impl::compileTargets()
+{
+    connections_.clear();
+    dependencies_.clear();
+
+    for (Source& source : sources_)
+        source.controlRateOnly = true;
+
+    for (Target& target : targets_) {
+        const bool perVoiceTarget = target.key.flags() & kModIsPerVoice;
+        target.connectionsBegin = static_cast<uint32_t>(connections_.size());
+        for (const auto& cs : target.connectedSources) {
+            Source& source = sources_[cs.first];
+            const ConnectionData& data = cs.second;
+            const bool perVoiceSource = source.key.flags() & kModIsPerVoice;
+
+            if (!(target.key.flags() & kModIsControlRate))
+                source.controlRateOnly = false;
+
+            // a per-voice target only runs for the voices of its own region
+            if (perVoiceSource && perVoiceTarget && source.key.region() != target.key.region())
+                continue;
+
+            Connection conn;
+            conn.sourceIndex = cs.first;
+            if (static_cast<unsigned>(data.sourceDepthModId_.number()) < targets_.size())
+                conn.depthModIndex = static_cast<uint32_t>(data.sourceDepthModId_.number());
+            conn.sourceDepth = data.sourceDepth_;
+            conn.velToDepth = perVoiceSource ? data.velToDepth_ : 0.0f;
+            conn.checkRegion = perVoiceSource && !perVoiceTarget;
+            connections_.push_back(conn);
+        }
+        target.connectionsEnd = static_cast<uint32_t>(connections_.size());
+    }
+
+    // The depth modulations which a target requires, transitively, in the
+    // order of evaluation. In case of a cycle, the order is arbitrary.
+    std::vector<bool> visited(targets_.size());
+    for (uint32_t i = 0; i < targets_.size(); ++i) {
+        Target& target = targets_[i];
+        target.dependenciesBegin = static_cast<uint32_t>(dependencies_.size());
+        std::fill(visited.begin(), visited.end(), false);
+        collectDependencies(i, visited);
+        target.dependenciesEnd = static_cast<uint32_t>(dependencies_.size());
+    }
+}
+
+void ModMatrix::Impl::collectDependencies(uint32_t targetIndex, std::vector<bool>& visited)
+{
+    visited[targetIndex] = true;
+    const Target& target = targets_[targetIndex];
+    for (uint32_t c = target.connectionsBegin; c < target.connectionsEnd; ++c) {
+        const uint32_t depthModIndex = connections_[c].depthModIndex;
+        if (depthModIndex != noTarget && !visited[depthModIndex]) {
+            collectDependencies(depthModIndex, visited);
+            dependencies_.push_back(depthModIndex);
+        }
+    }
+}
+
 ModMatrix::ModMatrix()
     : impl_(new Impl)
 {
+    setNumContexts(1);
     setSampleRate(config::defaultSampleRate);
     setSamplesPerBlock(config::defaultSamplesPerBlock);
 }
@@ -88,7 +243,12 @@ void ModMatrix::clear()
     impl.targetIndicesForGlobal_.clear();
     impl.sourceIndicesForRegion_.clear();
     impl.targetIndicesForRegion_.clear();
+    impl.connections_.clear();
+    impl.dependencies_.clear();
+    impl.maxSourcesPerRegion_ = 0;
+    impl.maxTargetsPerRegion_ = 0;
     impl.maxRegionIdx_ = -1;
+    impl.resizeContexts();
 }
 
 void ModMatrix::setSampleRate(double sampleRate)
@@ -114,11 +274,41 @@ void ModMatrix::setSamplesPerBlock(unsigned samplesPerBlock)
     impl.samplesPerBlock_ = samplesPerBlock;
 
     for (Impl::Source &source : impl.sources_) {
-        source.buffer.resize(samplesPerBlock);
+        if (!(source.key.flags() & kModIsPerVoice)) {
+            source.sharedData.resize(samplesPerBlock);
+            source.shared.data = source.sharedData.data();
+        }
         source.gen->setSamplesPerBlock(samplesPerBlock);
     }
-    for (Impl::Target &target : impl.targets_)
-        target.buffer.resize(samplesPerBlock);
+    for (Impl::Target &target : impl.targets_) {
+        if (!(target.key.flags() & kModIsPerVoice)) {
+            target.sharedData.resize(samplesPerBlock);
+            target.shared.data = target.sharedData.data();
+        }
+    }
+
+    impl.resizeContexts();
+}
+
+void ModMatrix::setNumContexts(unsigned numContexts)
+{
+    Impl& impl = *impl_;
+    ASSERT(numContexts > 0);
+
+    impl.contexts_.resize(numContexts);
+    impl.resizeContexts();
+}
+
+void ModMatrix::setControlRate(bool controlRate)
+{
+    Impl& impl = *impl_;
+    impl.controlRate_ = controlRate;
+}
+
+bool ModMatrix::isControlRate() const noexcept
+{
+    Impl& impl = *impl_;
+    return impl.controlRate_;
 }
 
 ModMatrix::SourceId ModMatrix::registerSource(const ModKey& key, ModGenerator& gen)
@@ -137,8 +327,11 @@ ModMatrix::SourceId ModMatrix::registerSource(const ModKey& key, ModGenerator& g
     Impl::Source &source = impl.sources_.back();
     source.key = key;
     source.gen = &gen;
-    source.bufferReady = false;
-    source.buffer.resize(impl.samplesPerBlock_);
+    // per-voice buffers are held by the voice contexts
+    if (!(key.flags() & kModIsPerVoice)) {
+        source.sharedData.resize(impl.samplesPerBlock_);
+        source.shared.data = source.sharedData.data();
+    }
 
     impl.sourceIndex_[key] = id.number();
     if (key.region().number() > impl.maxRegionIdx_)
@@ -163,8 +356,10 @@ ModMatrix::TargetId ModMatrix::registerTarget(const ModKey& key)
 
     Impl::Target &target = impl.targets_.back();
     target.key = key;
-    target.bufferReady = false;
-    target.buffer.resize(impl.samplesPerBlock_);
+    if (!(key.flags() & kModIsPerVoice)) {
+        target.sharedData.resize(impl.samplesPerBlock_);
+        target.shared.data = target.sharedData.data();
+    }
 
     impl.targetIndex_[key] = id.number();
     if (key.region().number() > impl.maxRegionIdx_)
@@ -237,7 +432,10 @@ void ModMatrix::init()
         }
         else if (flags & kModIsPerVoice) {
             ASSERT(source.key.region());
-            impl.sourceIndicesForRegion_[source.key.region().number()].push_back(i);
+            std::vector<uint32_t>& indices = impl.sourceIndicesForRegion_[source.key.region().number()];
+            source.localIndex = static_cast<uint32_t>(indices.size());
+            indices.push_back(i);
+            impl.maxSourcesPerRegion_ = std::max(impl.maxSourcesPerRegion_, indices.size());
         }
     }
 
@@ -250,9 +448,15 @@ void ModMatrix::init()
         }
         else if (flags & kModIsPerVoice) {
             ASSERT(target.key.region());
-            impl.targetIndicesForRegion_[target.key.region().number()].push_back(i);
+            std::vector<uint32_t>& indices = impl.targetIndicesForRegion_[target.key.region().number()];
+            target.localIndex = static_cast<uint32_t>(indices.size());
+            indices.push_back(i);
+            impl.maxTargetsPerRegion_ = std::max(impl.maxTargetsPerRegion_, indices.size());
         }
     }
+
+    impl.compileTargets();
+    impl.resizeContexts();
 }
 
 void ModMatrix::initVoice(NumericId<Voice> voiceId, NumericId<Region> regionId, unsigned delay)
@@ -302,12 +506,30 @@ void ModMatrix::beginCycle(unsigned numFrames)
 
     for (auto idx: impl.sourceIndicesForGlobal_) {
         Impl::Source& source = impl.sources_[idx];
-        source.bufferReady = false;
+        source.shared.ready = false;
     }
     for (auto idx: impl.targetIndicesForGlobal_) {
         Impl::Target& target = impl.targets_[idx];
-        target.bufferReady = false;
+        target.shared.ready = false;
+    }
+}
+
+void ModMatrix::precomputePerCycle()
+{
+    Impl& impl = *impl_;
+    const uint32_t numFrames = impl.numFrames_;
+
+    for (auto idx: impl.sourceIndicesForGlobal_) {
+        Impl::Source& source = impl.sources_[idx];
+        if (!source.shared.ready) {
+            absl::Span<float> buffer(source.shared.data, numFrames);
+            impl.generateSource(source, {}, buffer);
+            source.shared.ready = true;
+        }
     }
+    // the global targets do not depend on the context of a voice
+    for (auto idx: impl.targetIndicesForGlobal_)
+        getModulation(TargetId(static_cast<int>(idx)), 0);
 }
 
 void ModMatrix::endCycle()
@@ -317,8 +539,8 @@ void ModMatrix::endCycle()
 
     for (auto idx: impl.sourceIndicesForGlobal_) {
         Impl::Source& source = impl.sources_[idx];
-        if (!source.bufferReady) {
-            absl::Span<float> buffer(source.buffer.data(), numFrames);
+        if (!source.shared.ready) {
+            absl::Span<float> buffer(source.shared.data, numFrames);
             source.gen->generateDiscarded(source.key, {}, buffer);
         }
     }
@@ -326,35 +548,37 @@ void ModMatrix::endCycle()
     impl.numFrames_ = 0;
 }
 
-void ModMatrix::beginVoice(NumericId<Voice> voiceId, NumericId<Region> regionId, float triggerValue)
+void ModMatrix::beginVoice(NumericId<Voice> voiceId, NumericId<Region> regionId, float triggerValue, unsigned slot)
 {
     Impl& impl = *impl_;
+    Impl::VoiceContext& context = impl.getContext(slot);
 
-    impl.currentVoiceId_ = voiceId;
-    impl.currentRegionId_ = regionId;
+    context.voiceId = voiceId;
+    context.regionId = regionId;
 
-    impl.currentVoiceTriggerValue_ = triggerValue;
+    context.triggerValue = triggerValue;
 
     ASSERT(regionId);
 
     const auto idNumber = static_cast<size_t>(regionId.number());
     for (auto idx: impl.sourceIndicesForRegion_[idNumber]) {
         Impl::Source& source = impl.sources_[idx];
-        source.bufferReady = false;
+        context.sources[source.localIndex].ready = false;
     }
 
     for (auto idx: impl.targetIndicesForRegion_[idNumber]) {
         Impl::Target& target = impl.targets_[idx];
-        target.bufferReady = false;
+        context.targets[target.localIndex].ready = false;
     }
 }
 
-void ModMatrix::endVoice()
+void ModMatrix::endVoice(unsigned slot)
 {
     Impl& impl = *impl_;
+    Impl::VoiceContext& context = impl.getContext(slot);
     const uint32_t numFrames = impl.numFrames_;
-    const NumericId<Voice> voiceId = impl.currentVoiceId_;
-    const NumericId<Region> regionId = impl.currentRegionId_;
+    const NumericId<Voice> voiceId = context.voiceId;
+    const NumericId<Region> regionId = context.regionId;
 
     ASSERT(regionId);
     ASSERT(static_cast<size_t>(regionId.number()) < impl.sourceIndicesForRegion_.size());
@@ -362,118 +586,131 @@ void ModMatrix::endVoice()
     const auto idNumber = static_cast<size_t>(regionId.number());
 
     for (auto idx: impl.sourceIndicesForRegion_[idNumber]) {
-        const Impl::Source& source = impl.sources_[idx];
-        if (!source.bufferReady) {
-            absl::Span<float> buffer(source.buffer.data(), numFrames);
+        Impl::Source& source = impl.sources_[idx];
+        Impl::ModBuffer& sourceBuffer = context.sources[source.localIndex];
+        if (!sourceBuffer.ready) {
+            absl::Span<float> buffer(sourceBuffer.data, numFrames);
             source.gen->generateDiscarded(source.key, voiceId, buffer);
         }
     }
 
-    impl.currentVoiceId_ = {};
-    impl.currentRegionId_ = {};
+    context.voiceId = {};
+    context.regionId = {};
 
-    impl.currentVoiceTriggerValue_ = 0.0f;
+    context.triggerValue = 0.0f;
 }
 
-float* ModMatrix::getModulation(TargetId targetId)
+float* ModMatrix::getModulation(TargetId targetId, unsigned slot)
 {
     if (!validTarget(targetId))
         return nullptr;
 
     Impl& impl = *impl_;
-    const NumericId<Region> regionId = impl.currentRegionId_;
-    const float triggerValue = impl.currentVoiceTriggerValue_;
+    Impl::VoiceContext& context = impl.getContext(slot);
     const uint32_t targetIndex = targetId.number();
-    Impl::Target &target = impl.targets_[targetIndex];
-    const int targetFlags = target.key.flags();
+    const Impl::Target& target = impl.targets_[targetIndex];
 
-    const uint32_t numFrames = impl.numFrames_;
-    absl::Span<float> buffer(target.buffer.data(), numFrames);
+    // only accept per-voice targets of the same region
+    if ((target.key.flags() & kModIsPerVoice) && context.regionId != target.key.region())
+        return nullptr;
+
+    // run the depth modulations first, so that none of the targets recurses
+    for (uint32_t d = target.dependenciesBegin; d < target.dependenciesEnd; ++d)
+        impl.runTarget(context, impl.dependencies_[d]);
+
+    return impl.runTarget(context, targetIndex);
+}
+
+float* ModMatrix::Impl::runTarget(VoiceContext& context, uint32_t targetIndex) noexcept
+{
+    const NumericId<Region> regionId = context.regionId;
+    const float triggerValue = context.triggerValue;
+    Target &target = targets_[targetIndex];
+    const int targetFlags = target.key.flags();
 
     // only accept per-voice targets of the same region
     if ((targetFlags & kModIsPerVoice) && regionId != target.key.region())
         return nullptr;
 
+    ModBuffer& targetBuffer = getBuffer(context, target);
+    const uint32_t numFrames = numFrames_;
+    absl::Span<float> buffer(targetBuffer.data, numFrames);
+
     // check if already processed
-    if (target.bufferReady)
+    if (targetBuffer.ready)
         return buffer.data();
 
-    // set the ready flag to prevent a cycle
-    // in case there is, be sure to initialize the buffer
-    target.bufferReady = true;
+    // set the ready flag, in case the target is part of a cycle
+    targetBuffer.ready = true;
 
-    auto sourcesPos = target.connectedSources.begin();
-    auto sourcesEnd = target.connectedSources.end();
     bool isFirstSource = true;
 
     // generate sources in their dedicated buffers
     // then add or multiply, depending on target flags
-    while (sourcesPos != sourcesEnd) {
-        Impl::Source &source = impl.sources_[sourcesPos->first];
-        const int sourceFlags = source.key.flags();
+    for (uint32_t c = target.connectionsBegin; c < target.connectionsEnd; ++c) {
+        const Connection& conn = connections_[c];
+        Source &source = sources_[conn.sourceIndex];
 
         // only accept per-voice sources of the same region
-        bool useThisSource = true;
-        if (sourceFlags & kModIsPerVoice)
-            useThisSource = (regionId == source.key.region());
+        if (conn.checkRegion && regionId != source.key.region())
+            continue;
 
-        if (useThisSource) {
-            absl::Span<float> sourceBuffer(source.buffer.data(), numFrames);
+        ModBuffer& sourceData = getBuffer(context, source);
+        absl::Span<float> sourceBuffer(sourceData.data, numFrames);
 
-            // unless source is already done, process it
-            if (!source.bufferReady) {
-                source.gen->generate(source.key, impl.currentVoiceId_, sourceBuffer);
-                source.bufferReady = true;
-            }
+        // unless source is already done, process it
+        if (!sourceData.ready) {
+            generateSource(source, context.voiceId, sourceBuffer);
+            sourceData.ready = true;
+        }
 
-            float sourceDepth = sourcesPos->second.sourceDepth_;
-            if (sourceFlags & kModIsPerVoice) {
-                const float velToDepth = sourcesPos->second.velToDepth_;
-                sourceDepth += triggerValue * velToDepth;
-            }
+        const float sourceDepth = conn.sourceDepth + triggerValue * conn.velToDepth;
 
-            const float* sourceDepthMod = getModulation(sourcesPos->second.sourceDepthModId_);
+        // the depth modulations were run ahead, unless part of a cycle
+        const float* sourceDepthMod = nullptr;
+        if (conn.depthModIndex != noTarget) {
+            Target& depthModTarget = targets_[conn.depthModIndex];
+            if (!(depthModTarget.key.flags() & kModIsPerVoice) || regionId == depthModTarget.key.region())
+                sourceDepthMod = getBuffer(context, depthModTarget).data;
+        }
 
-            if (isFirstSource) {
-                if (sourceDepth == 1 && !sourceDepthMod)
-                    copy(absl::Span<const float>(sourceBuffer), buffer);
-                else if (!sourceDepthMod) {
-                    for (uint32_t i = 0; i < numFrames; ++i)
-                        buffer[i] = sourceDepth * sourceBuffer[i];
-                }
-                else if (targetFlags & kModIsMultiplicative) {
-                    for (uint32_t i = 0; i < numFrames; ++i)
-                        buffer[i] = (sourceDepth * sourceDepthMod[i]) * sourceBuffer[i];
-                }
+        if (isFirstSource) {
+            if (sourceDepth == 1 && !sourceDepthMod)
+                copy(absl::Span<const float>(sourceBuffer), buffer);
+            else if (!sourceDepthMod) {
+                for (uint32_t i = 0; i < numFrames; ++i)
+                    buffer[i] = sourceDepth * sourceBuffer[i];
+            }
+            else if (targetFlags & kModIsMultiplicative) {
+                for (uint32_t i = 0; i < numFrames; ++i)
+                    buffer[i] = (sourceDepth * sourceDepthMod[i]) * sourceBuffer[i];
+            }
+            else {
+                ASSERT(targetFlags & kModIsAdditive);
+                for (uint32_t i = 0; i < numFrames; ++i)
+                    buffer[i] = (sourceDepth + sourceDepthMod[i]) * sourceBuffer[i];
+            }
+            isFirstSource = false;
+        }
+        else {
+            if (targetFlags & kModIsMultiplicative) {
+                if (!sourceDepthMod)
+                    multiplyMul1<float>(sourceDepth, sourceBuffer, buffer);
                 else {
-                    ASSERT(targetFlags & kModIsAdditive);
                     for (uint32_t i = 0; i < numFrames; ++i)
-                        buffer[i] = (sourceDepth + sourceDepthMod[i]) * sourceBuffer[i];
+                        buffer[i] *= (sourceDepth * sourceDepthMod[i]) * sourceBuffer[i];
                 }
-                isFirstSource = false;
             }
             else {
-                if (targetFlags & kModIsMultiplicative) {
-                    if (!sourceDepthMod)
-                        multiplyMul1<float>(sourceDepth, sourceBuffer, buffer);
-                    else {
-                        for (uint32_t i = 0; i < numFrames; ++i)
-                            buffer[i] *= (sourceDepth * sourceDepthMod[i]) * sourceBuffer[i];
-                    }
-                }
+                ASSERT(targetFlags & kModIsAdditive);
+                if (!sourceDepthMod)
+                    multiplyAdd1<float>(sourceDepth, sourceBuffer, buffer);
                 else {
-                    ASSERT(targetFlags & kModIsAdditive);
-                    if (!sourceDepthMod)
-                        multiplyAdd1<float>(sourceDepth, sourceBuffer, buffer);
-                    else {
-                        for (uint32_t i = 0; i < numFrames; ++i)
-                            buffer[i] += (sourceDepth + sourceDepthMod[i]) * sourceBuffer[i];
-                    }
+                    for (uint32_t i = 0; i < numFrames; ++i)
+                        buffer[i] += (sourceDepth + sourceDepthMod[i]) * sourceBuffer[i];
                 }
             }
         }
-
-        ++sourcesPos;
     }
 
     // if there were no source, fill output with the neutral element
@@ -489,6 +726,14 @@ float* ModMatrix::getModulation(TargetId targetId)
     return buffer.data();
 }
 
+void ModMatrix::Impl::generateSource(Source& source, NumericId<Voice> voiceId, absl::Span<float> buffer) noexcept
+{
+    if (controlRate_ && source.controlRateOnly)
+        source.gen->generateDecimated(source.key, voiceId, buffer, config::filterControlInterval);
+    else
+        source.gen->generate(source.key, voiceId, buffer);
+}
+
 bool ModMatrix::validTarget(TargetId id) const
 {
     return static_cast<unsigned>(id.number()) < impl_->targets_.size();
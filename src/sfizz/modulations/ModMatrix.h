@@ -53,6 +53,30 @@ public:
      */
     void setSamplesPerBlock(unsigned samplesPerBlock);
 
+    /**
+     * @brief Set the number of voice contexts, which is the number of voices
+     * that can be processed concurrently. The voice functions select their
+     * context by the render slot which they are passed.
+     *
+     * @param numContexts new number of contexts
+     */
+    void setNumContexts(unsigned numContexts);
+
+    /**
+     * @brief Enable or disable the control-rate evaluation of modulations.
+     * When enabled, the sources which only modulate control-rate targets are
+     * evaluated once every `config::filterControlInterval` frames, and their
+     * values are held in between.
+     *
+     * @param controlRate
+     */
+    void setControlRate(bool controlRate);
+
+    /**
+     * @brief Get whether the control-rate evaluation of modulations is enabled.
+     */
+    bool isControlRate() const noexcept;
+
     /**
      * @brief Register a modulation source inside the matrix.
      * If it is already present, it just returns the existing id.
@@ -135,6 +159,13 @@ public:
      */
     void endCycle();
 
+    /**
+     * @brief Generate the per-cycle modulations ahead of the voices.
+     * After this call, the voices can be processed concurrently provided
+     * each thread uses a distinct slot.
+     */
+    void precomputePerCycle();
+
     /**
      * @brief Start modulation processing for a given voice.
      * This clears all the buffers which are per-voice.
@@ -142,31 +173,37 @@ public:
      * @param voiceId the identifier of the current voice
      * @param regionId the identifier of the region of the current voice
      * @param triggerValue the velocity of the current voice
+     * @param slot the render slot which processes the voice
      */
-    void beginVoice(NumericId<Voice> voiceId, NumericId<Region> regionId, float triggerValue);
+    void beginVoice(NumericId<Voice> voiceId, NumericId<Region> regionId, float triggerValue, unsigned slot);
 
     /**
-     * @brief End modulation processing for a given voice.
-     * This performs a dummy run of any unused modulations which are per-cycle.
+     * @brief End modulation processing for the voice of a slot.
+     * This performs a dummy run of any unused modulations which are per-voice.
+     *
+     * @param slot the render slot which processes the voice
      */
-    void endVoice();
+    void endVoice(unsigned slot);
 
     /**
-     * @brief Get the modulation buffer for the given target.
+     * @brief Get the modulation buffer for the given target, in the context
+     * of the voice which a slot processes.
      * If the target does not exist, the result is null.
      *
      * @param targetId identifier of the modulation target
+     * @param slot the render slot of the calling thread
      */
-    float* getModulation(TargetId targetId);
+    float* getModulation(TargetId targetId, unsigned slot);
 
     /**
      * @brief Get the modulation buffer for the given target.
      * Same as `getModulation`, but accepting a key directly.
      *
      * @param targetKey key of the modulation target
+     * @param slot the render slot of the calling thread
      */
-    float* getModulationByKey(const ModKey& targetKey)
-        { return getModulation(findTarget(targetKey)); }
+    float* getModulationByKey(const ModKey& targetKey, unsigned slot)
+        { return getModulation(findTarget(targetKey), slot); }
 
     /**
      * @brief Return whether the target identifier is valid.
@@ -5,22 +5,35 @@
 // If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
 
 #include "Controller.h"
+#include "../ModMatrix.h"
 #include "../ModKey.h"
+#include "../ModId.h"
 #include "../../Smoothers.h"
 #include "../../ModifierHelpers.h"
 #include "../../Resources.h"
 #include "../../Config.h"
+#include "../../utility/StringViewHelpers.h"
 #include "../../utility/Debug.h"
 #include <absl/container/flat_hash_map.h>
+#include <algorithm>
+#include <vector>
 
 namespace sfz {
 
 struct ControllerSource::Impl {
     float getLastTransformedValue(uint16_t cc, uint8_t curve) const noexcept;
+    Smoother* getSmoother(const ModKey& key, NumericId<Voice> voiceId);
     double sampleRate_ = config::defaultSampleRate;
     Resources* res_ = nullptr;
     VoiceManager* voiceManager_ = nullptr;
     absl::flat_hash_map<ModKey, Smoother> smoother_;
+
+    // Per-voice sources have a smoother for every voice, so that voices do
+    // not interfere with each other and can be processed concurrently. These
+    // are allocated beforehand, one smoother per key consecutively per voice.
+    absl::flat_hash_map<ModKey, size_t> voiceKeyIndex_;
+    std::vector<ModKey> voiceKeys_;
+    std::vector<Smoother> voiceSmoothers_;
 };
 
 ControllerSource::ControllerSource(Resources& res, VoiceManager& manager)
@@ -42,12 +55,68 @@ float ControllerSource::Impl::getLastTransformedValue(uint16_t cc, uint8_t curve
     return curve.evalNormalized(lastCCValue);
 }
 
+Smoother* ControllerSource::Impl::getSmoother(const ModKey& key, NumericId<Voice> voiceId)
+{
+    if (!(key.flags() & kModIsPerVoice)) {
+        auto it = smoother_.find(key);
+        return (it != smoother_.end()) ? &it->second : nullptr;
+    }
+
+    auto it = voiceKeyIndex_.find(key);
+    if (it == voiceKeyIndex_.end() || !voiceId.valid())
+        return nullptr;
+
+    const size_t index = static_cast<size_t>(voiceId.number()) * voiceKeys_.size() + it->second;
+    if (index >= voiceSmoothers_.size())
+        return nullptr;
+
+    return &voiceSmoothers_[index];
+}
+
 void ControllerSource::resetSmoothers()
 {
     for (auto& item : impl_->smoother_) {
         const ModKey::Parameters p = item.first.parameters();
         item.second.reset(impl_->getLastTransformedValue(p.cc, p.curve));
     }
+
+    const size_t numVoiceKeys = impl_->voiceKeys_.size();
+    for (size_t i = 0, n = impl_->voiceSmoothers_.size(); i < n; ++i) {
+        const ModKey::Parameters p = impl_->voiceKeys_[i % numVoiceKeys].parameters();
+        impl_->voiceSmoothers_[i].reset(impl_->getLastTransformedValue(p.cc, p.curve));
+    }
+}
+
+void ControllerSource::setupVoiceSmoothers(int numVoices)
+{
+    Impl& impl = *impl_;
+
+    struct VoiceKeyCollector : ModMatrix::KeyVisitor {
+        explicit VoiceKeyCollector(Impl& impl) : impl(impl) {}
+        bool visit(const ModKey& key) override
+        {
+            const bool isController = key.id() == ModId::Controller || key.id() == ModId::PerVoiceController;
+            if (isController && (key.flags() & kModIsPerVoice) && key.parameters().smooth > 0) {
+                if (impl.voiceKeyIndex_.emplace(key, impl.voiceKeys_.size()).second)
+                    impl.voiceKeys_.push_back(key);
+            }
+            return true;
+        }
+        Impl& impl;
+    };
+
+    impl.voiceKeyIndex_.clear();
+    impl.voiceKeys_.clear();
+    VoiceKeyCollector collector(impl);
+    impl.res_->getModMatrix().visitSources(collector);
+
+    const size_t numSmoothers = static_cast<size_t>(std::max(0, numVoices)) * impl.voiceKeys_.size();
+    impl.voiceSmoothers_.resize(numSmoothers);
+
+    for (size_t i = 0; i < numSmoothers; ++i) {
+        const ModKey::Parameters p = impl.voiceKeys_[i % impl.voiceKeys_.size()].parameters();
+        impl.voiceSmoothers_[i].setSmoothing(p.smooth, impl.sampleRate_);
+    }
 }
 
 void ControllerSource::setSampleRate(double sampleRate)
@@ -61,6 +130,12 @@ void ControllerSource::setSampleRate(double sampleRate)
         const ModKey::Parameters p = item.first.parameters();
         item.second.setSmoothing(p.smooth, sampleRate);
     }
+
+    const size_t numVoiceKeys = impl_->voiceKeys_.size();
+    for (size_t i = 0, n = impl_->voiceSmoothers_.size(); i < n; ++i) {
+        const ModKey::Parameters p = impl_->voiceKeys_[i % numVoiceKeys].parameters();
+        impl_->voiceSmoothers_[i].setSmoothing(p.smooth, sampleRate);
+    }
 }
 
 void ControllerSource::setSamplesPerBlock(unsigned count)
@@ -70,11 +145,15 @@ void ControllerSource::setSamplesPerBlock(unsigned count)
 
 void ControllerSource::init(const ModKey& sourceKey, NumericId<Voice> voiceId, unsigned delay)
 {
-    (void)voiceId;
     (void)delay;
 
     const ModKey::Parameters p = sourceKey.parameters();
-    if (p.smooth > 0) {
+    if (sourceKey.flags() & kModIsPerVoice) {
+        // the smoothers of per-voice sources are set up beforehand
+        if (Smoother* s = impl_->getSmoother(sourceKey, voiceId))
+            s->reset(impl_->getLastTransformedValue(p.cc, p.curve));
+    }
+    else if (p.smooth > 0) {
         Smoother s;
         s.setSmoothing(p.smooth, impl_->sampleRate_);
         s.reset(impl_->getLastTransformedValue(p.cc, p.curve));
@@ -198,11 +277,8 @@ void ControllerSource::generate(const ModKey& sourceKey, NumericId<Voice> voiceI
         }
     }
 
-    auto it = impl_->smoother_.find(sourceKey);
-    if (it != impl_->smoother_.end()) {
-        Smoother& s = it->second;
-        s.process(buffer, buffer, canShortcut);
-    }
+    if (Smoother* s = impl_->getSmoother(sourceKey, voiceId))
+        s->process(buffer, buffer, canShortcut);
 }
 
 } // namespace sfz
@@ -26,6 +26,15 @@ public:
      * @brief Reset the smoothers.
      */
     void resetSmoothers();
+
+    /**
+     * @brief Allocate the smoothers of the per-voice sources of the
+     * modulation matrix, for every voice, so that starting voices does not
+     * allocate. Call it after the sources or the number of voices have changed.
+     *
+     * @param numVoices the number of effective voices
+     */
+    void setupVoiceSmoothers(int numVoices);
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
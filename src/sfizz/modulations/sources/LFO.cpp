@@ -65,45 +65,62 @@ void LFOSource::init(const ModKey& sourceKey, NumericId<Voice> voiceId, unsigned
 }
 
 void LFOSource::generate(const ModKey& sourceKey, NumericId<Voice> voiceId, absl::Span<float> buffer)
+{
+    LFO* lfo = getLFO(sourceKey, voiceId);
+    if (!lfo) {
+        fill(buffer, 0.0f);
+        return;
+    }
+
+    lfo->process(buffer, getRenderSlot(voiceId));
+}
+
+void LFOSource::generateDecimated(const ModKey& sourceKey, NumericId<Voice> voiceId, absl::Span<float> buffer, unsigned step)
+{
+    LFO* lfo = getLFO(sourceKey, voiceId);
+    if (!lfo) {
+        fill(buffer, 0.0f);
+        return;
+    }
+
+    lfo->processDecimated(buffer, step, getRenderSlot(voiceId));
+}
+
+unsigned LFOSource::getRenderSlot(NumericId<Voice> voiceId) const
+{
+    const Voice* voice = voiceManager_.getVoiceById(voiceId);
+    return voice ? voice->getRenderSlot() : 0;
+}
+
+LFO* LFOSource::getLFO(const ModKey& sourceKey, NumericId<Voice> voiceId)
 {
     const unsigned lfoIndex = sourceKey.parameters().N;
 
     Voice* voice = voiceManager_.getVoiceById(voiceId);
     if (!voice) {
         ASSERTFALSE;
-        fill(buffer, 0.0f);
-        return;
+        return nullptr;
     }
 
     const Region* region = voice->getRegion();
-    LFO* lfo = nullptr;
 
     switch (sourceKey.id()) {
     case ModId::AmpLFO:
-        lfo = voice->getAmplitudeLFO();
-        break;
+        return voice->getAmplitudeLFO();
     case ModId::PitchLFO:
-        lfo = voice->getPitchLFO();
-        break;
+        return voice->getPitchLFO();
     case ModId::FilLFO:
-        lfo = voice->getFilterLFO();
-        break;
+        return voice->getFilterLFO();
     case ModId::LFO:
-        {
-            if (lfoIndex >= region->lfos.size()) {
-                ASSERTFALSE;
-                fill(buffer, 0.0f);
-                return;
-            }
-            lfo = voice->getLFO(lfoIndex);
+        if (lfoIndex >= region->lfos.size()) {
+            ASSERTFALSE;
+            return nullptr;
         }
-        break;
+        return voice->getLFO(lfoIndex);
     default:
         ASSERTFALSE;
-        return;
+        return nullptr;
     }
-
-    lfo->process(buffer);
 }
 
 } // namespace sfz
@@ -9,14 +9,19 @@
 #include "../../VoiceManager.h"
 namespace sfz {
 class Synth;
+class LFO;
 
 class LFOSource : public ModGenerator {
 public:
     explicit LFOSource(VoiceManager &manager);
     void init(const ModKey& sourceKey, NumericId<Voice> voiceId, unsigned delay) override;
     void generate(const ModKey& sourceKey, NumericId<Voice> voiceId, absl::Span<float> buffer) override;
+    void generateDecimated(const ModKey& sourceKey, NumericId<Voice> voiceId, absl::Span<float> buffer, unsigned step) override;
 
 private:
+    LFO* getLFO(const ModKey& sourceKey, NumericId<Voice> voiceId);
+    unsigned getRenderSlot(NumericId<Voice> voiceId) const;
+
     VoiceManager& voiceManager_;
 };
 
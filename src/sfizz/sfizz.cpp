@@ -9,6 +9,7 @@
 #include "sfizz.hpp"
 #include "sfizz_private.hpp"
 #include "absl/memory/memory.h"
+#include <cstddef>
 
 sfz::Sfizz::Sfizz()
     : synth(new sfizz_synth_t)
@@ -235,6 +236,24 @@ void sfz::Sfizz::hdPolyAftertouch(int delay, int noteNumber, float aftertouch) n
     synth->synth.hdPolyAftertouch(delay, noteNumber, aftertouch);
 }
 
+void sfz::Sfizz::sendEvents(const Event* events, size_t numEvents) noexcept
+{
+    // Sanity checks for the layout which is shared with the engine
+    static_assert(sizeof(Event) == sizeof(sfz::Synth::Event), "The event layouts should match");
+    static_assert(offsetof(Event, delay) == offsetof(sfz::Synth::Event, delay), "The event layouts should match");
+    static_assert(offsetof(Event, type) == offsetof(sfz::Synth::Event, type), "The event layouts should match");
+    static_assert(offsetof(Event, number) == offsetof(sfz::Synth::Event, number), "The event layouts should match");
+    static_assert(offsetof(Event, value) == offsetof(sfz::Synth::Event, value), "The event layouts should match");
+    static_assert(static_cast<int>(EventNoteOn) == static_cast<int>(sfz::Synth::EventNoteOn), "The event types should match");
+    static_assert(static_cast<int>(EventNoteOff) == static_cast<int>(sfz::Synth::EventNoteOff), "The event types should match");
+    static_assert(static_cast<int>(EventCC) == static_cast<int>(sfz::Synth::EventCC), "The event types should match");
+    static_assert(static_cast<int>(EventPitchWheel) == static_cast<int>(sfz::Synth::EventPitchWheel), "The event types should match");
+    static_assert(static_cast<int>(EventChannelAftertouch) == static_cast<int>(sfz::Synth::EventChannelAftertouch), "The event types should match");
+    static_assert(static_cast<int>(EventPolyAftertouch) == static_cast<int>(sfz::Synth::EventPolyAftertouch), "The event types should match");
+
+    synth->synth.sendEvents(reinterpret_cast<const sfz::Synth::Event*>(events), numEvents);
+}
+
 void sfz::Sfizz::tempo(int delay, float secondsPerBeat) noexcept
 {
     synth->synth.tempo(delay, secondsPerBeat);
@@ -281,6 +300,16 @@ void sfz::Sfizz::setNumVoices(int numVoices) noexcept
     synth->synth.setNumVoices(numVoices);
 }
 
+int sfz::Sfizz::getNumRenderThreads() const noexcept
+{
+    return synth->synth.getNumRenderThreads();
+}
+
+void sfz::Sfizz::setNumRenderThreads(int numThreads) noexcept
+{
+    synth->synth.setNumRenderThreads(numThreads);
+}
+
 bool sfz::Sfizz::setOversamplingFactor(int) noexcept
 {
     return true;
@@ -302,6 +331,76 @@ uint32_t sfz::Sfizz::getPreloadSize() const noexcept
     return synth->synth.getPreloadSize();
 }
 
+void sfz::Sfizz::setDiskStreaming(bool diskStreaming) noexcept
+{
+    synth->synth.setDiskStreaming(diskStreaming);
+}
+
+bool sfz::Sfizz::getDiskStreaming() const noexcept
+{
+    return synth->synth.getDiskStreaming();
+}
+
+void sfz::Sfizz::setCompactSampleStorage(bool compactStorage) noexcept
+{
+    synth->synth.setCompactSampleStorage(compactStorage);
+}
+
+bool sfz::Sfizz::getCompactSampleStorage() const noexcept
+{
+    return synth->synth.getCompactSampleStorage();
+}
+
+void sfz::Sfizz::setPreloadCacheDirectory(const std::string& directory)
+{
+    synth->synth.setPreloadCacheDirectory(directory);
+}
+
+void sfz::Sfizz::setSampleSharing(bool sampleSharing) noexcept
+{
+    synth->synth.setSampleSharing(sampleSharing);
+}
+
+bool sfz::Sfizz::getSampleSharing() const noexcept
+{
+    return synth->synth.getSampleSharing();
+}
+
+void sfz::Sfizz::setControlRateModulation(bool controlRate) noexcept
+{
+    synth->synth.setControlRateModulation(controlRate);
+}
+
+bool sfz::Sfizz::getControlRateModulation() const noexcept
+{
+    return synth->synth.getControlRateModulation();
+}
+
+void sfz::Sfizz::setSampleMemoryBudget(size_t numBytes) noexcept
+{
+    synth->synth.setSampleMemoryBudget(numBytes);
+}
+
+size_t sfz::Sfizz::getSampleMemoryBudget() const noexcept
+{
+    return synth->synth.getSampleMemoryBudget();
+}
+
+size_t sfz::Sfizz::getSampleMemoryUsage() const noexcept
+{
+    return synth->synth.getSampleMemoryUsage();
+}
+
+size_t sfz::Sfizz::getNumSampleEvictions() const noexcept
+{
+    return synth->synth.getNumSampleEvictions();
+}
+
+size_t sfz::Sfizz::getSampleEvictedBytes() const noexcept
+{
+    return synth->synth.getSampleEvictedBytes();
+}
+
 int sfz::Sfizz::getAllocatedBuffers() const noexcept
 {
     return synth->synth.getAllocatedBuffers();
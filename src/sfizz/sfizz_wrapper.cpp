@@ -10,6 +10,7 @@
 #include "utility/Macros.h"
 #include "sfizz.h"
 #include "sfizz_private.hpp"
+#include <cstddef>
 #include <limits>
 
 #ifdef __cplusplus
@@ -170,6 +171,26 @@ void sfizz_send_hd_poly_aftertouch(sfizz_synth_t* synth, int delay, int note_num
 {
     synth->synth.hdPolyAftertouch(delay, note_number, aftertouch);
 }
+void sfizz_send_events(sfizz_synth_t* synth, const sfizz_event_t* events, int num_events)
+{
+    // Sanity checks for the layout which is shared with the engine
+    static_assert(sizeof(sfizz_event_t) == sizeof(sfz::Synth::Event), "The event layouts should match");
+    static_assert(offsetof(sfizz_event_t, delay) == offsetof(sfz::Synth::Event, delay), "The event layouts should match");
+    static_assert(offsetof(sfizz_event_t, type) == offsetof(sfz::Synth::Event, type), "The event layouts should match");
+    static_assert(offsetof(sfizz_event_t, number) == offsetof(sfz::Synth::Event, number), "The event layouts should match");
+    static_assert(offsetof(sfizz_event_t, value) == offsetof(sfz::Synth::Event, value), "The event layouts should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_NOTE_ON) == static_cast<int>(sfz::Synth::EventNoteOn), "The event types should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_NOTE_OFF) == static_cast<int>(sfz::Synth::EventNoteOff), "The event types should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_CC) == static_cast<int>(sfz::Synth::EventCC), "The event types should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_PITCH_WHEEL) == static_cast<int>(sfz::Synth::EventPitchWheel), "The event types should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_CHANNEL_AFTERTOUCH) == static_cast<int>(sfz::Synth::EventChannelAftertouch), "The event types should match");
+    static_assert(static_cast<int>(SFIZZ_EVENT_POLY_AFTERTOUCH) == static_cast<int>(sfz::Synth::EventPolyAftertouch), "The event types should match");
+
+    if (num_events <= 0)
+        return;
+
+    synth->synth.sendEvents(reinterpret_cast<const sfz::Synth::Event*>(events), static_cast<size_t>(num_events));
+}
 void sfizz_send_tempo(sfizz_synth_t* synth, int delay, float seconds_per_quarter)
 {
     synth->synth.tempo(delay, seconds_per_quarter);
@@ -206,6 +227,68 @@ void sfizz_set_preload_size(sfizz_synth_t* synth, unsigned int preload_size)
     synth->synth.setPreloadSize(preload_size);
 }
 
+void sfizz_set_disk_streaming(sfizz_synth_t* synth, bool disk_streaming)
+{
+    synth->synth.setDiskStreaming(disk_streaming);
+}
+bool sfizz_get_disk_streaming(sfizz_synth_t* synth)
+{
+    return synth->synth.getDiskStreaming();
+}
+
+void sfizz_set_compact_sample_storage(sfizz_synth_t* synth, bool compact_storage)
+{
+    synth->synth.setCompactSampleStorage(compact_storage);
+}
+bool sfizz_get_compact_sample_storage(sfizz_synth_t* synth)
+{
+    return synth->synth.getCompactSampleStorage();
+}
+
+void sfizz_set_preload_cache_directory(sfizz_synth_t* synth, const char* directory)
+{
+    synth->synth.setPreloadCacheDirectory(directory);
+}
+
+void sfizz_set_sample_sharing(sfizz_synth_t* synth, bool sample_sharing)
+{
+    synth->synth.setSampleSharing(sample_sharing);
+}
+bool sfizz_get_sample_sharing(sfizz_synth_t* synth)
+{
+    return synth->synth.getSampleSharing();
+}
+
+void sfizz_set_control_rate_modulation(sfizz_synth_t* synth, bool control_rate)
+{
+    synth->synth.setControlRateModulation(control_rate);
+}
+bool sfizz_get_control_rate_modulation(sfizz_synth_t* synth)
+{
+    return synth->synth.getControlRateModulation();
+}
+
+void sfizz_set_sample_memory_budget(sfizz_synth_t* synth, size_t num_bytes)
+{
+    synth->synth.setSampleMemoryBudget(num_bytes);
+}
+size_t sfizz_get_sample_memory_budget(sfizz_synth_t* synth)
+{
+    return synth->synth.getSampleMemoryBudget();
+}
+size_t sfizz_get_sample_memory_usage(sfizz_synth_t* synth)
+{
+    return synth->synth.getSampleMemoryUsage();
+}
+size_t sfizz_get_num_sample_evictions(sfizz_synth_t* synth)
+{
+    return synth->synth.getNumSampleEvictions();
+}
+size_t sfizz_get_sample_evicted_bytes(sfizz_synth_t* synth)
+{
+    return synth->synth.getSampleEvictedBytes();
+}
+
 sfizz_oversampling_factor_t sfizz_get_oversampling_factor(sfizz_synth_t*)
 {
     return SFIZZ_OVERSAMPLING_X1;
@@ -261,6 +344,16 @@ int sfizz_get_num_voices(sfizz_synth_t* synth)
     return synth->synth.getNumVoices();
 }
 
+void sfizz_set_num_render_threads(sfizz_synth_t* synth, int num_threads)
+{
+    synth->synth.setNumRenderThreads(num_threads);
+}
+
+int sfizz_get_num_render_threads(sfizz_synth_t* synth)
+{
+    return synth->synth.getNumRenderThreads();
+}
+
 int sfizz_get_num_buffers(sfizz_synth_t* synth)
 {
     return synth->synth.getAllocatedBuffers();
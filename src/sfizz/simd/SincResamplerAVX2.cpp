@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "SincResamplerAVX2.h"
+#include "../SIMDConfig.h"
+
+#if SFIZZ_CPU_FAMILY_X86_64 || SFIZZ_CPU_FAMILY_I386
+#include <immintrin.h>
+
+// Everything in here is compiled for AVX2, so the helpers are kept internal:
+// an inline function shared with other units could get its AVX2 version
+// picked by the linker and run on a CPU which does not support it.
+
+namespace sfz {
+
+namespace {
+
+inline __m256 loadSamplesX8(const float* values)
+{
+    return _mm256_loadu_ps(values);
+}
+
+inline __m256 loadSamplesX8(const int16_t* values)
+{
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x));
+}
+
+inline __m128 loadSamplesX4(const float* values)
+{
+    return _mm_loadu_ps(values);
+}
+
+inline __m128 loadSamplesX4(const int16_t* values)
+{
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values));
+    return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(x));
+}
+
+inline __m128 foldX8(__m256 x)
+{
+    return _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+}
+
+inline const float* getRow(const SincBank& bank, float coeff, float& mu)
+{
+    float pos = coeff * bank.numPhases;
+    int p = static_cast<int>(pos);
+    p = (p < 0) ? 0 : (p < int(bank.numPhases)) ? p : int(bank.numPhases) - 1;
+    mu = pos - p;
+    return bank.coeffs + p * bank.points;
+}
+
+/**
+ * Interpolate the frames 0 and 1, with the taps interpolated between the
+ * rows `h0` and `h1` and the next ones. The result is `{ l0, r0, l1, r1 }`,
+ * or `{ y0, y0, y1, y1 }` for a mono source.
+ */
+template <bool Stereo, class T>
+inline __m128 interpolatePair(
+    const float* h0, const float* h1, float mu0, float mu1,
+    const T* l0, const T* r0, const T* l1, const T* r1, unsigned points)
+{
+    const __m256 m0 = _mm256_set1_ps(mu0);
+    const __m256 m1 = _mm256_set1_ps(mu1);
+    __m256 yl0 = _mm256_setzero_ps();
+    __m256 yr0 = _mm256_setzero_ps();
+    __m256 yl1 = _mm256_setzero_ps();
+    __m256 yr1 = _mm256_setzero_ps();
+
+    unsigned i = 0;
+    for (; i + 8 <= points; i += 8) {
+        __m256 a0 = _mm256_loadu_ps(h0 + i);
+        __m256 c0 = _mm256_fmadd_ps(m0, _mm256_sub_ps(_mm256_loadu_ps(h0 + points + i), a0), a0);
+        __m256 a1 = _mm256_loadu_ps(h1 + i);
+        __m256 c1 = _mm256_fmadd_ps(m1, _mm256_sub_ps(_mm256_loadu_ps(h1 + points + i), a1), a1);
+        yl0 = _mm256_fmadd_ps(c0, loadSamplesX8(l0 + i), yl0);
+        yl1 = _mm256_fmadd_ps(c1, loadSamplesX8(l1 + i), yl1);
+        if (Stereo) {
+            yr0 = _mm256_fmadd_ps(c0, loadSamplesX8(r0 + i), yr0);
+            yr1 = _mm256_fmadd_ps(c1, loadSamplesX8(r1 + i), yr1);
+        }
+    }
+
+    __m128 zl0 = foldX8(yl0);
+    __m128 zr0 = foldX8(yr0);
+    __m128 zl1 = foldX8(yl1);
+    __m128 zr1 = foldX8(yr1);
+
+    // the sizes are multiples of 4, so at most a quad of taps is left
+    if (i < points) {
+        __m128 a0 = _mm_loadu_ps(h0 + i);
+        __m128 c0 = _mm_fmadd_ps(_mm256_castps256_ps128(m0), _mm_sub_ps(_mm_loadu_ps(h0 + points + i), a0), a0);
+        __m128 a1 = _mm_loadu_ps(h1 + i);
+        __m128 c1 = _mm_fmadd_ps(_mm256_castps256_ps128(m1), _mm_sub_ps(_mm_loadu_ps(h1 + points + i), a1), a1);
+        zl0 = _mm_fmadd_ps(c0, loadSamplesX4(l0 + i), zl0);
+        zl1 = _mm_fmadd_ps(c1, loadSamplesX4(l1 + i), zl1);
+        if (Stereo) {
+            zr0 = _mm_fmadd_ps(c0, loadSamplesX4(r0 + i), zr0);
+            zr1 = _mm_fmadd_ps(c1, loadSamplesX4(r1 + i), zr1);
+        }
+    }
+
+    if (!Stereo) {
+        zr0 = zl0;
+        zr1 = zl1;
+    }
+
+    return _mm_hadd_ps(_mm_hadd_ps(zl0, zr0), _mm_hadd_ps(zl1, zr1));
+}
+
+template <bool Stereo, bool Adding, class T>
+void resample(
+    const SincBank& bank, const T* left, const T* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames, float scale)
+{
+    const unsigned points = bank.points;
+    const int j0 = 1 - int(points) / 2;
+    const __m128 mmScale = _mm_set1_ps(scale);
+    alignas(16) float y[4];
+
+    for (unsigned n = 0; n < numFrames; n += 2) {
+        // an odd frame at the end is paired with itself
+        const unsigned count = (n + 1 < numFrames) ? 2 : 1;
+        const unsigned n1 = n + count - 1;
+
+        float mu0;
+        float mu1;
+        const float* h0 = getRow(bank, coeffs[n], mu0);
+        const float* h1 = getRow(bank, coeffs[n1], mu1);
+        const int i0 = indices[n] + j0;
+        const int i1 = indices[n1] + j0;
+
+        __m128 result = interpolatePair<Stereo>(
+            h0, h1, mu0, mu1, left + i0, (Stereo ? right : left) + i0,
+            left + i1, (Stereo ? right : left) + i1, points);
+        _mm_store_ps(y, _mm_mul_ps(result, mmScale));
+
+        for (unsigned k = 0; k < count; ++k) {
+            if (Adding) {
+                const float g = addingGains[n + k];
+                outLeft[n + k] += g * y[2 * k];
+                if (Stereo)
+                    outRight[n + k] += g * y[2 * k + 1];
+            } else {
+                outLeft[n + k] = y[2 * k];
+                if (Stereo)
+                    outRight[n + k] = y[2 * k + 1];
+            }
+        }
+    }
+}
+
+template <class T>
+void resampleAny(
+    const SincBank& bank, const T* left, const T* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames, float scale)
+{
+    if (right) {
+        if (addingGains)
+            resample<true, true>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+        else
+            resample<true, false>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+    } else {
+        if (addingGains)
+            resample<false, true>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+        else
+            resample<false, false>(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, scale);
+    }
+}
+
+} // namespace
+
+void sincResampleAVX2(
+    const SincBank& bank, const float* left, const float* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    resampleAny(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, 1.0f);
+}
+
+void sincResampleAVX2(
+    const SincBank& bank, const int16_t* left, const int16_t* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept
+{
+    resampleAny(bank, left, right, indices, coeffs, addingGains, outLeft, outRight, numFrames, 1.0f / 32768);
+}
+
+} // namespace sfz
+#endif
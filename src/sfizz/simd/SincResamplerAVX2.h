@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "../SincResampler.h"
+
+namespace sfz {
+
+// Requires AVX2 and FMA, see `sincResample` for the parameters
+void sincResampleAVX2(
+    const SincBank& bank, const float* left, const float* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept;
+void sincResampleAVX2(
+    const SincBank& bank, const int16_t* left, const int16_t* right,
+    const int* indices, const float* coeffs, const float* addingGains,
+    float* outLeft, float* outRight, unsigned numFrames) noexcept;
+
+} // namespace sfz
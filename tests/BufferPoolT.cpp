@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/BufferPool.h"
+#include "catch2/catch.hpp"
+
+TEST_CASE("[BufferPool] Buffers are given back when going out of scope")
+{
+    sfz::BufferPool pool;
+    pool.setBufferSize(256);
+    pool.setCapacity(4);
+
+    {
+        auto mono = pool.getBuffer(256);
+        auto index = pool.getIndexBuffer(100);
+        REQUIRE(mono);
+        REQUIRE(index);
+        REQUIRE(mono->size() == 256);
+        REQUIRE(index->size() == 100);
+        REQUIRE(static_cast<void*>(mono->data()) != static_cast<void*>(index->data()));
+
+        auto stereo = pool.getStereoBuffer(128);
+        REQUIRE(stereo);
+        REQUIRE(stereo->getNumChannels() == 2);
+        REQUIRE(stereo->getNumFrames() == 128);
+        REQUIRE(pool.getMaxBuffersUsed() == 4);
+
+        auto exhausted = pool.getBuffer(16);
+        REQUIRE(!exhausted);
+        REQUIRE(pool.getNumFailedRequests() == 1);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        auto stereo1 = pool.getStereoBuffer(256);
+        auto stereo2 = pool.getStereoBuffer(256);
+        REQUIRE(stereo1);
+        REQUIRE(stereo2);
+    }
+    REQUIRE(pool.getMaxBuffersUsed() == 4);
+    REQUIRE(pool.getNumFailedRequests() == 1);
+}
+
+TEST_CASE("[BufferPool] Buffers given back out of order")
+{
+    sfz::BufferPool pool;
+    pool.setBufferSize(64);
+    pool.setCapacity(3);
+
+    auto first = pool.getBuffer(64);
+    auto second = pool.getBuffer(64);
+    REQUIRE(first);
+    REQUIRE(second);
+    float* secondData = second->data();
+
+    // the first buffer is freed with the second one, not before
+    first = {};
+    REQUIRE(pool.getBuffer(64));
+    auto third = pool.getBuffer(64);
+    REQUIRE(third);
+    REQUIRE(!pool.getBuffer(64));
+
+    third = {};
+    second = {};
+    auto reused = pool.getBuffer(64);
+    REQUIRE(reused);
+    REQUIRE(reused->data() != secondData);
+    auto reused2 = pool.getBuffer(64);
+    REQUIRE(reused2->data() == secondData);
+}
+
+TEST_CASE("[BufferPool] Oversized requests fail")
+{
+    sfz::BufferPool pool;
+    pool.setBufferSize(64);
+    REQUIRE(!pool.getBuffer(65));
+    REQUIRE(!pool.getStereoBuffer(65));
+    REQUIRE(pool.getNumFailedRequests() == 2);
+    REQUIRE(pool.getMaxBuffersUsed() == 0);
+    pool.resetStatistics();
+    REQUIRE(pool.getNumFailedRequests() == 0);
+}
@@ -7,12 +7,19 @@
 #include "TestHelpers.h"
 #include "sfizz/Synth.h"
 #include "sfizz/Voice.h"
+#include "sfizz/AudioReader.h"
+#include "sfizz/FilePool.h"
+#include "sfizz/PreloadCache.h"
 #include "sfizz/SfzHelpers.h"
 #include "sfizz/parser/Parser.h"
 #include "sfizz/modulations/ModId.h"
 #include "sfizz/modulations/ModKey.h"
 #include "catch2/catch.hpp"
 #include "ghc/fs_std.hpp"
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <thread>
 #if defined(__APPLE__)
 #include <unistd.h> // pathconf
 #endif
@@ -715,3 +722,517 @@ TEST_CASE("[Files] Unused samples are cleared on reloading")
     )");
     REQUIRE(synth.getNumPreloadedSamples() == 0);
 }
+
+TEST_CASE("[Files] Disk streaming matches whole-file loading")
+{
+    const std::string sfzString = R"(
+        <region> sample=stereo_sample.wav key=60 pitch_keycenter=58
+    )";
+
+    // freewheeling waits for the streaming thread to fill the windows
+    sfz::Synth loaded;
+    sfz::Synth streamed;
+    loaded.enableFreeWheeling();
+    streamed.enableFreeWheeling();
+    streamed.setDiskStreaming(true);
+    REQUIRE(streamed.getDiskStreaming());
+
+    for (sfz::Synth* synth : { &loaded, &streamed })
+        synth->loadSfzString(fs::current_path() / "tests/TestFiles/streaming.sfz", sfzString);
+
+    sfz::AudioBuffer<float> loadedBuffer { 2, static_cast<unsigned>(loaded.getSamplesPerBlock()) };
+    sfz::AudioBuffer<float> streamedBuffer { 2, static_cast<unsigned>(streamed.getSamplesPerBlock()) };
+
+    loaded.noteOn(0, 60, 100);
+    streamed.noteOn(0, 60, 100);
+
+    for (int block = 0; block < 40; ++block) {
+        loaded.renderBlock(loadedBuffer);
+        streamed.renderBlock(streamedBuffer);
+        REQUIRE(loaded.getNumActiveVoices() == streamed.getNumActiveVoices());
+        for (unsigned c = 0; c < 2; ++c)
+            REQUIRE(approxEqual(loadedBuffer.getConstSpan(c), streamedBuffer.getConstSpan(c)));
+    }
+
+    streamed.setDiskStreaming(false);
+    REQUIRE(!streamed.getDiskStreaming());
+}
+
+TEST_CASE("[Files] Memory mapped files decode like the file reader")
+{
+    const char* files[] = { "mono_sample.wav", "stereo_sample.wav", "looped_flute.wav" };
+
+    for (const char* filename : files) {
+        const fs::path path = fs::current_path() / "tests/TestFiles" / filename;
+        for (bool reverse : { false, true }) {
+            const auto type = reverse ? sfz::AudioReaderType::Reverse : sfz::AudioReaderType::Forward;
+            sfz::AudioReaderPtr expected = sfz::createExplicitAudioReader(path, type);
+            sfz::AudioReaderPtr actual = sfz::createAudioReader(path, reverse);
+            REQUIRE(actual->type() == type);
+            REQUIRE(actual->channels() == expected->channels());
+            REQUIRE(actual->sampleRate() == expected->sampleRate());
+            REQUIRE(actual->frames() == expected->frames());
+
+            const size_t blockSize = 1000;
+            std::vector<float> expectedBlock(blockSize * expected->channels());
+            std::vector<float> actualBlock(blockSize * actual->channels());
+            size_t numFrames;
+            while ((numFrames = expected->readNextBlock(expectedBlock.data(), blockSize)) > 0) {
+                REQUIRE(actual->readNextBlock(actualBlock.data(), blockSize) == numFrames);
+                REQUIRE(approxEqual<float>(expectedBlock, actualBlock, 1e-6f));
+            }
+            REQUIRE(actual->readNextBlock(actualBlock.data(), blockSize) == 0);
+        }
+    }
+}
+
+TEST_CASE("[Files] Compact sample storage matches float storage")
+{
+    const std::string sfzString = R"(
+        <region> sample=looped_flute.wav key=60 pitch_keycenter=58 loop_mode=loop_continuous loop_crossfade=0.1
+        <region> sample=kick.wav key=62 pitch_keycenter=61
+    )";
+
+    sfz::Synth floating;
+    sfz::Synth compact;
+    compact.setCompactSampleStorage(true);
+    REQUIRE(compact.getCompactSampleStorage());
+
+    for (sfz::Synth* synth : { &floating, &compact }) {
+        synth->enableFreeWheeling();
+        synth->loadSfzString(fs::current_path() / "tests/TestFiles/compact.sfz", sfzString);
+    }
+
+    sfz::FilePool& filePool = compact.getResources().getFilePool();
+    for (int i = 0; i < 2; ++i) {
+        auto promise = filePool.getFilePromise(compact.getRegionView(i)->sampleId);
+        REQUIRE(promise);
+        REQUIRE(promise->compact);
+    }
+
+    sfz::AudioBuffer<float> floatingBuffer { 2, static_cast<unsigned>(floating.getSamplesPerBlock()) };
+    sfz::AudioBuffer<float> compactBuffer { 2, static_cast<unsigned>(compact.getSamplesPerBlock()) };
+
+    for (sfz::Synth* synth : { &floating, &compact }) {
+        synth->noteOn(0, 60, 100);
+        synth->noteOn(0, 62, 100);
+    }
+
+    for (int block = 0; block < 200; ++block) {
+        floating.renderBlock(floatingBuffer);
+        compact.renderBlock(compactBuffer);
+        for (unsigned c = 0; c < 2; ++c)
+            REQUIRE(approxEqual(floatingBuffer.getConstSpan(c), compactBuffer.getConstSpan(c)));
+    }
+
+    compact.setCompactSampleStorage(false);
+    REQUIRE(!compact.getCompactSampleStorage());
+    auto promise = filePool.getFilePromise(compact.getRegionView(0)->sampleId);
+    REQUIRE(promise);
+    REQUIRE(!promise->compact);
+}
+
+TEST_CASE("[Files] Parallel preloading")
+{
+    sfz::Synth synth;
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/preloading.sfz", R"(
+        <region> sample=mono_sample.wav key=60
+        <region> sample=stereo_sample.wav key=61
+        <region> sample=kick.wav key=62
+        <region> sample=looped_flute.wav key=63
+        <region> sample=mono_sample.wav key=64 offset=1000
+        <region> sample=missing_sample.wav key=65
+        <region> sample=*sine key=66
+    )");
+
+    REQUIRE(synth.getNumRegions() == 6);
+    REQUIRE(synth.getNumPreloadedSamples() == 4);
+    REQUIRE(synth.getRegionView(3)->loopRange.getEnd() > 0);
+
+    const fs::path path = fs::current_path() / "tests/TestFiles/mono_sample.wav";
+    sfz::AudioReaderPtr reader = sfz::createAudioReader(path, false);
+    std::vector<float> expected(synth.getPreloadSize() + 1000);
+    reader->readNextBlock(expected.data(), expected.size());
+
+    sfz::FilePool& filePool = synth.getResources().getFilePool();
+    auto promise = filePool.getFilePromise(synth.getRegionView(0)->sampleId);
+    REQUIRE(promise);
+    REQUIRE(promise->information.maxOffset == 1000);
+    auto data = promise->getData();
+    REQUIRE(data.getNumFrames() >= expected.size());
+    REQUIRE(approxEqual<float>(data.getConstSpan(0).first(expected.size()), expected));
+}
+
+TEST_CASE("[Files] Preload cache")
+{
+    const fs::path directory = fs::temp_directory_path() / "sfizz-preload-cache-test";
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+    fs::create_directories(directory);
+    const fs::path sample = directory / "sample.wav";
+    fs::copy_file(fs::current_path() / "tests/TestFiles/stereo_sample.wav", sample);
+
+    sfz::PreloadCache cache;
+    cache.setDirectory(directory / "cache");
+    REQUIRE(cache.isEnabled());
+
+    const sfz::FileId fileId { "sample.wav" };
+    sfz::FileHead stored;
+    stored.information.end = 95303;
+    stored.information.sampleRate = 44100.0;
+    stored.information.numChannels = 2;
+    stored.information.hasLoop = true;
+    stored.information.loopStart = 10;
+    stored.information.loopEnd = 90;
+    stored.data.addChannels(2);
+    stored.data.resize(100);
+    for (unsigned c = 0; c < 2; ++c)
+        std::iota(stored.data.channelWriter(c), stored.data.channelWriterEnd(c), c * 100.0f);
+    REQUIRE(cache.store(sample, fileId, 100, false, stored));
+
+    auto loaded = cache.load(sample, fileId, 100, false);
+    REQUIRE(loaded);
+    REQUIRE(!loaded->compact);
+    REQUIRE(loaded->information.end == 95303);
+    REQUIRE(loaded->information.sampleRate == 44100.0);
+    REQUIRE(loaded->information.numChannels == 2);
+    REQUIRE(loaded->information.hasLoop);
+    REQUIRE(loaded->information.loopStart == 10);
+    REQUIRE(loaded->information.loopEnd == 90);
+    REQUIRE(!loaded->information.wavetable);
+    REQUIRE(loaded->data.getNumChannels() == 2);
+    REQUIRE(loaded->data.getNumFrames() == 100);
+    for (unsigned c = 0; c < 2; ++c)
+        REQUIRE(approxEqual(loaded->data.getConstSpan(c), stored.data.getConstSpan(c), 0.0f));
+
+    // entries are specific to the preloading parameters
+    REQUIRE(!cache.load(sample, fileId, 200, false));
+    REQUIRE(!cache.load(sample, fileId, 100, true));
+    REQUIRE(!cache.load(sample, sfz::FileId { "sample.wav", true }, 100, false));
+
+    // an entry whose data size overflows 32 bits is rejected
+    {
+        fs::path entryPath;
+        for (const fs::directory_entry& item : fs::directory_iterator(directory / "cache"))
+            entryPath = item.path();
+        REQUIRE(entryPath.extension() == ".preload");
+
+        constexpr std::streamoff dataFramesOffset = 96;
+        std::fstream entry(entryPath.string(), std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t dataFrames = 0;
+        entry.seekg(dataFramesOffset);
+        entry.read(reinterpret_cast<char*>(&dataFrames), sizeof(dataFrames));
+        REQUIRE(dataFrames == 100);
+
+        // 2 channels of this many frames wrap to 100 frames in 32 bits
+        const uint32_t overflowingFrames = 0x80000032u;
+        entry.seekp(dataFramesOffset);
+        entry.write(reinterpret_cast<const char*>(&overflowingFrames), sizeof(overflowingFrames));
+        entry.flush();
+        REQUIRE(!cache.load(sample, fileId, 100, false));
+
+        entry.seekp(dataFramesOffset);
+        entry.write(reinterpret_cast<const char*>(&dataFrames), sizeof(dataFrames));
+        entry.flush();
+        REQUIRE(cache.load(sample, fileId, 100, false));
+    }
+
+    // a modified file invalidates its entry
+    fs::last_write_time(sample, fs::last_write_time(sample) + std::chrono::seconds(10));
+    REQUIRE(!cache.load(sample, fileId, 100, false));
+
+    // synths which share the cache preload the same data
+    const std::string sfzString = R"(
+        <region> sample=sample.wav key=60
+        <region> sample=sample.wav key=61 offset=500
+    )";
+    sfz::Synth first;
+    sfz::Synth second;
+    for (sfz::Synth* synth : { &first, &second }) {
+        synth->setPreloadCacheDirectory(directory / "cache");
+        REQUIRE(synth->getPreloadCacheDirectory() == directory / "cache");
+        synth->loadSfzString(directory / "cache.sfz", sfzString);
+        REQUIRE(synth->getNumPreloadedSamples() == 1);
+    }
+
+    const size_t numFrames = first.getPreloadSize() + 500;
+    sfz::FileDataHolder firstData = first.getResources().getFilePool().getFilePromise(first.getRegionView(0)->sampleId);
+    sfz::FileDataHolder secondData = second.getResources().getFilePool().getFilePromise(second.getRegionView(0)->sampleId);
+    REQUIRE(firstData);
+    REQUIRE(secondData);
+    REQUIRE(secondData->information.end == firstData->information.end);
+    REQUIRE(secondData->information.maxOffset == 500);
+    for (unsigned c = 0; c < 2; ++c) {
+        REQUIRE(approxEqual(
+            firstData->getData().getConstSpan(c).first(numFrames),
+            secondData->getData().getConstSpan(c).first(numFrames), 0.0f));
+    }
+
+    firstData.reset();
+    secondData.reset();
+    fs::remove_all(directory, ec);
+}
+
+TEST_CASE("[Files] Preload cache removes the least recently used entries")
+{
+    const fs::path directory = fs::temp_directory_path() / "sfizz-preload-cache-trim-test";
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+    fs::create_directories(directory);
+    const fs::path sample = directory / "sample.wav";
+    fs::copy_file(fs::current_path() / "tests/TestFiles/stereo_sample.wav", sample);
+
+    sfz::PreloadCache cache;
+    cache.setDirectory(directory / "cache");
+    REQUIRE(cache.isEnabled());
+
+    const sfz::FileId fileId { "sample.wav" };
+    sfz::FileHead stored;
+    stored.information.end = 95303;
+    stored.information.sampleRate = 44100.0;
+    stored.information.numChannels = 2;
+    stored.data.addChannels(2);
+    stored.data.resize(100);
+
+    // entries of other preload sizes are left behind when the size changes
+    for (uint32_t preloadSize : { 100u, 200u, 300u })
+        REQUIRE(cache.store(sample, fileId, preloadSize, false, stored));
+
+    std::vector<fs::path> entries;
+    for (const fs::directory_entry& item : fs::directory_iterator(directory / "cache"))
+        entries.push_back(item.path());
+    REQUIRE(entries.size() == 3);
+    const uint64_t entrySize = fs::file_size(entries.front());
+
+    // all entries are old, except the one which is loaded again
+    const auto oldTime = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const fs::path& entry : entries)
+        fs::last_write_time(entry, oldTime);
+    REQUIRE(cache.load(sample, fileId, 200, false));
+
+    cache.setMaxSize(3 * entrySize);
+    cache.trim();
+    REQUIRE(cache.load(sample, fileId, 100, false));
+    REQUIRE(cache.load(sample, fileId, 300, false));
+
+    for (const fs::path& entry : entries)
+        fs::last_write_time(entry, oldTime);
+    REQUIRE(cache.load(sample, fileId, 200, false));
+
+    cache.setMaxSize(entrySize);
+    cache.trim();
+    REQUIRE(cache.load(sample, fileId, 200, false));
+    REQUIRE(!cache.load(sample, fileId, 100, false));
+    REQUIRE(!cache.load(sample, fileId, 300, false));
+
+    fs::remove_all(directory, ec);
+}
+
+TEST_CASE("[Files] Sample sharing between synths")
+{
+    const std::string sfzString = R"(
+        <region> sample=mono_sample.wav key=60
+        <region> sample=stereo_sample.wav key=61
+    )";
+    const fs::path sfzPath = fs::current_path() / "tests/TestFiles/sharing.sfz";
+
+    sfz::Synth first;
+    sfz::Synth second;
+    sfz::Synth unshared;
+    REQUIRE(!first.getSampleSharing());
+    first.setSampleSharing(true);
+    second.setSampleSharing(true);
+    REQUIRE(first.getSampleSharing());
+    for (sfz::Synth* synth : { &first, &second, &unshared }) {
+        synth->loadSfzString(sfzPath, sfzString);
+        REQUIRE(synth->getNumRegions() == 2);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        const std::shared_ptr<sfz::FileId>& fileId = first.getRegionView(i)->sampleId;
+        sfz::FileDataHolder firstData = first.getResources().getFilePool().getFilePromise(fileId);
+        sfz::FileDataHolder secondData = second.getResources().getFilePool().getFilePromise(fileId);
+        sfz::FileDataHolder unsharedData = unshared.getResources().getFilePool().getFilePromise(fileId);
+        REQUIRE(firstData);
+        REQUIRE(secondData);
+        REQUIRE(unsharedData);
+        REQUIRE(firstData->head);
+        REQUIRE(firstData->head.get() == secondData->head.get());
+        REQUIRE(firstData->head.get() != unsharedData->head.get());
+        REQUIRE(approxEqual(
+            firstData->getData().getConstSpan(0),
+            unsharedData->getData().getConstSpan(0), 0.0f));
+    }
+
+    // the data stays valid for the remaining synth after the other one reloads
+    const std::shared_ptr<sfz::FileId> fileId = first.getRegionView(0)->sampleId;
+    sfz::FileDataHolder secondData = second.getResources().getFilePool().getFilePromise(fileId);
+    const size_t numFrames = secondData->getData().getNumFrames();
+    first.setSampleSharing(false);
+    first.loadSfzString(sfzPath, "<region> sample=kick.wav");
+    REQUIRE(secondData->getData().getNumFrames() == numFrames);
+}
+
+/**
+ * @brief Wait until the background loading of a file promise is done,
+ * or give up after a generous delay.
+ */
+static bool waitUntilLoaded(sfz::FilePool& filePool, sfz::FileDataHolder& data)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (data->status != sfz::FileData::Status::Done && std::chrono::steady_clock::now() < deadline) {
+        filePool.waitForBackgroundLoading();
+        std::this_thread::yield();
+    }
+    return data->status == sfz::FileData::Status::Done;
+}
+
+TEST_CASE("[Files] Memory budget evicts the least recently used files")
+{
+    sfz::Synth synth;
+    synth.setPreloadSize(1024);
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/budget.sfz", R"(
+        <region> sample=looped_flute.wav key=60
+        <region> sample=kick.wav key=61
+    )");
+    REQUIRE(synth.getNumRegions() == 2);
+    sfz::FilePool& filePool = synth.getResources().getFilePool();
+    const size_t preloadedBytes = filePool.getMemoryUsage();
+    REQUIRE(preloadedBytes > 0);
+
+    sfz::FileDataHolder first = filePool.getFilePromise(synth.getRegionView(0)->sampleId);
+    sfz::FileDataHolder second = filePool.getFilePromise(synth.getRegionView(1)->sampleId);
+    REQUIRE(waitUntilLoaded(filePool, first));
+    REQUIRE(waitUntilLoaded(filePool, second));
+    sfz::FileData& firstData = *first;
+    sfz::FileData& secondData = *second;
+    const size_t firstPreloadedFrames = firstData.getNumPreloadedFrames();
+    const size_t secondBytes = secondData.getNumFullDataBytes();
+
+    // files in use are never evicted
+    filePool.setMemoryBudget(1);
+    filePool.triggerGarbageCollection();
+    REQUIRE(filePool.getNumEvictions() == 0);
+    REQUIRE(filePool.getMemoryUsage() > preloadedBytes);
+
+    // release the second file strictly later, so that it is the most recently used
+    first.reset();
+    const auto firstReleaseTime = firstData.lastViewerLeftAt;
+    while (std::chrono::high_resolution_clock::now() <= firstReleaseTime)
+        std::this_thread::yield();
+    second.reset();
+    filePool.setMemoryBudget(preloadedBytes + secondBytes);
+    REQUIRE(filePool.isOverMemoryBudget());
+    filePool.triggerGarbageCollection();
+
+    REQUIRE(filePool.getNumEvictions() == 1);
+    REQUIRE(filePool.getEvictedBytes() > 0);
+    REQUIRE(firstData.status == sfz::FileData::Status::Preloaded);
+    REQUIRE(firstData.getNumPreloadedFrames() == firstPreloadedFrames);
+    REQUIRE(secondData.status == sfz::FileData::Status::Done);
+    REQUIRE(!filePool.isOverMemoryBudget());
+
+    // the preloaded data stays even if it does not fit
+    filePool.setMemoryBudget(1);
+    filePool.triggerGarbageCollection();
+    REQUIRE(filePool.getNumEvictions() == 2);
+    REQUIRE(filePool.getMemoryUsage() == preloadedBytes);
+    REQUIRE(firstData.getNumPreloadedFrames() == firstPreloadedFrames);
+}
+
+TEST_CASE("[Files] Memory usage counts the fully loaded short samples")
+{
+    sfz::Synth synth;
+    synth.setPreloadSize(1024);
+    // silence.wav is short enough to be loaded whole, then replaced by *silence
+    const fs::path sfzPath = fs::current_path() / "tests/TestFiles/budget_reload.sfz";
+    const std::string sfzText = R"(
+        <region> sample=silence.wav key=60
+        <region> sample=kick.wav key=61
+    )";
+    synth.loadSfzString(sfzPath, sfzText);
+    REQUIRE(synth.getNumRegions() == 2);
+    REQUIRE(synth.getRegionView(0)->sampleId->filename() == "*silence");
+    sfz::FilePool& filePool = synth.getResources().getFilePool();
+    const size_t firstUsage = filePool.getMemoryUsage();
+
+    // the short sample is unused after the reload, and its head is dropped
+    synth.loadSfzString(sfzPath, sfzText);
+    REQUIRE(synth.getNumRegions() == 2);
+    const size_t usage = filePool.getMemoryUsage();
+    REQUIRE(usage < firstUsage);
+
+    sfz::FileDataHolder kick = filePool.getFilePromise(synth.getRegionView(1)->sampleId);
+    REQUIRE(kick);
+    REQUIRE(usage == kick->head->getNumBytes());
+    REQUIRE(waitUntilLoaded(filePool, kick));
+    sfz::FileData& kickData = *kick;
+    const size_t fullBytes = kickData.getNumFullDataBytes();
+    kick.reset();
+
+    filePool.setMemoryBudget(usage + fullBytes);
+    REQUIRE(filePool.getMemoryUsage() == usage + fullBytes);
+    REQUIRE(!filePool.isOverMemoryBudget());
+    filePool.triggerGarbageCollection();
+    REQUIRE(filePool.getNumEvictions() == 0);
+    REQUIRE(kickData.status == sfz::FileData::Status::Done);
+}
+
+TEST_CASE("[Files] File information is read once per load")
+{
+    sfz::Synth synth;
+    const std::string sfzString = R"(
+        <region> sample=mono_sample.wav key=60
+        <region> sample=mono_sample.wav key=61 offset=100
+        <region> sample=mono_sample.wav key=62 transpose=1
+        <region> sample=stereo_sample.wav key=63
+    )";
+    sfz::FilePool& filePool = synth.getResources().getFilePool();
+
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/information.sfz", sfzString);
+    REQUIRE(synth.getNumRegions() == 4);
+    REQUIRE(filePool.getFileInformationMisses() == 2);
+    REQUIRE(filePool.getFileInformationHits() >= 2);
+
+    // a new load reads the files again
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/information.sfz", sfzString);
+    REQUIRE(filePool.getFileInformationMisses() == 4);
+}
+
+TEST_CASE("[Files] Directory listings are refreshed between loads")
+{
+    const fs::path directory = fs::temp_directory_path() / "sfizz-directory-cache-test";
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+    fs::create_directories(directory / "Samples");
+    fs::copy_file(fs::current_path() / "tests/TestFiles/kick.wav", directory / "Samples/Kick.wav");
+
+#if defined(_WIN32)
+    const bool caseSensitiveFs = false;
+#elif defined(__APPLE__)
+    const bool caseSensitiveFs = pathconf(directory.string().c_str(), _PC_CASE_SENSITIVE) != 0;
+#else
+    const bool caseSensitiveFs = true;
+#endif
+
+    if (caseSensitiveFs) {
+        const std::string sfzString = R"(
+            <region> key=60 sample=samples/KICK.wav
+            <region> key=61 sample=SAMPLES/kick.WAV
+            <region> key=62 sample=samples/snare.wav
+        )";
+
+        Synth synth;
+        synth.loadSfzString(directory / "directory.sfz", sfzString);
+        REQUIRE(synth.getNumRegions() == 2);
+        REQUIRE(synth.getRegionView(0)->sampleId->filename() == "Samples/Kick.wav");
+        REQUIRE(synth.getRegionView(1)->sampleId->filename() == "Samples/Kick.wav");
+
+        fs::copy_file(fs::current_path() / "tests/TestFiles/snare.wav", directory / "Samples/Snare.wav");
+        synth.loadSfzString(directory / "directory.sfz", sfzString);
+        REQUIRE(synth.getNumRegions() == 3);
+        REQUIRE(synth.getRegionView(2)->sampleId->filename() == "Samples/Snare.wav");
+    }
+
+    fs::remove_all(directory, ec);
+}
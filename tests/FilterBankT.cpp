@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/FilterBank.h"
+#include "sfizz/SfzFilter.h"
+#include "catch2/catch.hpp"
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace Catch::literals;
+
+namespace {
+
+constexpr float sampleRate { 48000.0f };
+constexpr unsigned numFrames { 1000 };
+
+std::vector<float> makeNoise(unsigned seed)
+{
+    std::minstd_rand prng { seed };
+    std::uniform_real_distribution<float> dist { -1.0f, 1.0f };
+    std::vector<float> noise(numFrames);
+    for (float& x : noise)
+        x = dist(prng);
+    return noise;
+}
+
+std::vector<float> makeSweep(float from, float to)
+{
+    std::vector<float> sweep(numFrames);
+    for (unsigned i = 0; i < numFrames; ++i)
+        sweep[i] = from * std::pow(to / from, float(i) / numFrames);
+    return sweep;
+}
+
+} // namespace
+
+TEST_CASE("[FilterBank] Matches the filters")
+{
+    const std::array<sfz::FilterType, 4> types {{
+        sfz::kFilterLpf2p, sfz::kFilterHpf2p, sfz::kFilterBpf2p, sfz::kFilterBrf2p,
+    }};
+    const std::vector<float> cutoff = makeSweep(100.0f, 8000.0f);
+    const std::vector<float> resonance(numFrames, 6.0f);
+    const std::vector<float> gain(numFrames, 0.0f);
+
+    sfz::FilterBank bank;
+    bank.setSampleRate(sampleRate);
+    bank.setSamplesPerBlock(numFrames);
+
+    for (bool tabulated : { false, true }) {
+        bank.setTabulated(tabulated);
+        for (sfz::FilterType type : types) {
+            for (unsigned numChannels : { 1u, 2u }) {
+                std::vector<float> expected[2] { makeNoise(1), makeNoise(2) };
+                std::vector<float> actual[2] { expected[0], expected[1] };
+
+                sfz::Filter filter;
+                filter.init(sampleRate);
+                filter.setType(type);
+                filter.setChannels(numChannels);
+                filter.prepare(cutoff[0], resonance[0], gain[0]);
+                sfz::FilterBankState state;
+
+                // process the blocks in two halves, to carry the state over
+                for (unsigned begin : { 0u, numFrames / 2 }) {
+                    const unsigned size = numFrames / 2;
+                    const float* inputs[2] { &expected[0][begin], &expected[1][begin] };
+                    float* outputs[2] { &expected[0][begin], &expected[1][begin] };
+                    filter.processModulated(inputs, outputs, &cutoff[begin], &resonance[begin], &gain[begin], size);
+
+                    float* channels[2] { &actual[0][begin], &actual[1][begin] };
+                    REQUIRE(bank.add(state, type, channels, numChannels,
+                        &cutoff[begin], &resonance[begin], size, begin == 0));
+                    bank.process();
+                }
+
+                for (unsigned c = 0; c < numChannels; ++c) {
+                    for (unsigned i = 0; i < numFrames; ++i)
+                        REQUIRE(actual[c][i] == Approx(expected[c][i]).margin(1e-3));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("[FilterBank] The tables match the exact coefficients")
+{
+    const std::array<sfz::FilterType, 4> types {{
+        sfz::kFilterLpf2p, sfz::kFilterHpf2p, sfz::kFilterBpf2p, sfz::kFilterBrf2p,
+    }};
+    constexpr unsigned size { 256 };
+
+    sfz::FilterBank exact;
+    exact.setTabulated(false);
+    sfz::FilterBank tabulated;
+    for (sfz::FilterBank* bank : { &exact, &tabulated }) {
+        bank->setSampleRate(sampleRate);
+        bank->setSamplesPerBlock(size);
+    }
+
+    for (sfz::FilterType type : types) {
+        for (float cutoff = 10.0f; cutoff < 20000.0f; cutoff *= 1.37f) {
+            for (float resonance : { -20.0f, -3.3f, 0.0f, 7.9f, 20.0f }) {
+                const std::vector<float> cutoffs(size, cutoff);
+                const std::vector<float> resonances(size, resonance);
+                std::vector<float> expected = makeNoise(3);
+                expected.resize(size);
+                std::vector<float> actual = expected;
+
+                sfz::FilterBankState exactState;
+                sfz::FilterBankState tabulatedState;
+                float* exactChannels[1] { expected.data() };
+                float* tabulatedChannels[1] { actual.data() };
+                REQUIRE(exact.add(exactState, type, exactChannels, 1, cutoffs.data(), resonances.data(), size, true));
+                REQUIRE(tabulated.add(tabulatedState, type, tabulatedChannels, 1, cutoffs.data(), resonances.data(), size, true));
+                exact.process();
+                tabulated.process();
+
+                for (unsigned i = 0; i < size; ++i)
+                    REQUIRE(actual[i] == Approx(expected[i]).margin(1e-3));
+            }
+        }
+    }
+}
+
+TEST_CASE("[FilterBank] The lanes are independent")
+{
+    const std::array<sfz::FilterType, 4> types {{
+        sfz::kFilterLpf2p, sfz::kFilterHpf2p, sfz::kFilterBpf2p, sfz::kFilterBrf2p,
+    }};
+    // 2 + 1 + 2 + 1 + 1 channels, so that a stereo filter spans 2 vectors
+    const std::array<unsigned, 5> channelCounts {{ 2, 1, 2, 1, 1 }};
+    const std::vector<float> cutoff = makeSweep(200.0f, 5000.0f);
+    const std::vector<float> resonance(numFrames, 3.0f);
+
+    sfz::FilterBank bank;
+    bank.setSampleRate(sampleRate);
+    bank.setSamplesPerBlock(numFrames);
+
+    std::array<sfz::FilterBankState, 5> soloStates;
+    std::array<sfz::FilterBankState, 5> bankStates;
+    std::vector<float> solo[5][2];
+    std::vector<float> together[5][2];
+    for (unsigned f = 0; f < 5; ++f) {
+        for (unsigned c = 0; c < 2; ++c) {
+            solo[f][c] = makeNoise(2 * f + c);
+            together[f][c] = solo[f][c];
+        }
+    }
+
+    // odd block sizes, which are not multiples of the vector size
+    for (unsigned begin = 0, size = 0; begin < numFrames; begin += size) {
+        size = std::min(numFrames - begin, 333u);
+
+        for (unsigned f = 0; f < 5; ++f) {
+            float* channels[2] { &solo[f][0][begin], &solo[f][1][begin] };
+            REQUIRE(bank.add(soloStates[f], types[f % 4], channels, channelCounts[f],
+                &cutoff[begin], &resonance[begin], size, begin == 0));
+            bank.process();
+        }
+
+        for (unsigned f = 0; f < 5; ++f) {
+            float* channels[2] { &together[f][0][begin], &together[f][1][begin] };
+            REQUIRE(bank.add(bankStates[f], types[f % 4], channels, channelCounts[f],
+                &cutoff[begin], &resonance[begin], size, begin == 0));
+        }
+        REQUIRE(bank.getNumLanes() == 7);
+        bank.process();
+        REQUIRE(bank.getNumLanes() == 0);
+    }
+
+    for (unsigned f = 0; f < 5; ++f) {
+        for (unsigned c = 0; c < channelCounts[f]; ++c)
+            REQUIRE(together[f][c] == solo[f][c]);
+    }
+}
+
+TEST_CASE("[FilterBank] Refuses filters beyond its lanes")
+{
+    sfz::FilterBank bank;
+    bank.setSamplesPerBlock(16);
+
+    std::vector<float> cutoff(16, 1000.0f);
+    std::vector<float> resonance(16, 0.0f);
+    std::vector<float> left(16, 0.0f);
+    std::vector<float> right(16, 0.0f);
+    float* channels[2] { left.data(), right.data() };
+
+    std::array<sfz::FilterBankState, sfz::FilterBank::maxLanes / 2 + 1> states;
+    for (unsigned f = 0; f < sfz::FilterBank::maxLanes / 2; ++f)
+        REQUIRE(bank.add(states[f], sfz::kFilterLpf2p, channels, 2, cutoff.data(), resonance.data(), 16, true));
+    REQUIRE(!bank.add(states.back(), sfz::kFilterLpf2p, channels, 1, cutoff.data(), resonance.data(), 16, true));
+    bank.clear();
+    REQUIRE(bank.getNumLanes() == 0);
+}
@@ -5,8 +5,10 @@
 // If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
 
 #include "sfizz/Interpolators.h"
+#include "sfizz/SincResampler.h"
 #include "catch2/catch.hpp"
 #include <array>
+#include <cmath>
 #include <numeric>
 using namespace Catch::literals;
 
@@ -127,3 +129,99 @@ TEST_CASE("[Interpolators] Windowed sinc precision")
     Check(windowedSincError(*sfz::SincInterpolatorTraits<60>::windowedSinc));
     Check(windowedSincError(*sfz::SincInterpolatorTraits<72>::windowedSinc));
 }
+
+template <sfz::InterpolatorModel M>
+static void checkInt16Interpolation()
+{
+    std::array<int16_t, 128> samples;
+    std::array<float, 128> values;
+    for (unsigned i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<int16_t>(32767 * std::sin(0.3 * i) * std::cos(0.07 * i));
+        values[i] = samples[i] * (1.0f / 32768);
+    }
+
+    for (unsigned i = 40; i < samples.size() - 40; ++i) {
+        for (float coeff : { 0.0f, 0.25f, 0.5f, 0.9f }) {
+            REQUIRE(sfz::interpolate<M>(&samples[i], coeff)
+                == Approx(sfz::interpolate<M>(&values[i], coeff)).margin(1e-5));
+        }
+    }
+}
+
+TEST_CASE("[Interpolators] 16-bit samples")
+{
+    sfz::initializeInterpolators();
+
+    checkInt16Interpolation<sfz::kInterpolatorNearest>();
+    checkInt16Interpolation<sfz::kInterpolatorLinear>();
+    checkInt16Interpolation<sfz::kInterpolatorHermite3>();
+    checkInt16Interpolation<sfz::kInterpolatorBspline3>();
+    checkInt16Interpolation<sfz::kInterpolatorSinc8>();
+    checkInt16Interpolation<sfz::kInterpolatorSinc12>();
+    checkInt16Interpolation<sfz::kInterpolatorSinc72>();
+}
+
+template <class T>
+static float exactSinc(unsigned points, const T* values, float coeff, float scale)
+{
+    const double beta = sfz::SincInterpolatorDetail::getBetaForNumPoints(points);
+    const int j0 = 1 - int(points) / 2;
+    double y = 0.0;
+    for (int i = 0; i < int(points); ++i)
+        y += sfz::WindowedSincDetail::calculateExact(j0 + i - coeff, points, beta) * values[j0 + i];
+    return static_cast<float>(y * scale);
+}
+
+template <class T>
+static void checkSincResampler(const std::array<T, 256>& left, const std::array<T, 256>& right, float scale)
+{
+    constexpr unsigned numFrames = 77;
+    std::array<int, numFrames> indices;
+    std::array<float, numFrames> coeffs;
+    std::array<float, numFrames> gains;
+    for (unsigned i = 0; i < numFrames; ++i) {
+        double pos = 40.0 + i * 1.73;
+        indices[i] = static_cast<int>(pos);
+        coeffs[i] = static_cast<float>(pos - indices[i]);
+        gains[i] = 0.5f + 0.01f * i;
+    }
+
+    for (unsigned points : { 8, 12, 16, 24, 36, 48, 60, 72 }) {
+        std::array<float, numFrames> outLeft;
+        std::array<float, numFrames> outRight;
+        sfz::sincResample(
+            points, left.data(), right.data(), indices.data(), coeffs.data(), nullptr,
+            outLeft.data(), outRight.data(), numFrames);
+        for (unsigned i = 0; i < numFrames; ++i) {
+            REQUIRE(outLeft[i] == Approx(exactSinc(points, &left[indices[i]], coeffs[i], scale)).margin(1e-5));
+            REQUIRE(outRight[i] == Approx(exactSinc(points, &right[indices[i]], coeffs[i], scale)).margin(1e-5));
+        }
+
+        std::array<float, numFrames> mono;
+        mono.fill(1.0f);
+        sfz::sincResample(
+            points, left.data(), nullptr, indices.data(), coeffs.data(), gains.data(),
+            mono.data(), nullptr, numFrames);
+        for (unsigned i = 0; i < numFrames; ++i)
+            REQUIRE(mono[i] == Approx(1.0f + gains[i] * outLeft[i]).margin(1e-5));
+    }
+}
+
+TEST_CASE("[Interpolators] Polyphase sinc resampler")
+{
+    sfz::initializeInterpolators();
+
+    std::array<float, 256> left;
+    std::array<float, 256> right;
+    std::array<int16_t, 256> left16;
+    std::array<int16_t, 256> right16;
+    for (unsigned i = 0; i < left.size(); ++i) {
+        left[i] = static_cast<float>(std::sin(0.3 * i) * std::cos(0.07 * i));
+        right[i] = static_cast<float>(std::cos(0.11 * i));
+        left16[i] = static_cast<int16_t>(32767 * left[i]);
+        right16[i] = static_cast<int16_t>(32767 * right[i]);
+    }
+
+    checkSincResampler(left, right, 1.0f);
+    checkSincResampler(left16, right16, 1.0f / 32768);
+}
@@ -10,7 +10,7 @@
 #include "sfizz/Region.h"
 #include "catch2/catch.hpp"
 
-static bool computeLFO(DataPoints& dp, const fs::path& sfzPath, double sampleRate, size_t numFrames)
+static bool computeLFO(DataPoints& dp, const fs::path& sfzPath, double sampleRate, size_t numFrames, unsigned step = 1)
 {
     sfz::Synth synth;
     sfz::Resources& resources = synth.getResources();
@@ -45,7 +45,10 @@ static bool computeLFO(DataPoints& dp, const fs::path& sfzPath, double sampleRat
         lfoOutputs[l] = absl::MakeSpan(&outputMemory[l * numFrames], numFrames);
         for (size_t i = 0, currentFrames; i < numFrames; i += currentFrames) {
             currentFrames = std::min(numFrames - i, bufferSize);
-            lfos[l]->process(lfoOutputs[l].subspan(i, currentFrames));
+            if (step > 1)
+                lfos[l]->processDecimated(lfoOutputs[l].subspan(i, currentFrames), step, 0);
+            else
+                lfos[l]->process(lfoOutputs[l].subspan(i, currentFrames), 0);
         }
     }
 
@@ -124,3 +127,26 @@ TEST_CASE("[LFO] Fade and delay")
         REQUIRE(mse < mseThreshold);
     }
 }
+
+TEST_CASE("[LFO] Decimated processing")
+{
+    constexpr unsigned step = 16;
+    constexpr size_t numFrames = 100 * step;
+
+    DataPoints ref;
+    REQUIRE(computeLFO(ref, "tests/lfo/lfo_waves.sfz", 100.0, numFrames));
+
+    DataPoints cur;
+    REQUIRE(computeLFO(cur, "tests/lfo/lfo_waves.sfz", 100.0, numFrames, step));
+
+    REQUIRE(ref.rows == cur.rows);
+    REQUIRE(ref.cols == cur.cols);
+
+    for (size_t l = 1; l < cur.cols; ++l) {
+        // the values match at the control points, and are held in between
+        double mse = meanSquareError(&ref.data[l], &cur.data[l], ref.rows / step, step * ref.cols);
+        REQUIRE(mse < mseThreshold);
+        for (size_t i = 0; i < cur.rows; ++i)
+            REQUIRE(cur(i, l) == cur(i - i % step, l));
+    }
+}
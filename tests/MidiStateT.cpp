@@ -16,6 +16,7 @@
 #include "catch2/catch.hpp"
 #include "absl/strings/string_view.h"
 #include "TestHelpers.h"
+#include <algorithm>
 using namespace Catch::literals;
 using namespace sfz::literals;
 
@@ -108,6 +109,37 @@ TEST_CASE("[MidiState] Flushing state")
     REQUIRE(state.getPitchBend() == 0.7f);
 }
 
+TEST_CASE("[MidiState] Full event lists coalesce events")
+{
+    sfz::MidiState state;
+    state.setSamplesPerBlock(16);
+    const size_t capacity = state.getCCEvents(12).capacity();
+    const int numEvents = static_cast<int>(capacity) + 20;
+    const unsigned numCoalesced = static_cast<unsigned>(numEvents - (capacity - 1));
+    for (int i = 1; i <= numEvents; ++i)
+        state.ccEvent(i, 12, static_cast<float>(i) / numEvents);
+
+    const sfz::EventVector& events = state.getCCEvents(12);
+    REQUIRE( events.size() == capacity );
+    REQUIRE( events.capacity() == capacity );
+    REQUIRE( events.front().delay == 0 );
+    REQUIRE( std::is_sorted(events.begin(), events.end(), sfz::MidiEventDelayComparator {}) );
+    REQUIRE( events.back().delay == numEvents );
+    REQUIRE( state.getCCValue(12) == 1.0f );
+    REQUIRE( state.getNumCoalescedEvents() == numCoalesced );
+
+    // Out of order events are coalesced too
+    state.ccEvent(numEvents - 1, 12, 0.5f);
+    REQUIRE( events.size() == capacity );
+    REQUIRE( std::is_sorted(events.begin(), events.end(), sfz::MidiEventDelayComparator {}) );
+    REQUIRE( state.getCCValue(12) == 1.0f );
+    REQUIRE( state.getNumCoalescedEvents() == numCoalesced + 1 );
+
+    state.flushEvents();
+    REQUIRE( state.getCCEvents(12).size() == 1 );
+    REQUIRE( state.getCCValue(12) == 1.0f );
+}
+
 TEST_CASE("[MidiState] Set and get note velocities")
 {
     sfz::MidiState state;
@@ -87,6 +87,40 @@ TEST_CASE("[Polyphony] group polyphony limits")
     REQUIRE( numPlayingVoices(synth) == 2 ); // One is releasing
 }
 
+TEST_CASE("[Polyphony] The first stealer takes the oldest voice after voices ended out of order")
+{
+    sfz::Synth synth;
+    sfz::AudioBuffer<float> buffer { 2, static_cast<unsigned>(synth.getSamplesPerBlock()) };
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/polyphony.sfz", R"(
+        <control> hint_stealing=first
+        <group> group=1 polyphony=3
+        <region> sample=*sine lokey=60 hikey=64
+    )");
+    for (int note = 60; note < 63; ++note) {
+        synth.noteOn(0, note, 64);
+        synth.renderBlock(buffer);
+    }
+    // the first voice ends while the later ones play on
+    synth.noteOff(0, 60, 0);
+    for (unsigned i = 0; i < 10; ++i)
+        synth.renderBlock(buffer);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+
+    synth.noteOn(0, 63, 64);
+    synth.renderBlock(buffer);
+    REQUIRE( numPlayingVoices(synth) == 3 );
+    // the first voice in the list is the one of note 61, which started first
+    synth.noteOn(0, 64, 64);
+    synth.renderBlock(buffer);
+    REQUIRE( numPlayingVoices(synth) == 3 );
+
+    std::vector<int> playingNotes;
+    for (const sfz::Voice* voice : getPlayingVoices(synth))
+        playingNotes.push_back(voice->getTriggerEvent().number);
+    absl::c_sort(playingNotes);
+    REQUIRE( playingNotes == std::vector<int> { 62, 63, 64 } );
+}
+
 TEST_CASE("[Polyphony] Hierarchy polyphony limits")
 {
     sfz::Synth synth;
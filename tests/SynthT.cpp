@@ -9,10 +9,12 @@
 #include "sfizz/Layer.h"
 #include "sfizz/SisterVoiceRing.h"
 #include "sfizz/SfzHelpers.h"
+#include "sfizz/SynthConfig.h"
 #include "sfizz/utility/NumericId.h"
 #include "BitArray.h"
 #include "TestHelpers.h"
 #include "catch2/catch.hpp"
+#include "absl/algorithm/container.h"
 #include <algorithm>
 using namespace Catch::literals;
 using namespace sfz::literals;
@@ -783,6 +785,70 @@ TEST_CASE("[Synth] Release (Different sustain CC)")
     REQUIRE( synth.getNumActiveVoices() == 2 );
 }
 
+TEST_CASE("[Synth] Free voices are reused from the lowest index")
+{
+    sfz::Synth synth;
+    sfz::AudioBuffer<float> buffer { 2, static_cast<unsigned>(synth.getSamplesPerBlock()) };
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/free_voices.sfz", R"(
+        <region> lokey=60 hikey=62 sample=*sine
+        <region> key=63 sample=*sine end=0
+    )");
+    synth.noteOn(0, 60, 85);
+    synth.noteOn(0, 61, 85);
+    synth.noteOn(0, 62, 85);
+    synth.renderBlock(buffer);
+    REQUIRE( synth.getNumActiveVoices() == 3 );
+
+    synth.noteOff(0, 61, 85);
+    for (unsigned i = 0; i < 10; ++i)
+        synth.renderBlock(buffer);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    REQUIRE( synth.getVoiceView(1)->isFree() );
+
+    // a voice which does not start is freed right away
+    synth.noteOn(0, 63, 85);
+    REQUIRE( synth.getVoiceView(1)->isFree() );
+
+    synth.noteOn(0, 61, 85);
+    REQUIRE( synth.getNumActiveVoices() == 3 );
+    REQUIRE( synth.getVoiceView(1)->getTriggerEvent().number == 61 );
+
+    synth.allSoundOff();
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    synth.noteOn(0, 62, 85);
+    REQUIRE( synth.getVoiceView(0)->getTriggerEvent().number == 62 );
+}
+
+TEST_CASE("[Synth] Release (sustain CCs differing between regions)")
+{
+    sfz::Synth synth;
+    sfz::AudioBuffer<float> buffer { 2, static_cast<unsigned>(synth.getSamplesPerBlock()) };
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/release.sfz", R"(
+        <region> key=60 sample=*sine sustain_cc=54
+        <region> key=61 sample=*saw
+        <region> key=62 sample=*triangle
+    )");
+    synth.noteOn(0, 60, 85);
+    synth.noteOn(0, 61, 85);
+    synth.noteOn(0, 62, 85);
+    synth.cc(0, 54, 127);
+    synth.cc(0, 64, 127);
+    synth.noteOff(0, 60, 85);
+    synth.noteOff(0, 61, 85);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*sine", "*saw", "*triangle" } );
+    synth.cc(0, 11, 0);
+    synth.cc(0, 64, 0);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*sine", "*triangle" } );
+    synth.cc(0, 54, 0);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*triangle" } );
+    synth.noteOff(0, 62, 85);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth).empty() );
+}
+
 TEST_CASE("[Synth] Release (don't check sustain)")
 {
     sfz::Synth synth;
@@ -2140,3 +2206,241 @@ TEST_CASE("[Synth] Reloading a file ignores the `set_ccN` opcodes")
 
     REQUIRE(messageList == expected);
 }
+
+TEST_CASE("[Synth] Parallel rendering matches serial rendering")
+{
+    const std::string sfzString = R"(
+        <region> sample=*sine lokey=40 hikey=80 pitch_keycenter=60
+            lfo1_freq=3 lfo1_pitch=50 lfo1_volume_oncc1=6
+            cutoff=2000 fil_type=lpf_2p lfo1_cutoff=600
+            pan_oncc10=100 amplitude_smoothcc7=10 amplitude_oncc7=100
+        <region> sample=*saw lokey=40 hikey=80 ampeg_release=0.1
+            eg1_time1=0.1 eg1_level1=1 eg1_time2=0.2 eg1_level2=0 eg1_pitch=200
+    )";
+
+    sfz::Synth serial;
+    sfz::Synth parallel;
+    parallel.setNumRenderThreads(4);
+    REQUIRE(parallel.getNumRenderThreads() == 4);
+
+    for (sfz::Synth* synth : { &serial, &parallel })
+        synth->loadSfzString(fs::current_path() / "tests/TestFiles/parallel.sfz", sfzString);
+
+    sfz::AudioBuffer<float> serialBuffer { 2, static_cast<unsigned>(serial.getSamplesPerBlock()) };
+    sfz::AudioBuffer<float> parallelBuffer { 2, static_cast<unsigned>(parallel.getSamplesPerBlock()) };
+
+    for (int block = 0; block < 100; ++block) {
+        for (sfz::Synth* synth : { &serial, &parallel }) {
+            if (block % 10 == 0) {
+                synth->hdcc(0, 1, block / 100.0f);
+                synth->hdcc(0, 7, 1.0f - block / 100.0f);
+                synth->noteOn(0, 40 + block / 4, 100);
+                synth->noteOn(0, 60 + block / 4, 80);
+            }
+            if (block % 10 == 5)
+                synth->noteOff(0, 40 + (block - 5) / 4, 0);
+        }
+
+        serial.renderBlock(serialBuffer);
+        parallel.renderBlock(parallelBuffer);
+        REQUIRE(serial.getNumActiveVoices() == parallel.getNumActiveVoices());
+        for (unsigned c = 0; c < 2; ++c) {
+            REQUIRE(absl::c_equal(serialBuffer.getConstSpan(c), parallelBuffer.getConstSpan(c)));
+        }
+    }
+
+    parallel.setNumRenderThreads(1);
+    REQUIRE(parallel.getNumRenderThreads() == 1);
+}
+
+/**
+ * @brief Render the same note with and without the constant ratio fast path
+ * of the voices, and check that both outputs match block by block.
+ */
+static void checkConstantRatioFastPath(const std::string& sfzString, int noteDelay, int numBlocks)
+{
+    sfz::Synth fast;
+    sfz::Synth general;
+    general.getResources().getSynthConfig().constantRatioFastPath = false;
+
+    for (sfz::Synth* synth : { &fast, &general }) {
+        synth->setSampleRate(44100);
+        synth->setSamplesPerBlock(256);
+        synth->loadSfzString(fs::current_path() / "tests/TestFiles/constant_ratio.sfz", sfzString);
+        synth->noteOn(noteDelay, 60, 100);
+    }
+
+    sfz::AudioBuffer<float> fastBuffer { 2, 256 };
+    sfz::AudioBuffer<float> generalBuffer { 2, 256 };
+
+    for (int block = 0; block < numBlocks; ++block) {
+        fast.renderBlock(fastBuffer);
+        general.renderBlock(generalBuffer);
+        REQUIRE(fast.getNumActiveVoices() == 1);
+        REQUIRE(general.getNumActiveVoices() == 1);
+        for (unsigned c = 0; c < 2; ++c) {
+            // the general path accumulates its positions in single precision,
+            // so it drifts slightly from the fast path over the blocks
+            const auto fastSpan = fastBuffer.getConstSpan(c);
+            const auto generalSpan = generalBuffer.getConstSpan(c);
+            for (size_t i = 0; i < fastSpan.size(); ++i)
+                REQUIRE(fastSpan[i] == Approx(generalSpan[i]).margin(2e-3));
+        }
+    }
+}
+
+TEST_CASE("[Synth] Constant ratio fast path matches the general path")
+{
+    SECTION("Ratio 1 from an integral position")
+    {
+        checkConstantRatioFastPath(R"(
+            <region> sample=looped_flute.wav key=60 pitch_keycenter=60
+        )", 0, 12);
+    }
+
+    SECTION("Fractional ratio across several blocks")
+    {
+        checkConstantRatioFastPath(R"(
+            <region> sample=looped_flute.wav key=60 pitch_keycenter=58
+        )", 0, 12);
+    }
+
+    SECTION("First block of a voice with a trigger delay")
+    {
+        checkConstantRatioFastPath(R"(
+            <region> sample=looped_flute.wav key=60 pitch_keycenter=58
+        )", 100, 4);
+    }
+
+    SECTION("Block ending just before the loop crossfade")
+    {
+        // The crossfade is 44 frames long, so it starts at frame 768;
+        // the third block plays frames 512 to 767 and stays on the fast path
+        checkConstantRatioFastPath(R"(
+            <region> sample=looped_flute.wav key=60 pitch_keycenter=60
+                loop_mode=loop_continuous loop_start=100 loop_end=811
+                loop_crossfade=0.001
+        )", 0, 12);
+    }
+
+    SECTION("Loop crossfades with a fractional ratio")
+    {
+        checkConstantRatioFastPath(R"(
+            <region> sample=looped_flute.wav key=60 pitch_keycenter=58
+                loop_mode=loop_continuous loop_start=1000 loop_end=2000
+                loop_crossfade=0.01
+        )", 0, 12);
+    }
+}
+
+TEST_CASE("[Synth] Velocity layers and round robins on note on")
+{
+    sfz::Synth synth;
+    sfz::AudioBuffer<float> buffer { 2, static_cast<unsigned>(synth.getSamplesPerBlock()) };
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/velocity_layers.sfz", R"(
+        <region> key=60 hivel=63 seq_length=2 seq_position=1 sample=*sine
+        <region> key=60 hivel=63 seq_length=2 seq_position=2 sample=*saw
+        <region> key=60 lovel=64 sample=*triangle
+        <region> key=60 lovel=64 sample=*square trigger=release
+        <region> key=60 sw_vel=previous lovel=100 sample=*noise
+    )");
+    // The round robins advance even on notes outside of their velocity range
+    synth.noteOn(0, 60, 100);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*triangle" } );
+    synth.allSoundOff();
+    synth.noteOn(0, 60, 30);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*saw", "*noise" } );
+    synth.allSoundOff();
+    synth.noteOn(0, 60, 127);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*triangle" } );
+    synth.allSoundOff();
+    synth.noteOn(0, 60, 1);
+    synth.renderBlock(buffer);
+    REQUIRE( playingSamples(synth) == std::vector<std::string> { "*saw", "*noise" } );
+}
+
+TEST_CASE("[Synth] Batched events")
+{
+    sfz::Synth synth;
+    sfz::AudioBuffer<float> buffer { 2, static_cast<unsigned>(synth.getSamplesPerBlock()) };
+    synth.loadSfzString(fs::current_path() / "tests/TestFiles/batched_events.sfz", R"(
+        <region> key=60 sample=*sine
+        <region> key=62 sample=*saw
+        <region> hikey=-1 on_locc44=64 on_hicc44=127 sample=*triangle
+    )");
+
+    SECTION("Events are dispatched in order")
+    {
+        const sfz::Synth::Event events[] {
+            { 0, sfz::Synth::EventNoteOn, 60, 0.5f },
+            { 0, sfz::Synth::EventCC, 7, 0.25f },
+            { 10, sfz::Synth::EventPitchWheel, 0, 0.5f },
+            { 20, sfz::Synth::EventNoteOn, 62, 0.5f },
+            { 30, sfz::Synth::EventNoteOff, 60, 0.5f },
+        };
+        synth.sendEvents(events, 5);
+        synth.renderBlock(buffer);
+        REQUIRE( playingSamples(synth) == std::vector<std::string> { "*saw" } );
+        REQUIRE( synth.getHdcc(7) == 0.25f );
+        REQUIRE( synth.getHdcc(sfz::ExtendedCCs::pitchBend) == 0.5f );
+    }
+
+    SECTION("Superseded events are skipped")
+    {
+        const sfz::Synth::Event events[] {
+            { 0, sfz::Synth::EventCC, 7, 1.0f },
+            { 0, sfz::Synth::EventCC, 7, 0.25f },
+            { 0, sfz::Synth::EventPitchWheel, 0, 1.0f },
+            { 0, sfz::Synth::EventPitchWheel, 0, -0.5f },
+        };
+        synth.sendEvents(events, 4);
+        synth.renderBlock(buffer);
+        REQUIRE( playingSamples(synth).empty() );
+        REQUIRE( synth.getHdcc(7) == 0.25f );
+        REQUIRE( synth.getHdcc(sfz::ExtendedCCs::pitchBend) == -0.5f );
+    }
+
+    SECTION("Events of triggering CCs are all dispatched")
+    {
+        const sfz::Synth::Event events[] {
+            { 0, sfz::Synth::EventCC, 44, 1.0f },
+            { 0, sfz::Synth::EventCC, 44, 0.0f },
+        };
+        synth.sendEvents(events, 2);
+        synth.renderBlock(buffer);
+        REQUIRE( playingSamples(synth) == std::vector<std::string> { "*triangle" } );
+        REQUIRE( synth.getHdcc(44) == 0.0f );
+    }
+
+    SECTION("Events of pedal CCs are all dispatched")
+    {
+        const sfz::Synth::Event events[] {
+            { 0, sfz::Synth::EventNoteOn, 60, 0.5f },
+            { 1, sfz::Synth::EventCC, 64, 1.0f },
+            { 2, sfz::Synth::EventNoteOff, 60, 0.5f },
+            { 3, sfz::Synth::EventCC, 64, 0.0f },
+            { 3, sfz::Synth::EventCC, 64, 1.0f },
+        };
+        synth.sendEvents(events, 5);
+        synth.renderBlock(buffer);
+        // the pedal was lifted, which released the note
+        REQUIRE( playingSamples(synth).empty() );
+        REQUIRE( synth.getHdcc(64) == 1.0f );
+    }
+
+    SECTION("A note event keeps the events before it")
+    {
+        const sfz::Synth::Event events[] {
+            { 0, sfz::Synth::EventCC, 44, 1.0f },
+            { 0, sfz::Synth::EventNoteOn, 62, 0.5f },
+            { 0, sfz::Synth::EventCC, 44, 0.0f },
+        };
+        synth.sendEvents(events, 3);
+        synth.renderBlock(buffer);
+        REQUIRE( playingSamples(synth) == std::vector<std::string> { "*triangle", "*saw" } );
+        REQUIRE( synth.getHdcc(44) == 0.0f );
+    }
+}